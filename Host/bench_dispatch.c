@@ -0,0 +1,151 @@
+/**
+ * @file bench_dispatch.c
+ * @brief Host benchmark of command lookup: linear scan versus sorted index.
+ *
+ * Registers a synthetic table of 128 two-word commands next to the ones
+ * command_processor.c defines itself, then times find_command() (binary
+ * search over the sorted index) against a linear scan of the
+ * "command_table" section that uses the same word-exact comparison, for
+ * hits spread evenly over the table and for unknown commands.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <time.h>
+#include "test.h"
+#include "../Src/command_processor.c"
+
+#define BENCH_ROUNDS 200000 /**< Lookups per table entry and method */
+
+uint32_t timebase_us(void) {
+    return 0;
+}
+
+int rpc_result(const void *data, int length) {
+    return 0;
+}
+
+void macro_record_command(int id, int argc, char *argv[], const ArgValue *args) {
+}
+
+void USART2_WriteAll(const uint8_t *data, int length) {
+}
+
+static void bench_handler(int argc, char *argv[], const ArgValue *args) {
+}
+
+// 16 groups of 8 verbs: 128 names in registration (unsorted) order
+#define BENCH_VERBS(group)                                                        \
+    BENCH_COMMAND(group, SET) BENCH_COMMAND(group, GET) BENCH_COMMAND(group, ON)  \
+    BENCH_COMMAND(group, OFF) BENCH_COMMAND(group, READ) BENCH_COMMAND(group, WRITE) \
+    BENCH_COMMAND(group, SHOW) BENCH_COMMAND(group, CLEAR)
+#define BENCH_COMMAND(group, verb) REGISTER_COMMAND(bench_##group##_##verb, #group " " #verb, bench_handler);
+BENCH_VERBS(WDG) BENCH_VERBS(ADC) BENCH_VERBS(UART) BENCH_VERBS(DMA)
+BENCH_VERBS(SPI) BENCH_VERBS(CAN) BENCH_VERBS(TSC) BENCH_VERBS(CEC)
+BENCH_VERBS(PWM) BENCH_VERBS(DAC) BENCH_VERBS(CRC) BENCH_VERBS(LCD)
+BENCH_VERBS(FAN) BENCH_VERBS(IMU) BENCH_VERBS(GPS) BENCH_VERBS(BUS)
+
+/**
+ * @brief Looks up a command by scanning the section in registration order.
+ *
+ * @param argc Number of tokens.
+ * @param argv The tokens.
+ * @param words Set to the number of tokens consumed by the command name.
+ * @param compares Incremented once per name compared.
+ * @return const Command* Matching entry, or NULL if there is none.
+ */
+static const Command *find_command_linear(int argc, char *argv[], int *words, unsigned long *compares) {
+    for (const Command *command = __start_command_table; command < __stop_command_table; command++) {
+        (*compares)++;
+        if (compare_command(argc, argv, command, words) == 0) {
+            return command;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns a monotonic time stamp.
+ *
+ * @return double Seconds.
+ */
+static double bench_seconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(void) {
+    static char names[MAX_COMMANDS][32];
+    static char *lines[MAX_COMMANDS][MAX_ARGS];
+    static int line_argc[MAX_COMMANDS];
+    char miss_tokens[2][8] = {"ZZZ", "NOPE"};
+    char *miss[2] = {miss_tokens[0], miss_tokens[1]};
+    unsigned long compares = 0, hit_compares, found = 0;
+    int count, words;
+    double start, binary_s, linear_s, binary_miss_s, linear_miss_s;
+
+    command_processor_init();
+    count = command_count;
+    CHECK(count >= 128);
+
+    // One tokenized line per command, with a trailing argument
+    for (int i = 0; i < count; i++) {
+        snprintf(names[i], sizeof(names[i]), "%s 1", command_index[i]->command);
+        line_argc[i] = tokenize(names[i], lines[i], MAX_ARGS);
+    }
+
+    // Both lookups must agree on every entry before they are timed
+    for (int i = 0; i < count; i++) {
+        int binary_words = 0, linear_words = 0;
+        int binary = find_command(line_argc[i], lines[i], &binary_words);
+        const Command *linear = find_command_linear(line_argc[i], lines[i], &linear_words, &compares);
+
+        CHECK_EQ(binary, i);
+        CHECK(linear == command_index[i]);
+        CHECK_EQ(binary_words, linear_words);
+    }
+    CHECK_EQ(find_command(2, miss, &words), -1);
+
+    start = bench_seconds();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int i = 0; i < count; i++) {
+            found += find_command(line_argc[i], lines[i], &words) >= 0;
+        }
+    }
+    binary_s = bench_seconds() - start;
+
+    compares = 0;
+    start = bench_seconds();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int i = 0; i < count; i++) {
+            found += find_command_linear(line_argc[i], lines[i], &words, &compares) != NULL;
+        }
+    }
+    linear_s = bench_seconds() - start;
+    hit_compares = compares / ((unsigned long)BENCH_ROUNDS * count);
+
+    start = bench_seconds();
+    for (int round = 0; round < BENCH_ROUNDS * 16; round++) {
+        found += find_command(2, miss, &words) >= 0;
+    }
+    binary_miss_s = bench_seconds() - start;
+
+    start = bench_seconds();
+    for (int round = 0; round < BENCH_ROUNDS * 16; round++) {
+        found += find_command_linear(2, miss, &words, &compares) != NULL;
+    }
+    linear_miss_s = bench_seconds() - start;
+
+    CHECK_EQ(found, 2UL * BENCH_ROUNDS * count);
+
+    printf("%d commands\n", count);
+    printf("hit:  binary %6.1f ns/lookup, linear %6.1f ns/lookup (%lu names compared on average)\n",
+           binary_s * 1e9 / ((double)BENCH_ROUNDS * count), linear_s * 1e9 / ((double)BENCH_ROUNDS * count),
+           hit_compares);
+    printf("miss: binary %6.1f ns/lookup, linear %6.1f ns/lookup\n",
+           binary_miss_s * 1e9 / (BENCH_ROUNDS * 16.0), linear_miss_s * 1e9 / (BENCH_ROUNDS * 16.0));
+    return test_report("bench_dispatch");
+}
@@ -0,0 +1,128 @@
+/**
+ * @file bench_parser.c
+ * @brief Host throughput benchmark of the command line parser.
+ *
+ * Reports lines per second for a set of typical lines, first through
+ * process_command() alone (tokenize, lookup, argument conversion and
+ * dispatch) and then through the line editor as typed keystrokes.
+ * Handlers do nothing, so the figures are the parser's own cost.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <string.h>
+#include <time.h>
+#include "test.h"
+#include "command_processor.h"
+#include "line_editor.h"
+#include "flash.h"
+#include "timeout.h"
+
+#define BENCH_LINES 1000000 /**< Lines parsed per measurement */
+
+uint32_t timebase_us(void) {
+    return 0;
+}
+
+void timeout_start(Timeout *timeout, uint32_t delay_ms, TimeoutCallback callback) {
+}
+
+void timeout_cancel(Timeout *timeout) {
+}
+
+int USART2_Write(const uint8_t *data, int length) {
+    return length;
+}
+
+void USART2_WriteAll(const uint8_t *data, int length) {
+}
+
+void USART2_SetOutputHook(int (*hook)(int ch)) {
+}
+
+int flash_erase_page(uint32_t address) {
+    return 0;
+}
+
+int flash_program(uint32_t address, const void *data, uint32_t length) {
+    return 0;
+}
+
+static unsigned long handled = 0;
+
+static void bench_handler(int argc, char *argv[], const ArgValue *args) {
+    handled++;
+}
+
+static const char *const bench_modes[] = {"OFF", "ON", "BLINK", NULL};
+static const ArgSpec bench_set_args[] = {
+    ARG_INT("n", -5, 500),
+    ARG_FIXED("f", 3, -100000, 100000),
+    ARG_ENUM("mode", bench_modes),
+    ARG_HEX("h"),
+    ARG_WORD("w", 8),
+};
+static const ArgSpec bench_rate_args[] = {
+    ARG_INT("rate", 1, 1000000),
+};
+REGISTER_COMMAND(bench_on, "BENCH ON", bench_handler);
+REGISTER_COMMAND_ARGS(bench_rate, "BENCH RATE", bench_handler, bench_rate_args, 1);
+REGISTER_COMMAND_ARGS(bench_set, "BENCH SET", bench_handler, bench_set_args, 2);
+
+// Typical console lines: no arguments, one integer, every argument type
+static const char *const bench_lines[] = {
+    "BENCH ON",
+    "bench rate 19200",
+    "BENCH SET 42 -1.5 ON 0xBEEF abc",
+};
+
+/**
+ * @brief Returns a monotonic time stamp.
+ *
+ * @return double Seconds.
+ */
+static double bench_seconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(void) {
+    char line[LINE_EDITOR_LENGTH];
+    int count = sizeof(bench_lines) / sizeof(bench_lines[0]);
+
+    command_processor_init();
+
+    for (int i = 0; i < count; i++) {
+        double start, parse_s, typed_s;
+        unsigned long before = handled;
+
+        start = bench_seconds();
+        for (int n = 0; n < BENCH_LINES; n++) {
+            strcpy(line, bench_lines[i]);
+            process_command(line);
+        }
+        parse_s = bench_seconds() - start;
+
+        start = bench_seconds();
+        for (int n = 0; n < BENCH_LINES; n++) {
+            char *entered;
+
+            for (const char *key = bench_lines[i]; *key != '\0'; key++) {
+                line_editor_feed((uint8_t)*key);
+            }
+            entered = line_editor_feed('\r');
+            if (entered != NULL) {
+                process_command(entered);
+            }
+        }
+        typed_s = bench_seconds() - start;
+
+        CHECK_EQ(handled - before, 2UL * BENCH_LINES);
+        printf("%-34s %6.2f M lines/s parsed, %6.2f M lines/s typed\n", bench_lines[i],
+               BENCH_LINES / parse_s / 1e6, BENCH_LINES / typed_s / 1e6);
+    }
+    return test_report("bench_parser");
+}
@@ -0,0 +1,407 @@
+/**
+ * @file fuzz_parser.c
+ * @brief Randomized test of every input parser, built with ASan and UBSan.
+ *
+ * Feeds generated input to the text command path (process_command),
+ * tab completion, the line editor, the RPC frame receiver and macro
+ * replay from a corrupted macro page. The macro page is mapped at its
+ * real address, 0x0803F800, with an inaccessible page right after it, so
+ * reading past the end of flash faults here as it would on the target.
+ * A registered FUZZ ARGS command checks that every value a handler
+ * receives is inside its argument specification, and fixed cases check
+ * the 32-bit limits of numeric arguments.
+ *
+ * Usage: fuzz_parser [iterations [seed]]
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "test.h"
+#include "command_processor.h"
+#include "line_editor.h"
+#include "rpc.h"
+#include "flash.h"
+#include "timeout.h"
+
+#define FUZZ_ITERATIONS 20000    /**< Default number of iterations */
+#define FUZZ_PAGE_ADDRESS 0x0803F800U /**< MACRO_FLASH_ADDRESS in macro.c */
+#define FUZZ_HOST_PAGE 4096U     /**< Host page size used for the mapping */
+#define FUZZ_MACRO_MAGIC 0x4F43414DU /**< MACRO_MAGIC in macro.c */
+#define FUZZ_LINE_LENGTH 256
+
+static int (*output_hook)(int ch);
+static uint32_t fuzz_state;
+
+uint32_t timebase_us(void) {
+    return 0;
+}
+
+// The RPC idle timeout never expires here
+void timeout_start(Timeout *timeout, uint32_t delay_ms, TimeoutCallback callback) {
+}
+
+void timeout_cancel(Timeout *timeout) {
+}
+
+int USART2_Write(const uint8_t *data, int length) {
+    return length;
+}
+
+void USART2_WriteAll(const uint8_t *data, int length) {
+    if (output_hook != NULL) {
+        for (int i = 0; i < length; i++) {
+            output_hook(data[i]);
+        }
+    }
+}
+
+void USART2_SetOutputHook(int (*hook)(int ch)) {
+    output_hook = hook;
+}
+
+int flash_erase_page(uint32_t address) {
+    memset((void *)(uintptr_t)address, 0xFF, FLASH_PAGE_SIZE);
+    return 1;
+}
+
+int flash_program(uint32_t address, const void *data, uint32_t length) {
+    uint8_t *target = (uint8_t *)(uintptr_t)address;
+    const uint8_t *source = data;
+
+    // Programming can only clear bits
+    for (uint32_t i = 0; i < length; i++) {
+        target[i] &= source[i];
+    }
+    return 1;
+}
+
+int _write(int file, char *ptr, int len);
+
+/**
+ * @brief stdout write function: hands printf text to response.c, as newlib does.
+ */
+static ssize_t fuzz_stdout_write(void *cookie, const char *data, size_t length) {
+    return _write(1, (char *)data, (int)length);
+}
+
+static const char *const fuzz_modes[] = {"OFF", "ON", "BLINK", NULL};
+static const ArgSpec fuzz_args[] = {
+    ARG_INT("n", -5, 500),
+    ARG_FIXED("f", 3, -100000, 100000),
+    ARG_ENUM("mode", fuzz_modes),
+    ARG_HEX("h"),
+    ARG_WORD("w", 8),
+};
+
+/**
+ * @brief Handler for "FUZZ ARGS": checks the values against fuzz_args[].
+ */
+static void fuzz_args_command(int argc, char *argv[], const ArgValue *args) {
+    CHECK(argc >= 2 && argc <= 5);
+    CHECK(args[0].i >= -5 && args[0].i <= 500);
+    CHECK(args[1].fixed >= -100000 && args[1].fixed <= 100000);
+    if (argc > 2) {
+        CHECK(args[2].choice >= 0 && args[2].choice <= 2);
+    }
+    if (argc > 4) {
+        CHECK(args[4].length >= 1 && args[4].length <= 8 && (size_t)args[4].length == strlen(argv[4]));
+    }
+    for (int i = 0; i < argc; i++) {
+        CHECK(argv[i] != NULL && strlen(argv[i]) < FUZZ_LINE_LENGTH);
+    }
+    printf("ok\r\n");
+}
+REGISTER_COMMAND_ARGS(fuzz_args_cmd, "FUZZ ARGS", fuzz_args_command, fuzz_args, 2);
+
+/**
+ * @brief Checks the 32-bit limits of integer and fixed-point arguments.
+ *
+ * The extremes are fixed inputs rather than random ones: INT32_MIN has a
+ * magnitude one larger than INT32_MAX and must still be accepted.
+ */
+static void check_int_bounds(void) {
+    static const ArgSpec spec[] = {ARG_INT("i", INT32_MIN, INT32_MAX), ARG_FIXED("f", 3, INT32_MIN, INT32_MAX)};
+    static const struct {
+        const char *text[2];
+        int ok;
+        int32_t i, f;
+    } cases[] = {
+        {{"-2147483648", "-2147483.648"}, 1, INT32_MIN, INT32_MIN},
+        {{"2147483647", "2147483.647"}, 1, INT32_MAX, INT32_MAX},
+        {{"+2147483647", "-2147483.64"}, 1, INT32_MAX, -2147483640},
+        {{"2147483648", "0"}, 0, 0, 0},
+        {{"-2147483649", "0"}, 0, 0, 0},
+        {{"0", "2147483.648"}, 0, 0, 0},
+        {{"0", "-2147483.649"}, 0, 0, 0},
+        {{"0", "-2147484"}, 0, 0, 0},
+    };
+
+    for (size_t n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) {
+        char first[16], second[16];
+        char *argv[2] = {first, second};
+        ArgValue values[2];
+
+        strcpy(first, cases[n].text[0]);
+        strcpy(second, cases[n].text[1]);
+        CHECK_EQ(arg_parse(spec, 2, 2, 2, argv, values), cases[n].ok);
+        if (cases[n].ok) {
+            CHECK_EQ(values[0].i, cases[n].i);
+            CHECK_EQ(values[1].fixed, cases[n].f);
+        }
+    }
+}
+
+/**
+ * @brief xorshift32 generator, so a seed reproduces a run.
+ *
+ * @param limit Exclusive upper bound.
+ * @return uint32_t Value in [0, limit).
+ */
+static uint32_t fuzz_random(uint32_t limit) {
+    fuzz_state ^= fuzz_state << 13;
+    fuzz_state ^= fuzz_state >> 17;
+    fuzz_state ^= fuzz_state << 5;
+    return fuzz_state % limit;
+}
+
+static const char *const fuzz_words[] = {
+    "FUZZ", "ARGS", "MACRO", "RECORD", "END", "RUN", "LIST", "DELETE", "ERASE", "A", "B",
+    "HELP", "PROFILE", "RESET", "TIME", "ON", "OFF", "BLINK", "0x", "-", ".", "1.5", "500",
+    "-5", "99999999999", "-0.001", "100.000", "0xFFFFFFFF", "FFFFFFFFF", "abcdefgh", "abcdefghi",
+    ";", ";;", "\t", "\x7f", "\xff",
+};
+
+/**
+ * @brief Builds a line from command words, numbers and random bytes.
+ *
+ * @param line Buffer of FUZZ_LINE_LENGTH bytes.
+ */
+static void fuzz_line(char *line) {
+    int length = 0;
+    int target = (int)fuzz_random(FUZZ_LINE_LENGTH - 1);
+
+    // Often start with a real command so the argument parser gets exercised
+    if (fuzz_random(3) == 0) {
+        strcpy(line, "FUZZ ARGS ");
+        length = (int)strlen(line);
+        target = length + (int)fuzz_random(24);
+    }
+    while (length < target) {
+        if (fuzz_random(3) == 0 && length + 16 < FUZZ_LINE_LENGTH) {
+            // A number near the edges of the FUZZ ARGS ranges
+            length += sprintf(line + length, fuzz_random(2) ? "%d " : "%d.%03u ",
+                              (int)fuzz_random(620) - 10, (unsigned)fuzz_random(1000));
+        } else if (fuzz_random(4) != 0) {
+            const char *word = fuzz_words[fuzz_random(sizeof(fuzz_words) / sizeof(fuzz_words[0]))];
+            int word_length = (int)strlen(word);
+
+            if (length + word_length + 1 >= FUZZ_LINE_LENGTH) {
+                break;
+            }
+            memcpy(line + length, word, word_length);
+            length += word_length;
+            line[length++] = ' ';
+        } else {
+            line[length++] = (char)(1 + fuzz_random(255));
+        }
+    }
+    line[length] = '\0';
+}
+
+/**
+ * @brief Feeds a byte to the RPC receiver while in binary mode, as console_task() does.
+ *
+ * @param ch Received byte.
+ */
+static void fuzz_feed(uint8_t ch) {
+    if (rpc_active()) {
+        rpc_feed(ch);
+    }
+}
+
+/**
+ * @brief Sends one RPC frame: random bytes, or a well-formed frame with a random payload.
+ */
+static void fuzz_rpc_frame(void) {
+    uint8_t payload[RPC_MAX_PAYLOAD + 8];
+    int length = (int)fuzz_random(RPC_MAX_PAYLOAD + 8);
+    uint16_t crc = 0xFFFF;
+
+    for (int i = 0; i < length; i++) {
+        payload[i] = (uint8_t)fuzz_random(256);
+    }
+    if (fuzz_random(4) == 0) {
+        for (int i = 0; i < length; i++) {
+            fuzz_feed(payload[i]);
+        }
+        return;
+    }
+    if (length > RPC_MAX_PAYLOAD) {
+        length = RPC_MAX_PAYLOAD;
+    }
+    if (length >= 2) {
+        payload[1] = (uint8_t)fuzz_random(5); // Mostly valid opcodes
+    }
+    if (length >= 3 && fuzz_random(2)) {
+        payload[2] = (uint8_t)fuzz_random(16); // Mostly valid command ids
+    }
+    if (length >= 4 && fuzz_random(2)) {
+        payload[3] = (uint8_t)fuzz_random(6); // Small argc
+    }
+    fuzz_feed(RPC_SOF);
+    fuzz_feed((uint8_t)length);
+    crc = rpc_crc16_update(crc, (uint8_t)length);
+    for (int i = 0; i < length; i++) {
+        fuzz_feed(payload[i]);
+        crc = rpc_crc16_update(crc, payload[i]);
+    }
+    if (fuzz_random(8) == 0) {
+        crc ^= 1;
+    }
+    fuzz_feed((uint8_t)crc);
+    fuzz_feed((uint8_t)(crc >> 8));
+}
+
+/**
+ * @brief Writes a macro page of plausible but damaged records.
+ *
+ * @param page The mapped macro page.
+ */
+static void fuzz_macro_page(uint8_t *page) {
+    uint32_t offset = 8;
+    uint32_t header[2] = {FUZZ_MACRO_MAGIC, command_signature()};
+
+    memset(page, 0xFF, FLASH_PAGE_SIZE);
+    memcpy(page, header, sizeof(header));
+    while (offset + 24 <= FLASH_PAGE_SIZE && fuzz_random(16) != 0) {
+        uint16_t tag = (uint16_t[]){0x4D42, 0x4D43, 0x4D43, 0x4D43, 0x4D45, 0x0000}[fuzz_random(6)];
+        uint32_t size;
+
+        if (tag == 0x4D42) {
+            size = 20;
+            memset(page + offset + 4, 0, 16);
+            page[offset + 4] = fuzz_random(2) ? 'A' : 'B';
+        } else if (tag == 0x4D43) {
+            uint8_t argc = (uint8_t)fuzz_random(8);
+            uint16_t token_bytes = (uint16_t)fuzz_random(40);
+
+            size = (8 + argc * 4 + token_bytes + 3) & ~3U;
+            page[offset + 4] = (uint8_t)fuzz_random(20);
+            page[offset + 5] = fuzz_random(8) ? argc : (uint8_t)fuzz_random(256);
+            memcpy(page + offset + 6, &token_bytes, sizeof(token_bytes));
+            for (uint32_t i = 8; i < size && offset + i < FLASH_PAGE_SIZE; i++) {
+                page[offset + i] = fuzz_random(3) ? (uint8_t)fuzz_random(4) : (uint8_t)fuzz_random(256);
+            }
+        } else {
+            size = 4;
+        }
+        if (fuzz_random(8) == 0) {
+            size = fuzz_random(FLASH_PAGE_SIZE + 64) & ~3U; // Lie about the size
+        }
+        if (offset + 4 > FLASH_PAGE_SIZE) {
+            break;
+        }
+        memcpy(page + offset, &tag, sizeof(tag));
+        memcpy(page + offset + 2, &(uint16_t){(uint16_t)size}, sizeof(uint16_t));
+        if (size < 4 || size > FLASH_PAGE_SIZE - offset) {
+            break;
+        }
+        offset += size;
+    }
+    // A record right at the end of the page, claiming more than is left
+    if (fuzz_random(4) == 0) {
+        uint16_t tail[2] = {fuzz_random(2) ? 0x4D43 : 0x4D42, 0x0100};
+        memcpy(page + FLASH_PAGE_SIZE - 4, tail, sizeof(tail));
+    }
+    for (int flips = (int)fuzz_random(4); flips > 0; flips--) {
+        page[fuzz_random(FLASH_PAGE_SIZE)] ^= (uint8_t)(1U << fuzz_random(8));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    cookie_io_functions_t functions = {.write = fuzz_stdout_write};
+    long iterations = (argc > 1) ? atol(argv[1]) : FUZZ_ITERATIONS;
+    uint8_t *mapping, *page;
+    char line[FUZZ_LINE_LENGTH];
+    char copy[FUZZ_LINE_LENGTH];
+    char insert[LINE_EDITOR_LENGTH];
+
+    fuzz_state = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 1U;
+    if (fuzz_state == 0) {
+        fuzz_state = 1;
+    }
+
+    // Macro page at its flash address, followed by a guard page
+    mapping = mmap((void *)(uintptr_t)(FUZZ_PAGE_ADDRESS & ~(FUZZ_HOST_PAGE - 1)), 2 * FUZZ_HOST_PAGE,
+                   PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (mapping == MAP_FAILED || mprotect(mapping + FUZZ_HOST_PAGE, FUZZ_HOST_PAGE, PROT_NONE) != 0) {
+        perror("fuzz_parser: mapping the macro page");
+        return 1;
+    }
+    page = (uint8_t *)(uintptr_t)FUZZ_PAGE_ADDRESS;
+    memset(page, 0xFF, FLASH_PAGE_SIZE);
+
+    stdout = fopencookie(NULL, "w", functions);
+    setvbuf(stdout, NULL, _IOFBF, 128);
+    command_processor_init();
+    check_int_bounds();
+
+    for (long i = 0; i < iterations; i++) {
+        // Text commands and completion
+        fuzz_line(line);
+        strcpy(copy, line);
+        command_complete(copy, insert, (int)fuzz_random(sizeof(insert)));
+        process_command(line);
+
+        // Keystrokes through the line editor
+        for (int keys = (int)fuzz_random(64); keys > 0; keys--) {
+            static const char keys_used[] = "\x01\x03\x05\x08\t\x15\x1b[O3~ABCD\x7f\rFUZZ ARGS 1 2 ";
+            uint8_t ch = fuzz_random(2) ? (uint8_t)keys_used[fuzz_random(sizeof(keys_used) - 1)]
+                                        : (uint8_t)fuzz_random(256);
+            char *entered = line_editor_feed(ch);
+
+            if (entered != NULL && entered[0] != '\0') {
+                process_command(entered);
+            }
+        }
+
+        // Binary frames
+        rpc_enter();
+        for (int frames = (int)fuzz_random(4); frames > 0; frames--) {
+            fuzz_rpc_frame();
+        }
+        // EXIT must get through once the receiver has resynchronized on
+        // the frames that follow a damaged one
+        for (int tries = 0; rpc_active() && tries < 64; tries++) {
+            const uint8_t exit_frame[] = {0, RPC_OP_EXIT};
+            uint16_t crc = rpc_crc16_update(0xFFFF, sizeof(exit_frame));
+
+            fuzz_feed(RPC_SOF);
+            fuzz_feed(sizeof(exit_frame));
+            for (size_t j = 0; j < sizeof(exit_frame); j++) {
+                fuzz_feed(exit_frame[j]);
+                crc = rpc_crc16_update(crc, exit_frame[j]);
+            }
+            fuzz_feed((uint8_t)crc);
+            fuzz_feed((uint8_t)(crc >> 8));
+        }
+        CHECK(!rpc_active());
+
+        // Replay of a damaged macro page
+        if (i % 4 == 0) {
+            fuzz_macro_page(page);
+            strcpy(line, "MACRO LIST");
+            process_command(line);
+            strcpy(line, fuzz_random(2) ? "MACRO RUN A" : "MACRO RUN B");
+            process_command(line);
+        }
+    }
+    fflush(stdout);
+    stdout = fdopen(1, "w");
+    return test_report("fuzz_parser");
+}
@@ -0,0 +1,79 @@
+/**
+ * @file rpc_cli.c
+ * @brief Example command-line client for the binary RPC mode.
+ *
+ * Usage: rpc_cli <device> "<COMMAND NAME>" [args...]
+ *
+ * Prints the packed result fields in hex, followed by the command's text.
+ *
+ * Word arguments are passed as text; every other argument is a number
+ * (decimal, or hex with a 0x prefix) that is sent as its packed value,
+ * i.e. fixed-point arguments are given scaled and enum arguments as the
+ * index of the keyword.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "rpc_client.h"
+
+int main(int argc, char *argv[]) {
+    RpcClient client;
+    RpcArgs args;
+    RpcResponse response;
+    int id;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <device> \"<COMMAND NAME>\" [args...]\n", argv[0]);
+        return 2;
+    }
+    if (!rpc_open(&client, argv[1])) {
+        perror(argv[1]);
+        return 1;
+    }
+    if (!rpc_connect(&client)) {
+        fprintf(stderr, "no response from board\n");
+        return 1;
+    }
+    id = rpc_find_command(&client, argv[2]);
+    if (id < 0) {
+        fprintf(stderr, "unknown command %s\n", argv[2]);
+        rpc_disconnect(&client);
+        return 1;
+    }
+
+    rpc_args_init(&args);
+    for (int i = 3; i < argc; i++) {
+        int index = i - 3;
+        int ok;
+
+        if (index < client.commands[id].nargs && client.commands[id].types[index] == RPC_ARG_WORD) {
+            ok = rpc_args_word(&args, argv[i]);
+        } else {
+            ok = rpc_args_int(&args, (int32_t)strtoll(argv[i], NULL, 0));
+        }
+        if (!ok) {
+            fprintf(stderr, "too many arguments\n");
+            return 1;
+        }
+    }
+
+    if (!rpc_call(&client, id, RPC_CALL_TEXT, &args, &response)) {
+        fprintf(stderr, "no response from board\n");
+        return 1;
+    }
+    printf("status %u", response.status);
+    if (response.result_length > 0) {
+        printf(", result");
+        for (int i = 0; i < response.result_length; i++) {
+            printf(" %02X", response.result[i]);
+        }
+    }
+    printf("\n%s", response.text);
+
+    rpc_disconnect(&client);
+    rpc_close(&client);
+    return response.status == RPC_STATUS_OK ? 0 : 1;
+}
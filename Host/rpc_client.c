@@ -0,0 +1,406 @@
+/**
+ * @file rpc_client.c
+ * @brief POSIX implementation of the binary RPC client library.
+ *
+ * Opens the console with the board's serial settings (19200 baud, 8 data
+ * bits, odd parity, 1 stop bit), switches it into binary mode and learns
+ * the command table once with HELLO and DESCRIBE. Each call is a single
+ * request frame and a single response frame, resent after a timeout. The
+ * escape sequence goes out again before a request that follows a quiet
+ * spell or a timeout, in case the board has returned to text mode.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <strings.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "rpc_client.h"
+
+#define RPC_CLIENT_BAUD B19200
+#define RPC_CLIENT_TIMEOUT_MS 500
+#define RPC_CLIENT_RETRIES 2
+#define RPC_CLIENT_REENTER_MS (RPC_IDLE_TIMEOUT_MS / 2) /**< Quiet time after which the escape is resent */
+
+/**
+ * @brief Opens and configures the serial port.
+ *
+ * @param client Client to initialize.
+ * @param device Serial device, e.g. "/dev/ttyACM0".
+ * @return int Returns 1 on success, 0 on failure (errno is set).
+ */
+int rpc_open(RpcClient *client, const char *device) {
+    struct termios tio;
+
+    memset(client, 0, sizeof(*client));
+    client->timeout_ms = RPC_CLIENT_TIMEOUT_MS;
+    client->retries = RPC_CLIENT_RETRIES;
+    client->fd = open(device, O_RDWR | O_NOCTTY);
+    if (client->fd < 0) {
+        return 0;
+    }
+    if (tcgetattr(client->fd, &tio) != 0) {
+        close(client->fd);
+        return 0;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag &= ~(CSIZE | CSTOPB);
+    tio.c_cflag |= CS8 | PARENB | PARODD | CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, RPC_CLIENT_BAUD);
+    cfsetospeed(&tio, RPC_CLIENT_BAUD);
+    if (tcsetattr(client->fd, TCSANOW, &tio) != 0) {
+        close(client->fd);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Closes the serial port.
+ *
+ * @param client Client to close.
+ */
+void rpc_close(RpcClient *client) {
+    if (client->fd >= 0) {
+        close(client->fd);
+        client->fd = -1;
+    }
+}
+
+/**
+ * @brief Writes a whole buffer to the port.
+ *
+ * @return int Returns 1 on success, 0 on a write error.
+ */
+static int write_all(int fd, const uint8_t *data, int length) {
+    while (length > 0) {
+        ssize_t written = write(fd, data, (size_t)length);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        data += written;
+        length -= (int)written;
+    }
+    return 1;
+}
+
+/**
+ * @brief Returns a monotonic time stamp.
+ *
+ * @return uint32_t Milliseconds.
+ */
+static uint32_t monotonic_ms(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+/**
+ * @brief Sends the escape sequence that switches the board to binary mode.
+ *
+ * Harmless in binary mode, where the board ignores bytes between frames.
+ *
+ * @return int Returns 1 on success, 0 on a write error.
+ */
+static int send_escape(RpcClient *client) {
+    static const uint8_t escape[RPC_ESCAPE_LENGTH] = RPC_ESCAPE_SEQUENCE;
+
+    if (!write_all(client->fd, escape, RPC_ESCAPE_LENGTH)) {
+        return 0;
+    }
+    client->sent_ms = monotonic_ms();
+    return 1;
+}
+
+/**
+ * @brief Reads one byte, waiting up to the client's timeout.
+ *
+ * @return int The byte, or -1 on a timeout or error.
+ */
+static int read_byte(const RpcClient *client) {
+    struct pollfd pfd = {client->fd, POLLIN, 0};
+    uint8_t byte;
+
+    if (poll(&pfd, 1, client->timeout_ms) <= 0 || read(client->fd, &byte, 1) != 1) {
+        return -1;
+    }
+    return byte;
+}
+
+/**
+ * @brief Sends one frame.
+ *
+ * @return int Returns 1 on success, 0 on a write error.
+ */
+static int send_frame(const RpcClient *client, const uint8_t *payload, int length) {
+    uint8_t frame[RPC_MAX_PAYLOAD + 4];
+    uint16_t crc = rpc_crc16_update(0xFFFF, (uint8_t)length);
+
+    frame[0] = RPC_SOF;
+    frame[1] = (uint8_t)length;
+    for (int i = 0; i < length; i++) {
+        frame[2 + i] = payload[i];
+        crc = rpc_crc16_update(crc, payload[i]);
+    }
+    frame[2 + length] = (uint8_t)crc;
+    frame[3 + length] = (uint8_t)(crc >> 8);
+    return write_all(client->fd, frame, length + 4);
+}
+
+/**
+ * @brief Receives one frame with a valid CRC.
+ *
+ * @param payload Buffer of RPC_MAX_PAYLOAD bytes.
+ * @return int Payload length, or -1 on a timeout.
+ */
+static int receive_frame(const RpcClient *client, uint8_t *payload) {
+    for (;;) {
+        int byte = read_byte(client);
+        int length;
+        uint16_t crc;
+        int crc_low, crc_high;
+
+        if (byte < 0) {
+            return -1;
+        }
+        if (byte != RPC_SOF) {
+            continue; // Leftover text from before binary mode
+        }
+        length = read_byte(client);
+        if (length < 0) {
+            return -1;
+        }
+        if (length > RPC_MAX_PAYLOAD) {
+            continue;
+        }
+        crc = rpc_crc16_update(0xFFFF, (uint8_t)length);
+        for (int i = 0; i < length; i++) {
+            byte = read_byte(client);
+            if (byte < 0) {
+                return -1;
+            }
+            payload[i] = (uint8_t)byte;
+            crc = rpc_crc16_update(crc, (uint8_t)byte);
+        }
+        crc_low = read_byte(client);
+        crc_high = read_byte(client);
+        if (crc_low < 0 || crc_high < 0) {
+            return -1;
+        }
+        if (crc == (uint16_t)(crc_low | (crc_high << 8))) {
+            return length;
+        }
+    }
+}
+
+/**
+ * @brief Sends a request and waits for the response with the same sequence number.
+ *
+ * @param client Connected client.
+ * @param op Request opcode.
+ * @param data Request data.
+ * @param length Length of the request data.
+ * @param response Buffer of RPC_MAX_PAYLOAD bytes receiving the response payload.
+ * @return int Response payload length (at least 2: seq and status), or -1 on failure.
+ */
+static int transact(RpcClient *client, uint8_t op, const uint8_t *data, int length, uint8_t *response) {
+    uint8_t request[RPC_MAX_PAYLOAD];
+
+    if (length > RPC_MAX_PAYLOAD - 2) {
+        return -1;
+    }
+    request[0] = ++client->seq;
+    request[1] = op;
+    memcpy(request + 2, data, (size_t)length);
+
+    for (int attempt = 0; attempt <= client->retries; attempt++) {
+        int received;
+
+        // The board leaves binary mode after RPC_IDLE_TIMEOUT_MS of silence
+        if ((attempt > 0 || monotonic_ms() - client->sent_ms >= RPC_CLIENT_REENTER_MS) && !send_escape(client)) {
+            return -1;
+        }
+        if (!send_frame(client, request, length + 2)) {
+            return -1;
+        }
+        client->sent_ms = monotonic_ms();
+        do {
+            received = receive_frame(client, response);
+        } while (received >= 0 && (received < 2 || response[0] != request[0]));
+        if (received >= 2) {
+            return received;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Switches the board to binary mode and learns its command table.
+ *
+ * @param client Open client.
+ * @return int Returns 1 on success, 0 if the board does not answer.
+ */
+int rpc_connect(RpcClient *client) {
+    uint8_t response[RPC_MAX_PAYLOAD];
+    int length;
+
+    // Enter binary mode and drop the text console's output
+    if (!send_escape(client)) {
+        return 0;
+    }
+    tcflush(client->fd, TCIFLUSH);
+
+    length = transact(client, RPC_OP_HELLO, NULL, 0, response);
+    if (length < 9 || response[1] != RPC_STATUS_OK || response[2] != RPC_VERSION) {
+        return 0;
+    }
+    client->signature = (uint32_t)response[3] | ((uint32_t)response[4] << 8) |
+                        ((uint32_t)response[5] << 16) | ((uint32_t)response[6] << 24);
+    client->command_count = (response[7] < RPC_CLIENT_MAX_COMMANDS) ? response[7] : RPC_CLIENT_MAX_COMMANDS;
+
+    for (int id = 0; id < client->command_count; id++) {
+        RpcCommandInfo *info = &client->commands[id];
+        uint8_t request = (uint8_t)id;
+        int name_length;
+
+        length = transact(client, RPC_OP_DESCRIBE, &request, 1, response);
+        if (length < 5 || response[1] != RPC_STATUS_OK) {
+            return 0;
+        }
+        info->nargs = (response[2] < RPC_CLIENT_MAX_ARGS) ? response[2] : RPC_CLIENT_MAX_ARGS;
+        info->required = response[3];
+        name_length = response[4];
+        if (name_length >= RPC_CLIENT_NAME_LENGTH || 5 + name_length + info->nargs * 10 > length) {
+            return 0;
+        }
+        memcpy(info->name, response + 5, (size_t)name_length);
+        info->name[name_length] = '\0';
+        for (int i = 0; i < info->nargs; i++) {
+            info->types[i] = response[5 + name_length + i * 10];
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Looks up a command id by name, ignoring case.
+ *
+ * @param client Connected client.
+ * @param name Full command name, e.g. "TEMP READ".
+ * @return int The command id, or -1 if the board has no such command.
+ */
+int rpc_find_command(const RpcClient *client, const char *name) {
+    for (int id = 0; id < client->command_count; id++) {
+        if (strcasecmp(client->commands[id].name, name) == 0) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Starts an empty argument list.
+ *
+ * @param args Argument list to initialize.
+ */
+void rpc_args_init(RpcArgs *args) {
+    args->data[0] = 0;
+    args->length = 1;
+}
+
+/**
+ * @brief Appends an integer, hex, fixed-point (scaled) or enum (index) argument.
+ *
+ * @return int Returns 1 on success, 0 if the request would be too long.
+ */
+int rpc_args_int(RpcArgs *args, int32_t value) {
+    if (args->length + 4 > RPC_MAX_PAYLOAD - 4) {
+        return 0;
+    }
+    for (int i = 0; i < 4; i++) {
+        args->data[args->length++] = (uint8_t)((uint32_t)value >> (8 * i));
+    }
+    args->data[0]++;
+    return 1;
+}
+
+/**
+ * @brief Appends a word argument.
+ *
+ * @return int Returns 1 on success, 0 if the request would be too long.
+ */
+int rpc_args_word(RpcArgs *args, const char *word) {
+    size_t length = strlen(word);
+
+    if (length > 255 || args->length + 1 + (int)length > RPC_MAX_PAYLOAD - 4) {
+        return 0;
+    }
+    args->data[args->length++] = (uint8_t)length;
+    memcpy(args->data + args->length, word, length);
+    args->length += (int)length;
+    args->data[0]++;
+    return 1;
+}
+
+/**
+ * @brief Calls a command and decodes its response.
+ *
+ * @param client Connected client.
+ * @param id Command id from rpc_find_command().
+ * @param flags RPC_CALL_TEXT to get the command's printf text, 0 for the result fields only.
+ * @param args Packed arguments.
+ * @param response Receives the status, result fields and text.
+ * @return int Returns 1 if a response arrived (check response->status), 0 otherwise.
+ */
+int rpc_call(RpcClient *client, int id, int flags, const RpcArgs *args, RpcResponse *response) {
+    uint8_t request[RPC_MAX_PAYLOAD];
+    int length;
+
+    if (id < 0 || id > 255 || args->length + 2 > RPC_MAX_PAYLOAD - 2) {
+        return 0;
+    }
+    request[0] = (uint8_t)id;
+    request[1] = (uint8_t)flags;
+    memcpy(request + 2, args->data, (size_t)args->length);
+    length = transact(client, RPC_OP_CALL, request, args->length + 2, response->payload);
+    if (length < 0) {
+        return 0;
+    }
+
+    response->status = response->payload[1];
+    response->result = response->payload + 3;
+    response->result_length = 0;
+    response->text_length = 0;
+    if (length >= 3 && 3 + response->payload[2] <= length) {
+        response->result_length = response->payload[2];
+        response->text_length = length - 3 - response->result_length;
+    }
+    response->text = (const char *)response->result + response->result_length;
+    response->payload[3 + response->result_length + response->text_length] = '\0';
+    return 1;
+}
+
+/**
+ * @brief Returns the board to the text console.
+ *
+ * @param client Connected client.
+ * @return int Returns 1 if the board acknowledged, 0 otherwise.
+ */
+int rpc_disconnect(RpcClient *client) {
+    uint8_t response[RPC_MAX_PAYLOAD];
+
+    return transact(client, RPC_OP_EXIT, NULL, 0, response) >= 2;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file rpc_client.h
+ * @brief Host-side client library for the firmware's binary RPC mode.
+ *
+ * Talks to the board over a POSIX serial port using the frames defined in
+ * Src/rpc_protocol.h. Commands are looked up by name once and then called
+ * by id with packed arguments, so scripted queries need neither text
+ * formatting on the way in nor output scraping on the way out.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef RPC_CLIENT_H
+#define RPC_CLIENT_H
+
+#include <stdint.h>
+#include "rpc_protocol.h"
+
+#define RPC_CLIENT_MAX_COMMANDS 64
+#define RPC_CLIENT_MAX_ARGS 16
+#define RPC_CLIENT_NAME_LENGTH 32
+
+/**
+ * @brief Description of one firmware command, as returned by DESCRIBE.
+ */
+typedef struct {
+    char name[RPC_CLIENT_NAME_LENGTH];
+    uint8_t nargs;
+    uint8_t required;
+    uint8_t types[RPC_CLIENT_MAX_ARGS]; /**< RPC_ARG_* type of each argument */
+} RpcCommandInfo;
+
+/**
+ * @brief Connection to one board.
+ */
+typedef struct {
+    int fd;
+    uint8_t seq;
+    int timeout_ms;          /**< Time to wait for each response */
+    int retries;             /**< Resends after a timeout */
+    uint32_t sent_ms;        /**< Monotonic time of the last byte sent, in ms */
+    uint32_t signature;      /**< Command table identity reported by HELLO */
+    int command_count;
+    RpcCommandInfo commands[RPC_CLIENT_MAX_COMMANDS];
+} RpcClient;
+
+/**
+ * @brief Packed arguments of one CALL.
+ */
+typedef struct {
+    uint8_t data[RPC_MAX_PAYLOAD];
+    int length;
+} RpcArgs;
+
+/**
+ * @brief Decoded response of a CALL.
+ */
+typedef struct {
+    uint8_t status;
+    const uint8_t *result;   /**< Packed result fields, layout defined per command */
+    int result_length;
+    const char *text;        /**< Text the command printed if RPC_CALL_TEXT was set, NUL-terminated */
+    int text_length;
+    uint8_t payload[RPC_MAX_PAYLOAD + 1];
+} RpcResponse;
+
+// Function Declarations
+int rpc_open(RpcClient *client, const char *device);
+void rpc_close(RpcClient *client);
+int rpc_connect(RpcClient *client);
+int rpc_find_command(const RpcClient *client, const char *name);
+void rpc_args_init(RpcArgs *args);
+int rpc_args_int(RpcArgs *args, int32_t value);
+int rpc_args_word(RpcArgs *args, const char *word);
+int rpc_call(RpcClient *client, int id, int flags, const RpcArgs *args, RpcResponse *response);
+int rpc_disconnect(RpcClient *client);
+
+#endif // RPC_CLIENT_H
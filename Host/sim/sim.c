@@ -0,0 +1,119 @@
+/**
+ * @file sim.c
+ * @brief Register storage of the host register simulator.
+ *
+ * Each peripheral pointer of stm32f0xx.h points at a zero-initialized
+ * struct, the reset state of most registers. USART2 is reached through
+ * sim_usart2(), which models the single-wire loopback of the self-test.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "stm32f0xx.h"
+
+#define SIM_PERIPHERAL(type, name) static type name##_regs; type *name = &name##_regs;
+
+SIM_PERIPHERAL(GPIO_TypeDef, GPIOA)
+SIM_PERIPHERAL(GPIO_TypeDef, GPIOB)
+SIM_PERIPHERAL(GPIO_TypeDef, GPIOC)
+SIM_PERIPHERAL(GPIO_TypeDef, GPIOD)
+SIM_PERIPHERAL(GPIO_TypeDef, GPIOF)
+SIM_PERIPHERAL(RCC_TypeDef, RCC)
+SIM_PERIPHERAL(TIM_TypeDef, TIM2)
+SIM_PERIPHERAL(TIM_TypeDef, TIM3)
+SIM_PERIPHERAL(TIM_TypeDef, TIM6)
+SIM_PERIPHERAL(TIM_TypeDef, TIM7)
+SIM_PERIPHERAL(TIM_TypeDef, TIM14)
+SIM_PERIPHERAL(DMA_TypeDef, DMA1)
+SIM_PERIPHERAL(DMA_Channel_TypeDef, DMA1_Channel2)
+SIM_PERIPHERAL(DMA_Channel_TypeDef, DMA1_Channel3)
+SIM_PERIPHERAL(EXTI_TypeDef, EXTI)
+SIM_PERIPHERAL(SYSCFG_TypeDef, SYSCFG)
+SIM_PERIPHERAL(PWR_TypeDef, PWR)
+SIM_PERIPHERAL(FLASH_TypeDef, FLASH)
+SIM_PERIPHERAL(SysTick_Type, SysTick)
+SIM_PERIPHERAL(SCB_Type, SCB)
+SIM_PERIPHERAL(I2C_TypeDef, I2C1)
+SIM_PERIPHERAL(IWDG_TypeDef, IWDG)
+SIM_PERIPHERAL(RTC_TypeDef, RTC)
+SIM_PERIPHERAL(DBGMCU_TypeDef, DBGMCU)
+
+#define SIM_USART_TDR_EMPTY 0xFFFFFFFFUL /**< TDR value while no frame waits to be sent */
+
+static USART_TypeDef usart2_regs;
+uint32_t sim_usart2_frames = 0;
+uint32_t sim_usart2_drop_frame = 0;
+uint32_t sim_usart2_parity_frame = 0;
+static int usart2_looped = 0;     // Loopback was active at the previous access
+static int usart2_rxne_shown = 0; // RXNE was visible to the previous access
+
+uint32_t SystemCoreClock = 8000000;
+uint32_t sim_primask = 0;
+
+/**
+ * @brief Returns the RDR mask of the programmed frame format.
+ *
+ * @return uint32_t Data bits of a received frame, without the parity bit.
+ */
+static uint32_t usart2_data_mask(void) {
+    uint32_t bits = (usart2_regs.CR1 & USART_CR1_M1) ? 7 : (usart2_regs.CR1 & USART_CR1_M0) ? 9 : 8;
+
+    if (usart2_regs.CR1 & USART_CR1_PCE) {
+        bits--;
+    }
+    return (1UL << bits) - 1;
+}
+
+/**
+ * @brief Returns USART2 after running the loopback model; every USART2
+ * register access goes through here.
+ *
+ * While HDSEL, TE and UE are set, a value written to TDR comes back in RDR
+ * with the frame mask applied and sets RXNE at the next access, so frames
+ * take no time and TXE and TC stay set. ICR writes clear the matching ISR
+ * flags. Frame number sim_usart2_drop_frame is lost and frame
+ * sim_usart2_parity_frame arrives with PE set. The simulator cannot see
+ * which register a read touches, so RXNE is visible to one access only, as
+ * if the driver reads RDR right after the ISR read that showed it.
+ *
+ * @return USART_TypeDef* The USART2 registers.
+ */
+USART_TypeDef *sim_usart2(void) {
+    USART_TypeDef *usart = &usart2_regs;
+
+    if (usart2_rxne_shown) {
+        usart->ISR &= ~USART_ISR_RXNE;
+        usart2_rxne_shown = 0;
+    }
+    if ((usart->CR3 & USART_CR3_HDSEL) == 0 ||
+        (usart->CR1 & (USART_CR1_UE | USART_CR1_TE)) != (USART_CR1_UE | USART_CR1_TE)) {
+        usart2_looped = 0;
+        return usart;
+    }
+    if (!usart2_looped) {
+        // The line is idle when the loopback starts
+        usart->TDR = SIM_USART_TDR_EMPTY;
+        usart2_looped = 1;
+    }
+    usart->ISR = (usart->ISR & ~usart->ICR) | USART_ISR_TXE | USART_ISR_TC;
+    usart->ICR = 0;
+    if (usart->TDR != SIM_USART_TDR_EMPTY) {
+        uint32_t data = usart->TDR & usart2_data_mask();
+
+        usart->TDR = SIM_USART_TDR_EMPTY;
+        sim_usart2_frames++;
+        if (sim_usart2_frames != sim_usart2_drop_frame) {
+            usart->RDR = data;
+            usart->ISR |= USART_ISR_RXNE;
+            if (sim_usart2_frames == sim_usart2_parity_frame) {
+                usart->ISR |= USART_ISR_PE;
+            }
+            usart2_rxne_shown = 1;
+        }
+    }
+    return usart;
+}
+
+void SystemCoreClockUpdate(void) {
+}
@@ -0,0 +1,324 @@
+/**
+ * @file stm32f0xx.h
+ * @brief Host register simulator standing in for the CMSIS device header.
+ *
+ * Declares the STM32F091 peripherals used by the firmware with the CMSIS
+ * register layout and bit names, but every peripheral is a plain struct in
+ * host RAM (see sim.c). Drivers compiled against this header run on the
+ * host; a test presets status bits the code waits on and inspects what the
+ * driver wrote. Nothing reacts to writes, so peripheral behaviour a test
+ * depends on must be modelled by the test itself. The one exception is the
+ * USART2 single-wire loopback (HDSEL), modelled in sim.c so the link
+ * self-test runs on the host. The core intrinsics
+ * (WFI, NVIC) are no-ops, except that PRIMASK is kept in sim_primask so a
+ * test can see whether code runs with interrupts disabled.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef STM32F0XX_SIM_H
+#define STM32F0XX_SIM_H
+
+#include <stdint.h>
+#define __IO volatile
+#define __I volatile const
+typedef struct { __IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2], BRR; } GPIO_TypeDef;
+typedef struct { __IO uint32_t CR, CFGR, CIR, APB2RSTR, APB1RSTR, AHBENR, APB2ENR, APB1ENR, BDCR, CSR, AHBRSTR, CFGR2, CFGR3, CR2; } RCC_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, CR3, BRR, GTPR, RTOR, RQR, ISR, ICR, RDR, TDR; } USART_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR, CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR, OR; } TIM_TypeDef;
+typedef struct { __IO uint32_t CCR, CNDTR, CPAR, CMAR; } DMA_Channel_TypeDef;
+typedef struct { __IO uint32_t ISR, IFCR; uint32_t RESERVED0[40]; __IO uint32_t CSELR; } DMA_TypeDef;
+typedef struct { __IO uint32_t IMR, EMR, RTSR, FTSR, SWIER, PR; } EXTI_TypeDef;
+typedef struct { __IO uint32_t CFGR1; uint32_t R; __IO uint32_t EXTICR[4]; __IO uint32_t CFGR2; } SYSCFG_TypeDef;
+typedef struct { __IO uint32_t CR, CSR; } PWR_TypeDef;
+typedef struct { __IO uint32_t ACR, KEYR, OPTKEYR, SR, CR, AR, RESERVED, OBR, WRPR; } FLASH_TypeDef;
+typedef struct { __IO uint32_t CTRL, LOAD, VAL; __I uint32_t CALIB; } SysTick_Type;
+typedef struct { __I uint32_t CPUID; __IO uint32_t ICSR, RESERVED0, AIRCR, SCR, CCR; } SCB_Type;
+typedef struct { __IO uint32_t CR1, CR2, OAR1, OAR2, TIMINGR, TIMEOUTR, ISR, ICR, PECR, RXDR, TXDR; } I2C_TypeDef;
+typedef struct { __IO uint32_t KR, PR, RLR, SR, WINR; } IWDG_TypeDef;
+typedef struct { __IO uint32_t TR, DR, CR, ISR, PRER, WUTR, RES, ALRMAR, RES2, WPR, SSR; } RTC_TypeDef;
+typedef struct { __IO uint32_t IDCODE, CR, APB1FZ, APB2FZ; } DBGMCU_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, SR, DR, CRCPR, RXCRCR, TXCRCR, I2SCFGR, I2SPR; } SPI_TypeDef;
+typedef struct { __IO uint32_t ISR, IER, CR, CFGR1, CFGR2, SMPR; uint32_t RESERVED1, RESERVED2; __IO uint32_t TR; uint32_t RESERVED3; __IO uint32_t CHSELR; uint32_t RESERVED4[5]; __IO uint32_t DR; } ADC_TypeDef;
+typedef struct { __IO uint32_t CR, CFGR, TXDR, RXDR, ISR, IER; } CEC_TypeDef;
+typedef enum { USART2_IRQn = 28, TIM6_DAC_IRQn = 17, EXTI4_15_IRQn = 7, TIM2_IRQn = 15, RTC_IRQn = 2, DMA1_Ch2_3_DMA2_Ch1_2_IRQn = 10, SysTick_IRQn = -1 } IRQn_Type;
+extern GPIO_TypeDef *GPIOA, *GPIOB, *GPIOC, *GPIOD, *GPIOF;
+extern RCC_TypeDef *RCC; extern TIM_TypeDef *TIM2, *TIM3, *TIM6, *TIM7, *TIM14;
+extern DMA_TypeDef *DMA1; extern DMA_Channel_TypeDef *DMA1_Channel2, *DMA1_Channel3;
+extern EXTI_TypeDef *EXTI; extern SYSCFG_TypeDef *SYSCFG; extern PWR_TypeDef *PWR; extern FLASH_TypeDef *FLASH;
+extern SysTick_Type *SysTick; extern SCB_Type *SCB; extern I2C_TypeDef *I2C1; extern IWDG_TypeDef *IWDG; extern RTC_TypeDef *RTC; extern DBGMCU_TypeDef *DBGMCU;
+/* USART2 goes through sim_usart2() so the loopback model sees every access */
+USART_TypeDef *sim_usart2(void);
+#define USART2 (sim_usart2())
+extern uint32_t sim_usart2_frames;       /**< Frames looped back while HDSEL was set */
+extern uint32_t sim_usart2_drop_frame;   /**< Frame number lost on the line, 0 for none */
+extern uint32_t sim_usart2_parity_frame; /**< Frame number received with PE set, 0 for none */
+#define PERIPH_BASE 0x40000000UL
+#define FLASH_BASE 0x08000000UL
+#define SRAM_BASE 0x20000000UL
+#define SIM_BIT(n) (1UL << (n))
+/* RCC */
+#define RCC_CR_HSION SIM_BIT(0)
+#define RCC_CR_HSIRDY SIM_BIT(1)
+#define RCC_CR_HSEON SIM_BIT(16)
+#define RCC_CR_PLLON SIM_BIT(24)
+#define RCC_CR_PLLRDY SIM_BIT(25)
+#define RCC_CR2_HSI48ON SIM_BIT(16)
+#define RCC_CR2_HSI48RDY SIM_BIT(17)
+#define RCC_CFGR_SW (3UL)
+#define RCC_CFGR_SW_HSI 0UL
+#define RCC_CFGR_SW_HSE 1UL
+#define RCC_CFGR_SW_PLL 2UL
+#define RCC_CFGR_SW_HSI48 3UL
+#define RCC_CFGR_SWS (3UL<<2)
+#define RCC_CFGR_SWS_HSI 0UL
+#define RCC_CFGR_SWS_HSE (1UL<<2)
+#define RCC_CFGR_SWS_PLL (2UL<<2)
+#define RCC_CFGR_SWS_HSI48 (3UL<<2)
+#define RCC_CFGR_HPRE (0xFUL<<4)
+#define RCC_CFGR_HPRE_Pos 4
+#define RCC_CFGR_PPRE (7UL<<8)
+#define RCC_CFGR_PPRE_Pos 8
+#define RCC_CFGR_PLLSRC (3UL<<15)
+#define RCC_CFGR_PLLSRC_HSI_DIV2 0UL
+#define RCC_CFGR_PLLSRC_HSI48_PREDIV (3UL<<15)
+#define RCC_CFGR_PLLSRC_HSI_PREDIV (1UL<<15)
+#define RCC_CFGR_PLLSRC_HSE_PREDIV (2UL<<15)
+#define HSE_VALUE 8000000U
+#define RCC_CFGR_PLLMUL (0xFUL<<18)
+#define RCC_CFGR_PLLMUL_Pos 18
+#define RCC_CFGR_PLLMUL12 (0xAUL<<18)
+#define RCC_CFGR2_PREDIV (0xFUL)
+#define RCC_CFGR3_USART1SW (3UL)
+#define RCC_CFGR3_I2C1SW SIM_BIT(4)
+#define RCC_CFGR3_USART2SW (3UL<<16)
+#define RCC_CFGR3_USART2SW_0 SIM_BIT(16)
+#define RCC_CFGR3_USART2SW_1 SIM_BIT(17)
+#define RCC_CFGR3_USART2SW_Pos 16
+#define RCC_CFGR3_USART2SW_PCLK 0UL
+#define RCC_CFGR3_USART2SW_SYSCLK SIM_BIT(16)
+#define RCC_CFGR3_USART2SW_LSE SIM_BIT(17)
+#define RCC_CFGR3_USART2SW_HSI (3UL<<16)
+#define RCC_AHBENR_GPIOAEN SIM_BIT(17)
+#define RCC_AHBENR_GPIOBEN SIM_BIT(18)
+#define RCC_AHBENR_GPIOCEN SIM_BIT(19)
+#define RCC_AHBENR_DMA1EN SIM_BIT(0)
+#define RCC_APB1ENR_USART2EN SIM_BIT(17)
+#define RCC_APB1ENR_TIM2EN SIM_BIT(0)
+#define RCC_APB1ENR_TIM6EN SIM_BIT(4)
+#define RCC_APB1ENR_TIM7EN SIM_BIT(5)
+#define RCC_APB1ENR_TIM14EN SIM_BIT(8)
+#define RCC_APB1ENR_PWREN SIM_BIT(28)
+#define RCC_APB1ENR_I2C1EN SIM_BIT(21)
+#define RCC_APB2ENR_SYSCFGCOMPEN SIM_BIT(0)
+#define RCC_APB2ENR_DBGMCUEN SIM_BIT(22)
+#define RCC_BDCR_LSEON SIM_BIT(0)
+#define RCC_BDCR_LSERDY SIM_BIT(1)
+#define RCC_BDCR_RTCSEL (3UL<<8)
+#define RCC_BDCR_RTCSEL_LSE SIM_BIT(8)
+#define RCC_BDCR_RTCSEL_LSI SIM_BIT(9)
+#define RCC_BDCR_RTCEN SIM_BIT(15)
+#define RCC_BDCR_BDRST SIM_BIT(16)
+#define RCC_CSR_LSION SIM_BIT(0)
+#define RCC_CSR_LSIRDY SIM_BIT(1)
+#define RCC_CSR_RMVF SIM_BIT(24)
+#define RCC_CSR_PINRSTF SIM_BIT(26)
+#define RCC_CSR_PORRSTF SIM_BIT(27)
+#define RCC_CSR_SFTRSTF SIM_BIT(28)
+#define RCC_CSR_IWDGRSTF SIM_BIT(29)
+#define RCC_CSR_WWDGRSTF SIM_BIT(30)
+#define RCC_CSR_LPWRRSTF SIM_BIT(31)
+/* FLASH */
+#define FLASH_ACR_LATENCY SIM_BIT(0)
+#define FLASH_ACR_PRFTBE SIM_BIT(4)
+#define FLASH_KEY1 0x45670123UL
+#define FLASH_KEY2 0xCDEF89ABUL
+#define FLASH_SR_BSY SIM_BIT(0)
+#define FLASH_SR_PGERR SIM_BIT(2)
+#define FLASH_SR_WRPRTERR SIM_BIT(4)
+#define FLASH_SR_EOP SIM_BIT(5)
+#define FLASH_CR_PG SIM_BIT(0)
+#define FLASH_CR_PER SIM_BIT(1)
+#define FLASH_CR_STRT SIM_BIT(6)
+#define FLASH_CR_LOCK SIM_BIT(7)
+/* PWR / SCB */
+#define PWR_CR_LPDS SIM_BIT(0)
+#define PWR_CR_PDDS SIM_BIT(1)
+#define PWR_CR_CWUF SIM_BIT(2)
+#define PWR_CR_DBP SIM_BIT(8)
+#define SCB_SCR_SLEEPDEEP_Msk SIM_BIT(2)
+#define SCB_SCR_SLEEPONEXIT_Msk SIM_BIT(1)
+/* USART */
+#define USART_CR1_UE SIM_BIT(0)
+#define USART_CR1_UESM SIM_BIT(1)
+#define USART_CR1_RE SIM_BIT(2)
+#define USART_CR1_TE SIM_BIT(3)
+#define USART_CR1_RXNEIE SIM_BIT(5)
+#define USART_CR1_TCIE SIM_BIT(6)
+#define USART_CR1_TXEIE SIM_BIT(7)
+#define USART_CR1_PS SIM_BIT(9)
+#define USART_CR1_PCE SIM_BIT(10)
+#define USART_CR1_M0 SIM_BIT(12)
+#define USART_CR1_OVER8 SIM_BIT(15)
+#define USART_CR1_M1 SIM_BIT(28)
+#define USART_CR2_STOP (3UL<<12)
+#define USART_CR2_STOP_1 SIM_BIT(13)
+#define USART_CR3_EIE SIM_BIT(0)
+#define USART_CR3_HDSEL SIM_BIT(3)
+#define USART_CR3_DMAT SIM_BIT(7)
+#define USART_CR3_OVRDIS SIM_BIT(12)
+#define USART_CR3_WUS (3UL<<20)
+#define USART_CR3_WUS_0 SIM_BIT(20)
+#define USART_CR3_WUS_1 SIM_BIT(21)
+#define USART_CR3_WUFIE SIM_BIT(22)
+#define USART_ISR_PE SIM_BIT(0)
+#define USART_ISR_FE SIM_BIT(1)
+#define USART_ISR_NE SIM_BIT(2)
+#define USART_ISR_ORE SIM_BIT(3)
+#define USART_ISR_RXNE SIM_BIT(5)
+#define USART_ISR_TC SIM_BIT(6)
+#define USART_ISR_TXE SIM_BIT(7)
+#define USART_ISR_BUSY SIM_BIT(16)
+#define USART_ISR_WUF SIM_BIT(20)
+#define USART_ISR_TEACK SIM_BIT(21)
+#define USART_ISR_REACK SIM_BIT(22)
+#define USART_ICR_PECF SIM_BIT(0)
+#define USART_ICR_FECF SIM_BIT(1)
+#define USART_ICR_NCF SIM_BIT(2)
+#define USART_ICR_ORECF SIM_BIT(3)
+#define USART_ICR_TCCF SIM_BIT(6)
+#define USART_ICR_WUCF SIM_BIT(20)
+#define USART_RQR_RXFRQ SIM_BIT(3)
+/* GPIO */
+#define GPIO_BSRR_BS_5 SIM_BIT(5)
+#define GPIO_BSRR_BR_5 SIM_BIT(21)
+#define GPIO_AFRL_AFSEL2_Msk (0xFUL<<8)
+#define GPIO_AFRL_AFSEL3_Msk (0xFUL<<12)
+#define GPIO_AFRL_AFSEL2_Pos 8
+#define GPIO_AFRL_AFSEL3_Pos 12
+/* TIM */
+#define TIM_CR1_CEN SIM_BIT(0)
+#define TIM_CR1_URS SIM_BIT(2)
+#define TIM_CR1_OPM SIM_BIT(3)
+#define TIM_CR1_ARPE SIM_BIT(7)
+#define TIM_DIER_UIE SIM_BIT(0)
+#define TIM_DIER_CC1IE SIM_BIT(1)
+#define TIM_DIER_UDE SIM_BIT(8)
+#define TIM_SR_UIF SIM_BIT(0)
+#define TIM_SR_CC1IF SIM_BIT(1)
+#define TIM_EGR_UG SIM_BIT(0)
+#define TIM_CCMR1_OC1M_1 SIM_BIT(5)
+#define TIM_CCMR1_OC1M_2 SIM_BIT(6)
+#define TIM_CCMR1_OC1M (7UL<<4)
+#define TIM_CCMR1_OC1PE SIM_BIT(3)
+#define TIM_CCER_CC1E SIM_BIT(0)
+#define TIM_CCMR1_CC1S_0 SIM_BIT(0)
+#define TIM_CCMR1_IC1PSC (3UL<<2)
+#define TIM14_OR_TI1_RMP_0 SIM_BIT(0)
+/* DMA */
+#define DMA_CCR_EN SIM_BIT(0)
+#define DMA_CCR_TCIE SIM_BIT(1)
+#define DMA_CCR_DIR SIM_BIT(4)
+#define DMA_CCR_CIRC SIM_BIT(5)
+#define DMA_CCR_MINC SIM_BIT(7)
+#define DMA_CCR_PSIZE_1 SIM_BIT(9)
+#define DMA_CCR_MSIZE_0 SIM_BIT(10)
+#define DMA_CCR_PL_0 SIM_BIT(12)
+#define DMA1_CSELR_CH2_TIM2_UP 0x80UL
+#define DMA_CSELR_C2S (0xFUL<<4)
+/* EXTI / SYSCFG */
+#define EXTI_IMR_MR13 SIM_BIT(13)
+#define EXTI_IMR_MR17 SIM_BIT(17)
+#define EXTI_IMR_MR26 SIM_BIT(26)
+#define EXTI_RTSR_TR13 SIM_BIT(13)
+#define EXTI_RTSR_TR17 SIM_BIT(17)
+#define EXTI_FTSR_TR13 SIM_BIT(13)
+#define EXTI_PR_PR13 SIM_BIT(13)
+#define EXTI_PR_PR17 SIM_BIT(17)
+#define SYSCFG_EXTICR4_EXTI13 (0xFUL<<4)
+#define SYSCFG_EXTICR4_EXTI13_PC (2UL<<4)
+/* I2C */
+#define I2C_CR1_PE SIM_BIT(0)
+#define I2C_CR2_SADD_Pos 0
+#define I2C_CR2_RD_WRN SIM_BIT(10)
+#define I2C_CR2_START SIM_BIT(13)
+#define I2C_CR2_STOP SIM_BIT(14)
+#define I2C_CR2_NBYTES_Pos 16
+#define I2C_CR2_AUTOEND SIM_BIT(25)
+#define I2C_ISR_TXE SIM_BIT(0)
+#define I2C_ISR_TXIS SIM_BIT(1)
+#define I2C_ISR_RXNE SIM_BIT(2)
+#define I2C_ISR_NACKF SIM_BIT(4)
+#define I2C_ISR_STOPF SIM_BIT(5)
+#define I2C_ISR_TC SIM_BIT(6)
+#define I2C_ISR_BERR SIM_BIT(8)
+#define I2C_ISR_ARLO SIM_BIT(9)
+#define I2C_ISR_BUSY SIM_BIT(15)
+#define I2C_ICR_NACKCF SIM_BIT(4)
+#define I2C_ICR_STOPCF SIM_BIT(5)
+#define I2C_ICR_BERRCF SIM_BIT(8)
+#define I2C_ICR_ARLOCF SIM_BIT(9)
+#define I2C_TIMINGR_PRESC_Pos 28
+#define I2C_TIMINGR_SCLDEL_Pos 20
+#define I2C_TIMINGR_SDADEL_Pos 16
+#define I2C_TIMINGR_SCLH_Pos 8
+#define I2C_TIMINGR_SCLL_Pos 0
+/* RTC */
+#define RTC_CR_WUTE SIM_BIT(10)
+#define RTC_CR_WUTIE SIM_BIT(14)
+#define RTC_CR_WUCKSEL (7UL)
+#define RTC_ISR_WUTWF SIM_BIT(2)
+#define RTC_ISR_WUTF SIM_BIT(10)
+#define RTC_ISR_INIT SIM_BIT(7)
+#define RTC_ISR_INITF SIM_BIT(6)
+#define RTC_CR_BYPSHAD SIM_BIT(5)
+#define RTC_CR_WUCKSEL_2 SIM_BIT(2)
+#define RTC_PRER_PREDIV_A_Pos 16
+#define RTC_TR_HT (3UL<<20)
+#define RTC_TR_HT_Pos 20
+#define RTC_TR_HU (0xFUL<<16)
+#define RTC_TR_HU_Pos 16
+#define RTC_TR_MNT (7UL<<12)
+#define RTC_TR_MNT_Pos 12
+#define RTC_TR_MNU (0xFUL<<8)
+#define RTC_TR_MNU_Pos 8
+#define RTC_TR_ST (7UL<<4)
+#define RTC_TR_ST_Pos 4
+#define RTC_TR_SU (0xFUL)
+#define RTC_TR_SU_Pos 0
+#define RTC_SSR_SS (0xFFFFUL)
+#define EXTI_IMR_MR20 SIM_BIT(20)
+#define EXTI_RTSR_TR20 SIM_BIT(20)
+#define EXTI_PR_PR20 SIM_BIT(20)
+/* SysTick */
+#define SysTick_CTRL_ENABLE_Msk SIM_BIT(0)
+#define SysTick_CTRL_TICKINT_Msk SIM_BIT(1)
+#define SysTick_CTRL_CLKSOURCE_Msk SIM_BIT(2)
+#define SysTick_CTRL_COUNTFLAG_Msk SIM_BIT(16)
+#define SysTick_LOAD_RELOAD_Msk 0xFFFFFFUL
+#define DBGMCU_APB1_FZ_DBG_IWDG_STOP SIM_BIT(12)
+#define DBGMCU_CR_DBG_STOP SIM_BIT(1)
+static inline void NVIC_EnableIRQ(IRQn_Type n){(void)n;}
+static inline void NVIC_DisableIRQ(IRQn_Type n){(void)n;}
+static inline void NVIC_SetPriority(IRQn_Type n, uint32_t p){(void)n;(void)p;}
+static inline void NVIC_ClearPendingIRQ(IRQn_Type n){(void)n;}
+static inline uint32_t NVIC_GetPendingIRQ(IRQn_Type n){(void)n;return 0;}
+static inline uint32_t SysTick_Config(uint32_t t){(void)t;return 0;}
+static inline void __WFI(void){}
+static inline void __WFE(void){}
+static inline void __SEV(void){}
+static inline void __DSB(void){}
+static inline void __ISB(void){}
+static inline void __NOP(void){}
+extern uint32_t sim_primask;
+static inline void __disable_irq(void){sim_primask=1;}
+static inline void __enable_irq(void){sim_primask=0;}
+static inline uint32_t __get_PRIMASK(void){return sim_primask;}
+static inline void __set_PRIMASK(uint32_t p){sim_primask=p&1U;}
+static inline void NVIC_SystemReset(void){}
+extern uint32_t SystemCoreClock;
+void SystemCoreClockUpdate(void);
+#define __NVIC_PRIO_BITS 2
+
+#endif // STM32F0XX_SIM_H
@@ -0,0 +1,53 @@
+/**
+ * @file test.h
+ * @brief Check macros shared by the host tests.
+ *
+ * Each test is one program: it runs its checks, prints every failure with
+ * its location, and returns test_report() from main(), which is non-zero
+ * if anything failed.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+static int test_checks = 0;
+static int test_failures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        test_checks++;                                                                    \
+        if (!(condition)) {                                                               \
+            test_failures++;                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        }                                                                                 \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                        \
+    do {                                                                                  \
+        unsigned long actual_ = (unsigned long)(actual);                                  \
+        unsigned long expected_ = (unsigned long)(expected);                              \
+        test_checks++;                                                                    \
+        if (actual_ != expected_) {                                                       \
+            test_failures++;                                                              \
+            fprintf(stderr, "%s:%d: %s is %lu, expected %lu\n", __FILE__, __LINE__,       \
+                    #actual, actual_, expected_);                                         \
+        }                                                                                 \
+    } while (0)
+
+/**
+ * @brief Prints the summary line of a test program.
+ *
+ * @param name Test name.
+ * @return int Exit status: 0 if every check passed, 1 otherwise.
+ */
+static inline int test_report(const char *name) {
+    printf("%s: %d checks, %d failed\n", name, test_checks, test_failures);
+    return test_failures != 0;
+}
+
+#endif // TEST_H
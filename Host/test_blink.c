@@ -0,0 +1,177 @@
+/**
+ * @file test_blink.c
+ * @brief Host test of the LED blink scheduler on the simulated tick.
+ *
+ * Runs the real tick, timer wheel and blink code with SysTick_Handler()
+ * called once per simulated millisecond. Every PA5 level the scheduler
+ * writes to BSRR is logged with its tick. The test then checks the edge
+ * times of a group pattern across tick counter wraparound, the repeat
+ * count, stopping and replacing a pattern, that channels outside the table
+ * are ignored, and that a late tick does not stretch the schedule.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "test.h"
+#include "../Src/tick.c"
+#include "../Src/led_blink.c"
+
+#define MAX_EDGES 256
+
+// PA5 level changes seen on BSRR
+typedef struct {
+    uint32_t tick;
+    int level;
+} Edge;
+
+static Edge edges[MAX_EDGES];
+static int edge_count;
+static int stop_pattern_calls;
+
+uint32_t clock_hclk_hz(void) {
+    return 48000000U;
+}
+
+void LED_StopPattern(void) {
+    stop_pattern_calls++;
+}
+
+/**
+ * @brief Logs the PA5 level written since the last call, if any.
+ */
+static void record_output(void) {
+    uint32_t bsrr = GPIOA->BSRR;
+
+    if (bsrr != 0 && edge_count < MAX_EDGES) {
+        int level = (bsrr & (1U << 5)) != 0;
+
+        if (edge_count == 0 || edges[edge_count - 1].level != level) {
+            edges[edge_count].tick = ticks;
+            edges[edge_count].level = level;
+            edge_count++;
+        }
+    }
+    GPIOA->BSRR = 0;
+}
+
+/**
+ * @brief Runs the tick interrupt for a number of milliseconds.
+ *
+ * @param ms Ticks to run.
+ */
+static void run_ticks(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        SysTick_Handler();
+        record_output();
+    }
+}
+
+/**
+ * @brief Moves the tick counter while the wheel is empty, as if the board sat idle.
+ *
+ * @param now New tick count; must be ahead of the current one.
+ */
+static void set_ticks(uint32_t now) {
+    ticks = now;
+    timeout_tick(now);
+}
+
+/**
+ * @brief Clears the edge log and starts a pattern at the current tick.
+ */
+static void start_pattern(const BlinkPattern *pattern) {
+    edge_count = 0;
+    GPIOA->BSRR = 0;
+    LED_BlinkStart(LED_BLINK_USER, pattern);
+    record_output();
+}
+
+static void test_group_pattern_across_wrap(void) {
+    // LED CODE 3 2: three 200/300 ms pulses, 1.2 s extra gap, two groups
+    const BlinkPattern code = {LED_CODE_ON_MS, LED_CODE_OFF_MS, LED_CODE_GAP_MS, 3, 2};
+    const uint32_t expected[] = {0, 200, 500, 700, 1000, 1200, 2700, 2900, 3200, 3400, 3700, 3900};
+    uint32_t start, next;
+
+    set_ticks(0xFFFFF000U); // Wraps 4096 ticks in
+    start = ticks;
+    start_pattern(&code);
+    run_ticks(6000);
+
+    CHECK_EQ(edge_count, sizeof(expected) / sizeof(expected[0]));
+    for (int i = 0; i < edge_count && i < (int)(sizeof(expected) / sizeof(expected[0])); i++) {
+        CHECK_EQ(edges[i].tick - start, expected[i]);
+        CHECK_EQ(edges[i].level, (i % 2) == 0);
+    }
+    CHECK(!channels[LED_BLINK_USER].active);
+    CHECK(!timeout_active(&channels[LED_BLINK_USER].edge));
+    CHECK(!timeout_next_expiry(&next));
+    CHECK(stop_pattern_calls > 0);
+}
+
+static void test_stop_and_replace(void) {
+    const BlinkPattern fast = {3, 7, 0, 1, 0};
+    const BlinkPattern slow = {50, 50, 0, 1, 0};
+    int rising = 0;
+    uint32_t next;
+
+    set_ticks(0x10000U);
+    start_pattern(&fast);
+    run_ticks(999);
+    for (int i = 0; i < edge_count; i++) {
+        rising += edges[i].level;
+    }
+    CHECK_EQ(rising, 100);
+    CHECK_EQ(edge_count, 200);
+
+    // Replacing keeps a single edge timeout on the wheel
+    start_pattern(&slow);
+    CHECK(timeout_next_expiry(&next));
+    CHECK_EQ(next, ticks + 50);
+    run_ticks(999);
+    CHECK_EQ(edge_count, 20); // 10 periods of 100 ms
+    CHECK_EQ(edges[1].tick - edges[0].tick, 50);
+
+    // Stopping turns the LED off and leaves the wheel empty
+    LED_BlinkStop(LED_BLINK_USER);
+    CHECK_EQ(GPIOA->BSRR, 1U << 21);
+    GPIOA->BSRR = 0;
+    edge_count = 0;
+    run_ticks(500);
+    CHECK_EQ(edge_count, 0);
+    CHECK(!timeout_next_expiry(&next));
+
+    // Channels outside the table are ignored
+    LED_BlinkStart(LED_BLINK_CHANNELS, &fast);
+    LED_BlinkStop(-1);
+    CHECK_EQ(GPIOA->BSRR, 0);
+    CHECK(!timeout_next_expiry(&next));
+}
+
+static void test_late_tick(void) {
+    const BlinkPattern square = {5, 5, 0, 1, 3};
+    uint32_t start;
+
+    set_ticks(0x20000U);
+    start = ticks;
+    start_pattern(&square);
+    run_ticks(2);
+    // 7 ms pass at once, as after Stop mode: the off edge due at 5 runs late
+    tick_advance(7);
+    record_output();
+    run_ticks(30);
+
+    CHECK_EQ(edge_count, 6);
+    CHECK_EQ(edges[1].tick - start, 9);  // Late
+    CHECK_EQ(edges[2].tick - start, 10); // Back on schedule, not 9 + 5
+    CHECK_EQ(edges[3].tick - start, 15);
+    CHECK_EQ(edges[5].tick - start, 25);
+    CHECK(!channels[LED_BLINK_USER].active);
+}
+
+int main(void) {
+    test_group_pattern_across_wrap();
+    test_stop_and_replace();
+    test_late_tick();
+    return test_report("test_blink");
+}
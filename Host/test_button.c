@@ -0,0 +1,159 @@
+/**
+ * @file test_button.c
+ * @brief Host test of the EXTI button debounce on the simulated tick.
+ *
+ * Runs button.c with the real tick, timer wheel and event queue. The test
+ * drives the PC13 input level once per simulated millisecond and raises
+ * the EXTI interrupt for each edge while the line is unmasked. Checks that
+ * a bouncy press gives one SHORT event, that a 1.5 s hold gives one LONG
+ * event while held and nothing on release, and that a glitch shorter than
+ * the debounce time gives no event.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "test.h"
+#include "../Src/tick.c"
+#include "../Src/button.c"
+
+static int level_pressed = 0;
+static int interrupts = 0;
+
+uint32_t clock_hclk_hz(void) {
+    return 48000000U;
+}
+
+/**
+ * @brief Sets the button level; an edge raises EXTI13 if it is unmasked.
+ *
+ * @param down 1 to press (PC13 low), 0 to release.
+ */
+static void set_button(int down) {
+    if (down == level_pressed) {
+        return;
+    }
+    level_pressed = down;
+    if (down) {
+        GPIOC->IDR &= ~(1U << BUTTON_PIN);
+    } else {
+        GPIOC->IDR |= 1U << BUTTON_PIN;
+    }
+    EXTI->PR |= BUTTON_EXTI;
+    if (EXTI->IMR & BUTTON_EXTI) {
+        interrupts++;
+        EXTI4_15_IRQHandler();
+    }
+}
+
+/**
+ * @brief Runs the tick interrupt for a number of milliseconds.
+ *
+ * @param ms Ticks to run.
+ */
+static void run_ticks(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        SysTick_Handler();
+    }
+}
+
+/**
+ * @brief Toggles the level every millisecond, ending at the given level.
+ *
+ * @param down Level the contacts settle at.
+ * @param bounces Number of level changes before they settle.
+ */
+static void bounce(int down, int bounces) {
+    for (int i = 0; i < bounces; i++) {
+        set_button((bounces - i) % 2 == 0 ? down : !down);
+        run_ticks(1);
+    }
+    set_button(down);
+}
+
+/**
+ * @brief Takes every queued event, counting each kind.
+ */
+static void drain_events(int *shorts, int *longs, uint32_t *data) {
+    Event event;
+
+    *shorts = 0;
+    *longs = 0;
+    while (event_get(&event)) {
+        if (event.type == EVENT_BUTTON_SHORT) {
+            (*shorts)++;
+        } else if (event.type == EVENT_BUTTON_LONG) {
+            (*longs)++;
+        }
+        *data = event.data;
+    }
+}
+
+static void test_bouncy_press(void) {
+    int shorts, longs;
+    uint32_t held = 0;
+
+    interrupts = 0;
+    bounce(1, 7);
+    run_ticks(300);
+    bounce(0, 7);
+    run_ticks(100);
+    drain_events(&shorts, &longs, &held);
+    CHECK_EQ(shorts, 1);
+    CHECK_EQ(longs, 0);
+    CHECK(held >= 290 && held <= 310);
+    CHECK_EQ(interrupts, 2); // One per press and one per release
+    CHECK(!timeout_active(&debounce) && !timeout_active(&long_press));
+}
+
+static void test_long_hold(void) {
+    int shorts, longs;
+    uint32_t held = 0;
+
+    bounce(1, 3);
+    run_ticks(BUTTON_LONG_MS + 100);
+    // Reported while still held
+    drain_events(&shorts, &longs, &held);
+    CHECK_EQ(shorts, 0);
+    CHECK_EQ(longs, 1);
+    CHECK_EQ(held, BUTTON_LONG_MS);
+    run_ticks(400);
+    bounce(0, 3);
+    run_ticks(100);
+    drain_events(&shorts, &longs, &held);
+    CHECK_EQ(shorts, 0);
+    CHECK_EQ(longs, 0);
+}
+
+static void test_glitch(void) {
+    int shorts, longs;
+    uint32_t held = 0;
+
+    set_button(1);
+    run_ticks(5);
+    set_button(0);
+    run_ticks(BUTTON_LONG_MS + 100);
+    drain_events(&shorts, &longs, &held);
+    CHECK_EQ(shorts, 0);
+    CHECK_EQ(longs, 0);
+    CHECK(EXTI->IMR & BUTTON_EXTI);
+
+    // The next real press still registers
+    set_button(1);
+    run_ticks(50);
+    set_button(0);
+    run_ticks(50);
+    drain_events(&shorts, &longs, &held);
+    CHECK_EQ(shorts, 1);
+    CHECK(held >= 45 && held <= 55);
+}
+
+int main(void) {
+    GPIOC->IDR = 1U << BUTTON_PIN; // Released: pulled up
+    button_init();
+    run_ticks(10);
+    test_bouncy_press();
+    test_long_hold();
+    test_glitch();
+    return test_report("test_button");
+}
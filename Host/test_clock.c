@@ -0,0 +1,130 @@
+/**
+ * @file test_clock.c
+ * @brief Host test of the clock tree decoding.
+ *
+ * Sets RCC_CFGR and RCC_CFGR2 on the register simulator for HSI, HSI48,
+ * HSE and the PLL from each of its sources, with the AHB and APB
+ * prescalers at every setting, and checks the SYSCLK, HCLK, PCLK and
+ * timer clock the drivers are given. Also runs clock_init() with the
+ * oscillator reported ready and checks the flash and prescaler settings
+ * it leaves, and the CLOCK command's listing and packed RPC result.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <string.h>
+#include "test.h"
+#include "../Src/clock.c"
+
+static uint8_t rpc_fields[RPC_MAX_RESULT]; // Result fields of the last command
+static int rpc_fields_length;
+
+int rpc_result(const void *data, int length) {
+    memcpy(rpc_fields, data, length);
+    rpc_fields_length = length;
+    return 1;
+}
+
+/**
+ * @brief Selects a SYSCLK source as the switch would report it.
+ *
+ * @param sws RCC_CFGR_SWS_* value.
+ * @param rest Other CFGR fields.
+ */
+static void set_cfgr(uint32_t sws, uint32_t rest) {
+    RCC->CFGR = sws | (sws >> 2) | rest;
+}
+
+static void test_sources(void) {
+    RCC->CFGR2 = 0;
+    set_cfgr(RCC_CFGR_SWS_HSI, 0);
+    CHECK_EQ(clock_sysclk_hz(), 8000000U);
+    set_cfgr(RCC_CFGR_SWS_HSI48, 0);
+    CHECK_EQ(clock_sysclk_hz(), 48000000U);
+    set_cfgr(RCC_CFGR_SWS_HSE, 0);
+    CHECK_EQ(clock_sysclk_hz(), HSE_VALUE);
+
+    // PLL: HSI/2 x 12, the CLOCK_USE_PLL setup; PREDIV does not apply to HSI/2
+    RCC->CFGR2 = 3;
+    set_cfgr(RCC_CFGR_SWS_PLL, RCC_CFGR_PLLSRC_HSI_DIV2 | RCC_CFGR_PLLMUL12);
+    CHECK_EQ(clock_sysclk_hz(), 48000000U);
+    // HSI / PREDIV: 8 MHz / 4 x 6
+    set_cfgr(RCC_CFGR_SWS_PLL, RCC_CFGR_PLLSRC_HSI_PREDIV | (4UL << RCC_CFGR_PLLMUL_Pos));
+    CHECK_EQ(clock_sysclk_hz(), 12000000U);
+    // HSI48 / PREDIV: 48 MHz / 4 x 2
+    set_cfgr(RCC_CFGR_SWS_PLL, RCC_CFGR_PLLSRC_HSI48_PREDIV);
+    CHECK_EQ(clock_sysclk_hz(), 24000000U);
+    // HSE / PREDIV: 8 MHz / 1 x 6
+    RCC->CFGR2 = 0;
+    set_cfgr(RCC_CFGR_SWS_PLL, RCC_CFGR_PLLSRC_HSE_PREDIV | (4UL << RCC_CFGR_PLLMUL_Pos));
+    CHECK_EQ(clock_sysclk_hz(), 48000000U);
+    // PLLMUL 1110 and 1111 both multiply by 16
+    RCC->CFGR2 = 7;
+    set_cfgr(RCC_CFGR_SWS_PLL, RCC_CFGR_PLLSRC_HSE_PREDIV | (0xEUL << RCC_CFGR_PLLMUL_Pos));
+    CHECK_EQ(clock_sysclk_hz(), 16000000U);
+    set_cfgr(RCC_CFGR_SWS_PLL, RCC_CFGR_PLLSRC_HSE_PREDIV | (0xFUL << RCC_CFGR_PLLMUL_Pos));
+    CHECK_EQ(clock_sysclk_hz(), 16000000U);
+}
+
+static void test_prescalers(void) {
+    // HPRE 0xxx undivided, then /2, /4, /8, /16, /64, /128, /256, /512
+    static const uint32_t hclk_div[16] = {1, 1, 1, 1, 1, 1, 1, 1, 2, 4, 8, 16, 64, 128, 256, 512};
+    // PPRE 0xx undivided, then /2, /4, /8, /16
+    static const uint32_t pclk_div[8] = {1, 1, 1, 1, 2, 4, 8, 16};
+
+    RCC->CFGR2 = 0;
+    for (uint32_t hpre = 0; hpre < 16; hpre++) {
+        for (uint32_t ppre = 0; ppre < 8; ppre++) {
+            uint32_t hclk = 48000000U / hclk_div[hpre];
+            uint32_t pclk = hclk / pclk_div[ppre];
+
+            set_cfgr(RCC_CFGR_SWS_HSI48, (hpre << RCC_CFGR_HPRE_Pos) | (ppre << RCC_CFGR_PPRE_Pos));
+            CHECK_EQ(clock_hclk_hz(), hclk);
+            CHECK_EQ(clock_pclk_hz(), pclk);
+            // APB timers run at twice PCLK whenever APB divides
+            CHECK_EQ(clock_timer_hz(), (pclk_div[ppre] == 1) ? pclk : 2U * pclk);
+        }
+    }
+}
+
+static void test_init(void) {
+    char text[256];
+    FILE *console = stdout;
+    uint32_t result[7];
+
+    // Reset state with dividers left over, and the oscillator reported ready
+    RCC->CFGR = (0x9UL << RCC_CFGR_HPRE_Pos) | (0x5UL << RCC_CFGR_PPRE_Pos) | RCC_CFGR_SWS_HSI48;
+    RCC->CR2 = RCC_CR2_HSI48RDY;
+    FLASH->ACR = 0;
+    clock_init();
+    CHECK_EQ(FLASH->ACR, FLASH_ACR_LATENCY | FLASH_ACR_PRFTBE);
+    CHECK_EQ(RCC->CFGR & (RCC_CFGR_HPRE | RCC_CFGR_PPRE), 0);
+    CHECK_EQ(RCC->CFGR & RCC_CFGR_SW, RCC_CFGR_SW_HSI48);
+    CHECK(RCC->CR2 & RCC_CR2_HSI48ON);
+    CHECK_EQ(clock_hclk_hz(), CLOCK_SYSCLK_HZ);
+    CHECK_EQ(clock_pclk_hz(), CLOCK_SYSCLK_HZ);
+
+    memset(text, 0, sizeof(text));
+    stdout = fmemopen(text, sizeof(text) - 1, "w");
+    clock_command(0, NULL, NULL);
+    fclose(stdout);
+    stdout = console;
+    CHECK(strstr(text, "SYSCLK 48000000 Hz from HSI48, HCLK 48000000 Hz, PCLK 48000000 Hz, "
+                       "timers 48000000 Hz") != NULL);
+    CHECK(strstr(text, "Flash: 1 wait state(s), prefetch on") != NULL);
+    CHECK_EQ(rpc_fields_length, sizeof(result));
+    memcpy(result, rpc_fields, sizeof(result));
+    CHECK_EQ(result[0], 48000000U);
+    CHECK_EQ(result[3], 48000000U);
+    CHECK_EQ(result[4], 3); // HSI48
+    CHECK_EQ(result[5], 1);
+    CHECK_EQ(result[6], 1);
+}
+
+int main(void) {
+    test_sources();
+    test_prescalers();
+    test_init();
+    return test_report("test_clock");
+}
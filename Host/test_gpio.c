@@ -0,0 +1,131 @@
+/**
+ * @file test_gpio.c
+ * @brief Host test of the compile-time GPIO layer.
+ *
+ * Configures pin lists shaped like the drivers' (USART2 on PA2/PA3, I2C1
+ * on PB8/PB9, the LED on PA5) on ports preset with unrelated bits, and
+ * checks the folded register values, that pins outside the list keep
+ * their configuration, the single-pin set, clear, write and read, and
+ * the multi-pin mask versions.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "test.h"
+#include "gpio.h"
+
+#define TEST_USART_PINS(X) X(2, GPIO_MODE_AF, 1, GPIO_PUSH_PULL, GPIO_NO_PULL) \
+                           X(3, GPIO_MODE_AF, 1, GPIO_PUSH_PULL, GPIO_NO_PULL)
+#define TEST_I2C_PINS(X) X(8, GPIO_MODE_AF, 1, GPIO_OPEN_DRAIN, GPIO_PULL_UP) \
+                         X(9, GPIO_MODE_AF, 1, GPIO_OPEN_DRAIN, GPIO_PULL_UP)
+#define TEST_LED_PINS(X) X(5, GPIO_MODE_OUTPUT, 0, GPIO_PUSH_PULL, GPIO_NO_PULL)
+#define TEST_BAR_PINS(X) X(0, GPIO_MODE_OUTPUT, 0, GPIO_PUSH_PULL, GPIO_NO_PULL) \
+                         X(4, GPIO_MODE_OUTPUT, 0, GPIO_PUSH_PULL, GPIO_NO_PULL) \
+                         X(15, GPIO_MODE_OUTPUT, 0, GPIO_PUSH_PULL, GPIO_NO_PULL)
+
+static GPIO_TypeDef port;
+
+/**
+ * @brief Fills every configuration register with a pattern.
+ *
+ * @param pattern Value written to all of them.
+ */
+static void preset_port(uint32_t pattern) {
+    port.MODER = pattern;
+    port.OTYPER = pattern;
+    port.PUPDR = pattern;
+    port.AFR[0] = pattern;
+    port.AFR[1] = pattern;
+    port.BSRR = 0;
+    port.BRR = 0;
+}
+
+static void test_configure(void) {
+    // Two AF pins in the low AFR register
+    preset_port(0xFFFFFFFFU);
+    GPIO_CONFIGURE(&port, TEST_USART_PINS);
+    CHECK_EQ(port.MODER, 0xFFFFFFAFU);   // Fields 2 and 3 = 10
+    CHECK_EQ(port.OTYPER, 0xFFFFFFF3U);  // Push-pull
+    CHECK_EQ(port.PUPDR, 0xFFFFFF0FU);   // No pull
+    CHECK_EQ(port.AFR[0], 0xFFFF11FFU);  // AF1 on pins 2 and 3
+    CHECK_EQ(port.AFR[1], 0xFFFFFFFFU);  // Untouched
+
+    // Open-drain with pull-ups in the high AFR register
+    preset_port(0);
+    GPIO_CONFIGURE(&port, TEST_I2C_PINS);
+    CHECK_EQ(port.MODER, 0x000A0000U);
+    CHECK_EQ(port.OTYPER, 0x00000300U);
+    CHECK_EQ(port.PUPDR, 0x00050000U);
+    CHECK_EQ(port.AFR[0], 0U);
+    CHECK_EQ(port.AFR[1], 0x00000011U);
+
+    // An output pin leaves both AFR registers alone
+    preset_port(0x5A5A5A5AU);
+    GPIO_CONFIGURE(&port, TEST_LED_PINS);
+    CHECK_EQ(port.MODER, (0x5A5A5A5AU & ~(3U << 10)) | (1U << 10));
+    CHECK_EQ(port.OTYPER, 0x5A5A5A5AU & ~(1U << 5));
+    CHECK_EQ(port.PUPDR, 0x5A5A5A5AU & ~(3U << 10));
+    CHECK_EQ(port.AFR[0], 0x5A5A5A5AU);
+    CHECK_EQ(port.AFR[1], 0x5A5A5A5AU);
+
+    // Reconfiguring from AF back to output keeps the other pins
+    preset_port(0);
+    GPIO_CONFIGURE(&port, TEST_USART_PINS);
+    GPIO_CONFIGURE(&port, TEST_LED_PINS);
+    CHECK_EQ(port.MODER, 0x000004A0U);
+}
+
+static void test_single_pin(void) {
+    preset_port(0);
+    gpio_set(&port, 5);
+    CHECK_EQ(port.BSRR, 1U << 5);
+    gpio_clear(&port, 5);
+    CHECK_EQ(port.BRR, 1U << 5);
+    gpio_write(&port, 13, 1);
+    CHECK_EQ(port.BSRR, 1U << 13);
+    gpio_write(&port, 13, 0);
+    CHECK_EQ(port.BSRR, 1U << 29);
+
+    port.IDR = 1U << 13;
+    CHECK_EQ(gpio_read(&port, 13), 1);
+    CHECK_EQ(gpio_read(&port, 12), 0);
+    port.IDR = ~(1U << 13);
+    CHECK_EQ(gpio_read(&port, 13), 0);
+}
+
+static void test_mask(void) {
+    const uint32_t bar = GPIO_MASK(TEST_BAR_PINS);
+
+    CHECK_EQ(bar, 0x8011U);
+    CHECK_EQ(GPIO_MASK(TEST_LED_PINS), 1U << 5);
+
+    preset_port(0);
+    gpio_set_mask(&port, bar);
+    CHECK_EQ(port.BSRR, 0x8011U);
+    gpio_clear_mask(&port, bar);
+    CHECK_EQ(port.BRR, 0x8011U);
+
+    // Three pins in one store: pin 4 high, pins 0 and 15 low, others untouched
+    gpio_write_mask(&port, bar, 0x0010U);
+    CHECK_EQ(port.BSRR, 0x80010010U);
+    // Value bits outside the mask are ignored
+    gpio_write_mask(&port, bar, 0xFFFFU);
+    CHECK_EQ(port.BSRR, 0x00008011U);
+    gpio_write_mask(&port, bar, 0x7FEEU);
+    CHECK_EQ(port.BSRR, 0x80110000U);
+
+    port.IDR = 0x5A5AU;
+    CHECK_EQ(gpio_read_mask(&port, bar), 0x0010U);
+    port.IDR = 0xFFFFU;
+    CHECK_EQ(gpio_read_mask(&port, bar), bar);
+    port.IDR = ~bar;
+    CHECK_EQ(gpio_read_mask(&port, bar), 0U);
+}
+
+int main(void) {
+    test_configure();
+    test_single_pin();
+    test_mask();
+    return test_report("test_gpio");
+}
@@ -0,0 +1,199 @@
+/**
+ * @file test_health.c
+ * @brief Host test of the health monitor's blink code selection.
+ *
+ * Runs health.c with the error counters, the tick and the blink scheduler
+ * stubbed. Checks that the highest-priority raised condition picks the
+ * code, that time spent idle is not part of a main loop pass, that only
+ * passes of HEALTH_NEAR_MISS_MS or more count as near-misses, that a
+ * fault reset shows its code, that HEALTH CLEAR turns the code off, and
+ * that HEALTH returns the counts as packed RPC result fields.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <string.h>
+#include "test.h"
+#include "../Src/health.c"
+
+static uint32_t now_ms = 0;
+static uint32_t i2c_errors, rx_overflows, tx_overflows;
+static int blink_starts, blink_stops;
+static BlinkPattern blink_pattern;
+
+uint32_t tick_ms(void) {
+    return now_ms;
+}
+
+uint32_t I2C1_ErrorCount(void) {
+    return i2c_errors;
+}
+
+uint32_t USART2_RxOverflowCount(void) {
+    return rx_overflows;
+}
+
+uint32_t USART2_TxOverflowCount(void) {
+    return tx_overflows;
+}
+
+static uint8_t rpc_fields[RPC_MAX_RESULT]; // Result fields of the last command
+static int rpc_fields_length;
+
+int rpc_result(const void *data, int length) {
+    memcpy(rpc_fields, data, length);
+    rpc_fields_length = length;
+    return 1;
+}
+
+void LED_BlinkStart(int channel, const BlinkPattern *pattern) {
+    blink_starts++;
+    blink_pattern = *pattern;
+}
+
+void LED_BlinkStop(int channel) {
+    blink_stops++;
+}
+
+/**
+ * @brief Runs the HEALTH command and keeps what it prints.
+ *
+ * @param action 0 for SHOW, 1 for CLEAR.
+ * @param text Buffer for the output.
+ * @param size Size of the buffer.
+ */
+static void run_health(int action, char *text, size_t size) {
+    FILE *console = stdout;
+    ArgValue args[1] = {{.choice = action}};
+
+    memset(text, 0, size);
+    stdout = fmemopen(text, size - 1, "w");
+    health_command(1, NULL, args);
+    fclose(stdout);
+    stdout = console;
+}
+
+/**
+ * @brief Runs one main loop pass that takes a number of milliseconds.
+ *
+ * @param ms Length of the pass.
+ */
+static void run_pass(uint32_t ms) {
+    health_kick();
+    now_ms += ms;
+}
+
+static void test_priority(void) {
+    char text[512];
+    uint32_t result[HEALTH_CONDITIONS + 3];
+
+    RCC->CSR = RCC_CSR_PINRSTF;
+    health_init();
+    CHECK(RCC->CSR & RCC_CSR_RMVF);
+    run_pass(1);
+    CHECK_EQ(blink_starts, 0); // Healthy: nothing to show
+
+    // Each higher-priority condition takes over the LED
+    tx_overflows = 3;
+    run_pass(1);
+    CHECK_EQ(blink_starts, 1);
+    CHECK_EQ(blink_pattern.pulses, 1);
+    CHECK_EQ(blink_pattern.repeat, 0);
+    rx_overflows = 1;
+    run_pass(1);
+    CHECK_EQ(blink_pattern.pulses, 2);
+    i2c_errors = 7;
+    run_pass(1);
+    CHECK_EQ(blink_pattern.pulses, 3);
+    CHECK_EQ(blink_starts, 3);
+
+    // A lower-priority counter moving again changes nothing
+    tx_overflows++;
+    rx_overflows++;
+    run_pass(1);
+    CHECK_EQ(blink_starts, 3);
+
+    // SHOW returns the reset flags, the counts, the longest pass and the condition shown
+    run_health(0, text, sizeof(text));
+    CHECK_EQ(rpc_fields_length, sizeof(result));
+    memcpy(result, rpc_fields, sizeof(result));
+    CHECK_EQ(result[0], RCC_CSR_PINRSTF);
+    CHECK_EQ(result[1 + HEALTH_I2C_ERROR], 7);
+    CHECK_EQ(result[1 + HEALTH_RX_OVERFLOW], 2);
+    CHECK_EQ(result[1 + HEALTH_TX_OVERFLOW], 4);
+    CHECK_EQ(result[2 + HEALTH_CONDITIONS], HEALTH_I2C_ERROR);
+
+    // CLEAR takes the counts as the baseline and turns the code off
+    run_health(1, text, sizeof(text));
+    CHECK(strstr(text, "cleared") != NULL);
+    run_pass(1);
+    CHECK_EQ(blink_stops, 1);
+    run_pass(1);
+    CHECK_EQ(blink_stops, 1);
+
+    // And the next increment raises the condition again
+    rx_overflows++;
+    run_pass(1);
+    CHECK_EQ(blink_starts, 4);
+    CHECK_EQ(blink_pattern.pulses, 2);
+    run_health(1, text, sizeof(text));
+    run_pass(1);
+    CHECK_EQ(blink_stops, 2);
+}
+
+static void test_near_miss(void) {
+    char text[512];
+
+    // Waiting for input is not part of a pass, however long it is
+    health_kick();
+    now_ms += 100;
+    health_idle();
+    now_ms += 5 * HEALTH_WATCHDOG_MS;
+    run_pass(HEALTH_NEAR_MISS_MS - 1);
+    health_kick();
+    CHECK_EQ(near_misses, 0);
+    CHECK_EQ(longest_pass, HEALTH_NEAR_MISS_MS - 1);
+    CHECK_EQ(blink_starts, 4);
+
+    // A pass of HEALTH_NEAR_MISS_MS counts and shows code 4 over the I2C code
+    i2c_errors++;
+    run_pass(HEALTH_NEAR_MISS_MS);
+    CHECK_EQ(blink_pattern.pulses, 3);
+    health_kick();
+    CHECK_EQ(near_misses, 1);
+    CHECK_EQ(longest_pass, HEALTH_NEAR_MISS_MS);
+    CHECK_EQ(blink_pattern.pulses, 4);
+    run_health(0, text, sizeof(text));
+    CHECK(strstr(text, "Watchdog near-miss          1  code 4  <- LED") != NULL);
+    CHECK(strstr(text, "Longest loop pass: 500 ms") != NULL);
+
+    run_health(1, text, sizeof(text));
+    health_kick();
+    CHECK_EQ(longest_pass, 0);
+    CHECK_EQ(blink_stops, 3);
+}
+
+static void test_fault_reset(void) {
+    char text[512];
+
+    RCC->CSR = RCC_CSR_IWDGRSTF | RCC_CSR_PINRSTF;
+    health_init();
+    i2c_errors++;
+    run_pass(1);
+    CHECK_EQ(blink_pattern.pulses, 5); // Over every other condition
+    run_health(0, text, sizeof(text));
+    CHECK(strstr(text, "Reset cause: IWDG pin") != NULL);
+    CHECK(strstr(text, "Fault reset                 1  code 5  <- LED") != NULL);
+
+    run_health(1, text, sizeof(text));
+    run_pass(1);
+    CHECK_EQ(blink_stops, 4);
+}
+
+int main(void) {
+    test_priority();
+    test_near_miss();
+    test_fault_reset();
+    return test_report("test_health");
+}
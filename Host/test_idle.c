@@ -0,0 +1,211 @@
+/**
+ * @file test_idle.c
+ * @brief Host test of the idle manager's Stop decisions and wake-up order.
+ *
+ * Runs idle.c with the real timer wheel and event queue and stubs for the
+ * RTC, USART2 and the tick. Checks that a Stop period is armed for the
+ * next deadline however far away (up to the RTC limit), that close
+ * deadlines, holds and a busy console give Sleep, that interrupts are
+ * enabled again before the tick catches up with the time stopped, and
+ * that the catch-up runs the timeouts that fell due in expiry order, and
+ * that IDLE returns the statistics as packed RPC result fields.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <string.h>
+#include "test.h"
+#include "../Src/idle.c"
+
+static uint32_t now_ms = 1000;
+static uint32_t wakeup_ms;      // Delay the RTC wakeup was armed with, 0 if not armed
+static uint32_t stop_ms;        // Time the next Stop period lasts
+static int console_ready = 1;   // USART2_PrepareStop() result
+static int advances;
+static uint32_t advance_primask;
+static Timeout timeouts[3];
+static uint32_t fired_at[3];
+static int fire_order[3], fired;
+
+void rtc_init(void) {
+}
+
+static uint8_t rpc_fields[RPC_MAX_RESULT]; // Result fields of the last command
+static int rpc_fields_length;
+
+int rpc_result(const void *data, int length) {
+    memcpy(rpc_fields, data, length);
+    rpc_fields_length = length;
+    return 1;
+}
+
+uint32_t rtc_lsi_hz(void) {
+    return RTC_LSI_HZ;
+}
+
+uint32_t rtc_ms(void) {
+    return 0;
+}
+
+uint32_t rtc_elapsed_ms(uint32_t since) {
+    return stop_ms;
+}
+
+void rtc_wakeup_start(uint32_t delay_ms) {
+    wakeup_ms = delay_ms;
+}
+
+int rtc_wakeup_stop(void) {
+    return 1;
+}
+
+void clock_restore(void) {
+}
+
+uint32_t timebase_us(void) {
+    return 0;
+}
+
+int USART2_RxPending(void) {
+    return 0;
+}
+
+int USART2_PrepareStop(void) {
+    return console_ready;
+}
+
+int USART2_FinishStop(void) {
+    return 0;
+}
+
+uint32_t tick_ms(void) {
+    return now_ms;
+}
+
+void tick_advance(uint32_t elapsed_ms) {
+    advances++;
+    advance_primask = sim_primask;
+    now_ms += elapsed_ms;
+    timeout_tick(now_ms);
+}
+
+static void timeout_fired(Timeout *timeout) {
+    int i = (int)(timeout - timeouts);
+
+    fired_at[i] = now_ms;
+    fire_order[fired++] = i;
+}
+
+/**
+ * @brief Runs idle_wait() once and reports whether it entered Stop.
+ *
+ * @param stopped_for Time the Stop period lasts if one is entered.
+ * @return int 1 if Stop was entered.
+ */
+static int wait_once(uint32_t stopped_for) {
+    uint32_t stops = entries[IDLE_MODE_STOP];
+
+    wakeup_ms = 0;
+    stop_ms = stopped_for;
+    advances = 0;
+    idle_wait();
+    CHECK_EQ(sim_primask, 0);
+    return entries[IDLE_MODE_STOP] != stops;
+}
+
+static void test_stop_length(void) {
+    // Empty wheel: the RTC only wakes once an hour
+    CHECK(wait_once(RTC_WAKEUP_MAX_MS));
+    CHECK_EQ(wakeup_ms, RTC_WAKEUP_MAX_MS);
+    CHECK_EQ(now_ms, 1000 + RTC_WAKEUP_MAX_MS);
+
+    // A deadline ten minutes away is slept to in one Stop period
+    timeout_start(&timeouts[0], 600000, timeout_fired);
+    CHECK(wait_once(600000));
+    CHECK_EQ(wakeup_ms, 600000);
+    CHECK_EQ(fired, 1);
+    CHECK_EQ(fired_at[0], now_ms);
+
+    // Beyond the RTC limit the wakeup is clamped, and the deadline stays pending
+    timeout_start(&timeouts[0], 2 * RTC_WAKEUP_MAX_MS + 5, timeout_fired);
+    CHECK(wait_once(RTC_WAKEUP_MAX_MS));
+    CHECK_EQ(wakeup_ms, RTC_WAKEUP_MAX_MS);
+    CHECK(timeout_active(&timeouts[0]));
+    timeout_cancel(&timeouts[0]);
+}
+
+static void test_sleep_instead(void) {
+    uint32_t start = now_ms;
+
+    // Too close for Stop
+    timeout_start(&timeouts[0], IDLE_STOP_MIN_MS - 1, timeout_fired);
+    CHECK(!wait_once(0));
+    CHECK_EQ(wakeup_ms, 0);
+    CHECK_EQ(denials[IDLE_DENY_DEADLINE], 1);
+
+    // A hold or a busy console keeps the MCU in Sleep
+    timeout_start(&timeouts[0], 5000, timeout_fired);
+    idle_hold_stop();
+    CHECK(!wait_once(0));
+    CHECK_EQ(denials[IDLE_DENY_HOLD], 1);
+    idle_release_stop();
+    console_ready = 0;
+    CHECK(!wait_once(0));
+    CHECK_EQ(denials[IDLE_DENY_CONSOLE], 1);
+    console_ready = 1;
+    CHECK_EQ(advances, 0);
+    CHECK_EQ(now_ms, start);
+    timeout_cancel(&timeouts[0]);
+}
+
+static void test_catch_up(void) {
+    uint32_t start = now_ms;
+
+    // Woken early by the console after 20 s: the three timeouts due by then run in order
+    fired = 0;
+    timeout_start(&timeouts[2], 19000, timeout_fired);
+    timeout_start(&timeouts[0], 7000, timeout_fired);
+    timeout_start(&timeouts[1], 7001, timeout_fired);
+    CHECK(wait_once(20000));
+    CHECK_EQ(wakeup_ms, 7000);
+    CHECK_EQ(advances, 1);
+    CHECK_EQ(advance_primask, 0); // Interrupts were enabled before the catch-up
+    CHECK_EQ(fired, 3);
+    CHECK_EQ(fire_order[0], 0);
+    CHECK_EQ(fire_order[1], 1);
+    CHECK_EQ(fire_order[2], 2);
+    CHECK_EQ(now_ms, start + 20000);
+}
+
+static void test_result(void) {
+    char text[512];
+    FILE *console = stdout;
+    uint32_t result[13];
+
+    stdout = fmemopen(text, sizeof(text) - 1, "w");
+    idle_command(0, NULL, NULL);
+    fclose(stdout);
+    stdout = console;
+
+    CHECK_EQ(rpc_fields_length, sizeof(result));
+    memcpy(result, rpc_fields, sizeof(result));
+    CHECK_EQ(result[2], residency_us[IDLE_MODE_STOP] / 1000U);
+    CHECK_EQ(result[3], entries[IDLE_MODE_SLEEP]);
+    CHECK_EQ(result[4], entries[IDLE_MODE_STOP]);
+    CHECK(result[4] > 0);
+    CHECK_EQ(result[5 + IDLE_WAKE_RTC], wakes[IDLE_WAKE_RTC]);
+    CHECK_EQ(result[9 + IDLE_DENY_HOLD], 1);
+    CHECK_EQ(result[9 + IDLE_DENY_DEADLINE], 1);
+    CHECK_EQ(result[9 + IDLE_DENY_CONSOLE], 1);
+    CHECK_EQ(result[12], RTC_LSI_HZ);
+}
+
+int main(void) {
+    idle_init();
+    test_stop_length();
+    test_sleep_instead();
+    test_catch_up();
+    test_result();
+    return test_report("test_idle");
+}
@@ -0,0 +1,387 @@
+/**
+ * @file test_rpc_pty.c
+ * @brief Loopback test of the binary RPC mode over a pseudo-terminal.
+ *
+ * A child process plays the board: it runs the firmware's console
+ * dispatch (line editor, command processor and rpc.c) on the master side
+ * of a pty. The parent drives the slave side with the client library in
+ * Host/ and checks HELLO, DESCRIBE, CALL with and without RPC_CALL_TEXT,
+ * PROFILE's packed results, argument errors, truncation and the return to
+ * text mode by EXIT, Ctrl-C, a bare CR and the idle timeout (fired by
+ * SIGUSR1). A stray Ctrl-B or a partial escape sequence typed on the
+ * console must not leave text mode. It then times the same query both
+ * ways, as a typed line whose printf reply is scraped and as a CALL
+ * without text, and reports the mean round trip and the bytes each path
+ * puts on the wire.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#define _GNU_SOURCE
+#include <poll.h>
+#include <pty.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "test.h"
+#include "command_processor.h"
+#include "line_editor.h"
+#include "rpc.h"
+#include "rpc_client.h"
+#include "timeout.h"
+
+#define QUERIES 2000          /**< Timed queries per path */
+#define CONSOLE_BITS 11       /**< Bits per character on the wire, 8O1 */
+#define CONSOLE_BAUD 19200    /**< Console rate the wire time is computed for */
+#define TEXT_TIMEOUT_MS 1000  /**< Longest wait for a scraped text reply */
+
+// Board-side byte counters, shared with the parent
+typedef struct {
+    unsigned long rx;
+    unsigned long tx;
+} WireCounters;
+
+static int board_fd = -1;
+static int (*output_hook)(int ch);
+static WireCounters *wire;
+static Timeout *volatile idle_timeout; // Started by rpc.c, expired by SIGUSR1
+
+uint32_t timebase_us(void) {
+    return 0;
+}
+
+void macro_record_command(int id, int argc, char *argv[], const ArgValue *args) {
+}
+
+void timeout_start(Timeout *timeout, uint32_t delay_ms, TimeoutCallback callback) {
+    timeout->callback = callback;
+    idle_timeout = timeout;
+}
+
+void timeout_cancel(Timeout *timeout) {
+    idle_timeout = NULL;
+}
+
+/**
+ * @brief SIGUSR1 handler of the board: expires the idle timeout, as the tick interrupt would.
+ */
+static void board_expire(int signal) {
+    Timeout *timeout = idle_timeout;
+
+    if (timeout != NULL) {
+        idle_timeout = NULL;
+        timeout->callback(timeout);
+    }
+}
+
+int USART2_Write(const uint8_t *data, int length) {
+    if (write(board_fd, data, length) != length) {
+        exit(1);
+    }
+    wire->tx += length;
+    return length;
+}
+
+void USART2_WriteAll(const uint8_t *data, int length) {
+    if (output_hook != NULL) {
+        for (int i = 0; i < length; i++) {
+            output_hook(data[i]);
+        }
+        return;
+    }
+    USART2_Write(data, length);
+}
+
+void USART2_SetOutputHook(int (*hook)(int ch)) {
+    output_hook = hook;
+}
+
+int _write(int file, char *ptr, int len);
+
+/**
+ * @brief stdout write function of the board: hands printf text to response.c.
+ */
+static ssize_t board_stdout_write(void *cookie, const char *data, size_t length) {
+    return _write(1, (char *)data, (int)length);
+}
+
+/**
+ * @brief Handler for "QUERY SUM": prints and returns the sum of two numbers.
+ */
+static void query_sum_command(int argc, char *argv[], const ArgValue *args) {
+    int32_t sum = args[0].i + args[1].i;
+
+    rpc_result(&sum, sizeof(sum));
+    printf("sum %ld\r\n", (long)sum);
+}
+
+/**
+ * @brief Handler for "QUERY FLOOD": prints more text than one frame holds.
+ */
+static void query_flood_command(int argc, char *argv[], const ArgValue *args) {
+    for (int i = 0; i < 40; i++) {
+        printf("line %d\r\n", i);
+    }
+}
+
+/**
+ * @brief Handler for "QUERY NAME": echoes its word argument.
+ */
+static void query_name_command(int argc, char *argv[], const ArgValue *args) {
+    printf("[%s] %ld\r\n", argv[0], (long)args[0].length);
+}
+
+static const ArgSpec query_sum_args[] = {
+    ARG_INT("a", -1000, 1000),
+    ARG_INT("b", -1000, 1000),
+};
+static const ArgSpec query_name_args[] = {
+    ARG_WORD("name", 8),
+};
+REGISTER_COMMAND(query_flood, "QUERY FLOOD", query_flood_command);
+REGISTER_COMMAND_ARGS(query_name, "QUERY NAME", query_name_command, query_name_args, 1);
+REGISTER_COMMAND_ARGS(query_sum, "QUERY SUM", query_sum_command, query_sum_args, 2);
+
+/**
+ * @brief Board process: the console dispatch of main.c's console_task().
+ */
+static void board_run(void) {
+    cookie_io_functions_t functions = {.write = board_stdout_write};
+    struct sigaction expire = {.sa_handler = board_expire, .sa_flags = SA_RESTART};
+    uint8_t ch;
+
+    sigaction(SIGUSR1, &expire, NULL);
+    stdout = fopencookie(NULL, "w", functions);
+    setvbuf(stdout, NULL, _IOFBF, 128);
+    command_processor_init();
+
+    while (read(board_fd, &ch, 1) == 1) {
+        char *line;
+
+        wire->rx++;
+        if (rpc_active()) {
+            rpc_feed(ch);
+            continue;
+        }
+        if (rpc_escape(ch)) {
+            rpc_enter();
+            continue;
+        }
+        line = line_editor_feed(ch);
+        if (line != NULL && line[0] != '\0') {
+            process_command(line);
+        }
+    }
+    exit(0);
+}
+
+/**
+ * @brief Returns a monotonic time stamp.
+ *
+ * @return double Seconds.
+ */
+static double now_seconds(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Types a line on the text console and scrapes the reply.
+ *
+ * @param fd Host side of the console.
+ * @param line Line to type, without the Enter.
+ * @param expect Text that ends the reply.
+ * @return int Returns 1 once expect was received, 0 on a timeout.
+ */
+static int text_query(int fd, const char *line, const char *expect) {
+    char reply[512];
+    int length = 0;
+
+    if (write(fd, line, strlen(line)) < 0 || write(fd, "\r", 1) != 1) {
+        return 0;
+    }
+    while (length < (int)sizeof(reply) - 1) {
+        struct pollfd ready = {fd, POLLIN, 0};
+        ssize_t count;
+
+        if (poll(&ready, 1, TEXT_TIMEOUT_MS) <= 0) {
+            return 0;
+        }
+        count = read(fd, reply + length, sizeof(reply) - 1 - length);
+        if (count <= 0) {
+            return 0;
+        }
+        length += count;
+        reply[length] = '\0';
+        if (strstr(reply, expect) != NULL) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(void) {
+    static RpcClient client;
+    RpcArgs args;
+    RpcResponse response;
+    char device[64];
+    int slave, sum_id, name_id, flood_id, profile_id;
+    uint32_t runs;
+    int32_t result = 0;
+    unsigned long rx, tx, text_bytes, rpc_bytes;
+    double start, text_s, rpc_s;
+    pid_t board;
+
+    wire = mmap(NULL, sizeof(*wire), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (wire == MAP_FAILED || openpty(&board_fd, &slave, device, NULL, NULL) != 0) {
+        perror("test_rpc_pty");
+        return 1;
+    }
+    board = fork();
+    if (board == 0) {
+        board_run();
+    }
+
+    CHECK(rpc_open(&client, device));
+    CHECK(text_query(client.fd, "QUERY SUM 40 2", "sum 42\r\n"));
+    // Typed by accident: a Ctrl-B, or the escape sequence cut short
+    CHECK(text_query(client.fd, "\x02QUERY SUM 1 2", "sum 3\r\n"));
+    CHECK(text_query(client.fd, "\x02\xFF\xFE" "QUERY SUM 2 2", "sum 4\r\n"));
+
+    // Binary mode: HELLO and DESCRIBE of every command
+    CHECK(rpc_connect(&client));
+    CHECK(client.command_count >= 5);
+    sum_id = rpc_find_command(&client, "query sum");
+    name_id = rpc_find_command(&client, "QUERY NAME");
+    flood_id = rpc_find_command(&client, "QUERY FLOOD");
+    CHECK(sum_id >= 0 && name_id >= 0 && flood_id >= 0);
+    if (sum_id < 0 || name_id < 0 || flood_id < 0) {
+        kill(board, SIGKILL);
+        return test_report("test_rpc_pty");
+    }
+    CHECK_EQ(client.commands[sum_id].nargs, 2);
+    CHECK_EQ(client.commands[sum_id].types[0], RPC_ARG_INT);
+    CHECK_EQ(client.commands[name_id].types[0], RPC_ARG_WORD);
+
+    // CALL with results and text
+    rpc_args_init(&args);
+    rpc_args_int(&args, -7);
+    rpc_args_int(&args, 100);
+    CHECK(rpc_call(&client, sum_id, RPC_CALL_TEXT, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_OK);
+    CHECK_EQ(response.result_length, sizeof(result));
+    memcpy(&result, response.result, sizeof(result));
+    CHECK_EQ(result, 93);
+    CHECK(strcmp(response.text, "sum 93\r\n") == 0);
+
+    // Without RPC_CALL_TEXT only the results come back
+    CHECK(rpc_call(&client, sum_id, 0, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_OK);
+    CHECK_EQ(response.result_length, sizeof(result));
+    CHECK_EQ(response.text_length, 0);
+
+    rpc_args_init(&args);
+    rpc_args_word(&args, "abc");
+    CHECK(rpc_call(&client, name_id, RPC_CALL_TEXT, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_OK);
+    CHECK(strcmp(response.text, "[abc] 3\r\n") == 0);
+
+    // Errors: range, missing argument, over-long word, unknown id
+    rpc_args_init(&args);
+    rpc_args_int(&args, 1001);
+    rpc_args_int(&args, 0);
+    CHECK(rpc_call(&client, sum_id, RPC_CALL_TEXT, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_BAD_ARGS);
+    rpc_args_init(&args);
+    rpc_args_int(&args, 1);
+    CHECK(rpc_call(&client, sum_id, RPC_CALL_TEXT, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_BAD_ARGS);
+    rpc_args_init(&args);
+    rpc_args_word(&args, "abcdefghi");
+    CHECK(rpc_call(&client, name_id, RPC_CALL_TEXT, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_BAD_ARGS);
+    rpc_args_init(&args);
+    CHECK(rpc_call(&client, 250, RPC_CALL_TEXT, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_BAD_COMMAND);
+
+    // Output larger than a frame is cut off and flagged
+    rpc_args_init(&args);
+    CHECK(rpc_call(&client, flood_id, RPC_CALL_TEXT, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_TRUNCATED);
+    CHECK(strncmp(response.text, "line 0\r\n", 8) == 0);
+    CHECK(rpc_call(&client, flood_id, 0, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_OK);
+    CHECK_EQ(response.text_length, 0);
+
+    // Round trip of the same query as a CALL
+    rpc_args_init(&args);
+    rpc_args_int(&args, 40);
+    rpc_args_int(&args, 2);
+    rx = wire->rx;
+    tx = wire->tx;
+    start = now_seconds();
+    for (int i = 0; i < QUERIES; i++) {
+        CHECK(rpc_call(&client, sum_id, 0, &args, &response) && response.status == RPC_STATUS_OK);
+    }
+    rpc_s = now_seconds() - start;
+    rpc_bytes = (wire->rx - rx + wire->tx - tx) / QUERIES;
+
+    // PROFILE returns id, runs, min, avg and max (uint32 each) per command that ran
+    profile_id = rpc_find_command(&client, "PROFILE");
+    rpc_args_init(&args);
+    CHECK(rpc_call(&client, profile_id, 0, &args, &response));
+    CHECK_EQ(response.status, RPC_STATUS_OK);
+    CHECK_EQ(response.result_length % 20, 0);
+    runs = 0;
+    for (int i = 0; i < response.result_length; i += 20) {
+        uint32_t entry[5];
+
+        memcpy(entry, response.result + i, sizeof(entry));
+        if ((int)entry[0] == sum_id) {
+            runs = entry[1];
+        }
+    }
+    CHECK(runs >= QUERIES);
+
+    // EXIT returns the console to text mode
+    CHECK(rpc_disconnect(&client));
+
+    // So do Ctrl-C and a bare CR outside a frame, and the idle timeout
+    CHECK(rpc_connect(&client));
+    CHECK(write(client.fd, "\x03", 1) == 1);
+    CHECK(text_query(client.fd, "QUERY SUM 1 1", "sum 2\r\n"));
+    CHECK(rpc_connect(&client));
+    CHECK(write(client.fd, "\r", 1) == 1);
+    CHECK(text_query(client.fd, "QUERY SUM 1 1", "sum 2\r\n"));
+    CHECK(rpc_connect(&client));
+    kill(board, SIGUSR1);
+    CHECK(text_query(client.fd, "QUERY SUM 1 1", "sum 2\r\n"));
+
+    // Round trip as a typed line with its echo and scraped reply
+    rx = wire->rx;
+    tx = wire->tx;
+    start = now_seconds();
+    for (int i = 0; i < QUERIES; i++) {
+        CHECK(text_query(client.fd, "QUERY SUM 40 2", "sum 42\r\n"));
+    }
+    text_s = now_seconds() - start;
+    text_bytes = (wire->rx - rx + wire->tx - tx) / QUERIES;
+
+    printf("pty round trip: text %.1f us, rpc %.1f us per query\n", text_s * 1e6 / QUERIES,
+           rpc_s * 1e6 / QUERIES);
+    printf("wire: text %lu bytes (%.1f ms), rpc %lu bytes (%.1f ms) per query at %d baud 8O1\n",
+           text_bytes, text_bytes * CONSOLE_BITS * 1e3 / CONSOLE_BAUD, rpc_bytes,
+           rpc_bytes * CONSOLE_BITS * 1e3 / CONSOLE_BAUD, CONSOLE_BAUD);
+
+    rpc_close(&client);
+    kill(board, SIGKILL);
+    waitpid(board, NULL, 0);
+    return test_report("test_rpc_pty");
+}
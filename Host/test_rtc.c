@@ -0,0 +1,134 @@
+/**
+ * @file test_rtc.c
+ * @brief Host test of the LSI calibration and the RTC prescaler and wakeup maths.
+ *
+ * Runs rtc.c on the register simulator. The timebase_us() stub advances
+ * simulated time by 1 us per call and, while TIM14 is set up to capture
+ * RTCCLK every eighth edge, latches the 48 MHz counter into CCR1 at each
+ * capture of a simulated LSI. For LSI rates across the 30..50 kHz range
+ * the test checks the measured rate, that the prescalers give 1 Hz from
+ * it, the subsecond scaling of rtc_ms() and the wakeup counts. It also
+ * checks the fallback to the nominal rate with no or an implausible clock.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "test.h"
+#include "../Src/rtc.c"
+
+#define TEST_TIMER_HZ 48000000U
+
+static double lsi_true;        // Simulated LSI in Hz, 0 for no clock
+static double sim_us;          // Simulated time
+static double next_capture_us; // Time of the next TIM14 capture
+
+uint32_t clock_timer_hz(void) {
+    return TEST_TIMER_HZ;
+}
+
+/**
+ * @brief Tells whether TIM14 is set up to capture every eighth RTCCLK edge.
+ */
+static int capture_armed(void) {
+    return (RCC->APB1ENR & RCC_APB1ENR_TIM14EN) && (TIM14->CR1 & TIM_CR1_CEN) &&
+           (TIM14->CCER & TIM_CCER_CC1E) && TIM14->OR == TIM14_OR_TI1_RMP_0 &&
+           (TIM14->CCMR1 & (TIM_CCMR1_CC1S_0 | TIM_CCMR1_IC1PSC)) == (TIM_CCMR1_CC1S_0 | TIM_CCMR1_IC1PSC);
+}
+
+uint32_t timebase_us(void) {
+    sim_us += 1.0;
+    if (lsi_true > 0 && capture_armed()) {
+        while (sim_us >= next_capture_us) {
+            TIM14->CCR1 = (uint32_t)(next_capture_us * (TEST_TIMER_HZ / 1000000U)) & 0xFFFFU;
+            TIM14->SR |= TIM_SR_CC1IF;
+            next_capture_us += 8e6 / lsi_true;
+        }
+    } else {
+        next_capture_us = sim_us + 37.5; // Arbitrary phase of the first edge
+    }
+    return (uint32_t)sim_us;
+}
+
+/**
+ * @brief Runs rtc_init() with the oscillator and RTC reporting ready.
+ *
+ * @param lsi Simulated LSI in Hz, 0 for no RTCCLK edges.
+ */
+static void init_with_lsi(double lsi) {
+    lsi_true = lsi;
+    RCC->CSR = RCC_CSR_LSIRDY;
+    RCC->BDCR = RCC_BDCR_RTCSEL_LSI;
+    RCC->APB1ENR = 0;
+    RTC->ISR = RTC_ISR_INITF | RTC_ISR_WUTWF;
+    rtc_init();
+    CHECK_EQ(RCC->APB1ENR & RCC_APB1ENR_TIM14EN, 0); // TIM14 released
+    CHECK_EQ(TIM14->CR1 & TIM_CR1_CEN, 0);
+}
+
+/**
+ * @brief Checks the calibration and everything derived from it for one LSI rate.
+ *
+ * @param lsi Simulated LSI in Hz.
+ */
+static void check_rate(double lsi) {
+    uint32_t async_div, sync_div_set, wutr;
+    double second;
+
+    init_with_lsi(lsi);
+    CHECK(rtc_lsi_hz() > lsi * 0.9999 - 1 && rtc_lsi_hz() < lsi * 1.0001 + 1);
+
+    // ck_apre near 1 kHz, ck_spre within 0.1 % of 1 Hz
+    async_div = ((RTC->PRER >> RTC_PRER_PREDIV_A_Pos) & 0x7FU) + 1U;
+    sync_div_set = (RTC->PRER & 0x7FFFU) + 1U;
+    CHECK(lsi / async_div > 900 && lsi / async_div < 1100);
+    second = async_div * (double)sync_div_set / lsi;
+    CHECK(second > 0.999 && second < 1.001);
+
+    // 01:02:03 and the subsecond counter at the start, middle and end of the second
+    RTC->TR = (1U << RTC_TR_HU_Pos) | (2U << RTC_TR_MNU_Pos) | (3U << RTC_TR_SU_Pos);
+    RTC->SSR = sync_div_set - 1U;
+    CHECK_EQ(rtc_ms(), 3723000U);
+    RTC->SSR = sync_div_set / 2U;
+    CHECK(rtc_ms() >= 3723498U && rtc_ms() <= 3723502U);
+    RTC->SSR = 0;
+    CHECK(rtc_ms() >= 3723998U && rtc_ms() <= 3723999U);
+
+    // Short wakeups count LSI/16 and are never late
+    rtc_wakeup_start(1000);
+    CHECK_EQ(RTC->CR & RTC_CR_WUCKSEL, 0);
+    wutr = RTC->WUTR + 1U;
+    CHECK(wutr * 16.0 / lsi > 0.997 && wutr * 16.0 / lsi <= 1.0);
+    rtc_wakeup_start(20000);
+    CHECK_EQ(RTC->CR & RTC_CR_WUCKSEL, 0);
+    CHECK(RTC->WUTR <= 0xFFFFU);
+    // Long ones count seconds of the calibrated ck_spre
+    rtc_wakeup_start(90500);
+    CHECK_EQ(RTC->CR & RTC_CR_WUCKSEL, RTC_CR_WUCKSEL_2);
+    CHECK_EQ(RTC->WUTR, 89);
+    rtc_wakeup_stop();
+}
+
+static void test_fallback(void) {
+    double start = sim_us;
+
+    // No RTCCLK edges: gives up after the timeout and keeps the nominal rate
+    init_with_lsi(0);
+    CHECK_EQ(rtc_lsi_hz(), RTC_LSI_HZ);
+    CHECK_EQ(RTC->PRER, (39U << RTC_PRER_PREDIV_A_Pos) | 999U);
+    CHECK(sim_us - start >= RTC_CAL_TIMEOUT_US);
+
+    // An implausible rate is rejected too
+    init_with_lsi(100000);
+    CHECK_EQ(rtc_lsi_hz(), RTC_LSI_HZ);
+}
+
+int main(void) {
+    check_rate(31000);
+    check_rate(32768);
+    check_rate(40000);
+    check_rate(47500);
+    check_rate(50000);
+    test_fallback();
+    return test_report("test_rtc");
+}
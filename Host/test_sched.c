@@ -0,0 +1,149 @@
+/**
+ * @file test_sched.c
+ * @brief Host test of the scheduler's periodic timers on the simulated tick.
+ *
+ * Runs sched.c with the real tick, timer wheel and event queue, and plays
+ * the event task of the main loop by handing every EVENT_TIMER to
+ * sched_timer_expired(). Checks exact callback counts over 1000 ms across
+ * tick wraparound, that a main loop stalled for 100 ms sees one expiry
+ * per timer and then resumes on schedule, and that an expiry posted
+ * before a stop and restart is ignored.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "test.h"
+#include "../Src/tick.c"
+#include "../Src/sched.c"
+
+static int calls[3];
+
+uint32_t clock_hclk_hz(void) {
+    return 48000000U;
+}
+
+void health_kick(void) {
+}
+
+void health_idle(void) {
+}
+
+void idle_wait(void) {
+}
+
+static void timer_a(void) {
+    calls[0]++;
+}
+
+static void timer_b(void) {
+    calls[1]++;
+}
+
+static void timer_c(void) {
+    calls[2]++;
+}
+
+/**
+ * @brief Event task of the main loop: runs every queued timer expiry.
+ */
+static void run_events(void) {
+    Event event;
+
+    while (event_get(&event)) {
+        if (event.type == EVENT_TIMER) {
+            sched_timer_expired(event.data);
+        }
+    }
+}
+
+/**
+ * @brief Runs the tick for a number of milliseconds.
+ *
+ * @param ms Ticks to run.
+ * @param main_loop 1 to run the event task after every tick, 0 to leave the events queued.
+ */
+static void run_ticks(uint32_t ms, int main_loop) {
+    for (uint32_t i = 0; i < ms; i++) {
+        SysTick_Handler();
+        if (main_loop) {
+            run_events();
+        }
+    }
+}
+
+/**
+ * @brief Stops every timer and clears the call counts.
+ */
+static void reset_timers(void) {
+    for (int i = 0; i < SCHED_MAX_TIMERS; i++) {
+        sched_timer_stop(i);
+    }
+    run_events();
+    calls[0] = calls[1] = calls[2] = 0;
+}
+
+static void test_counts_across_wrap(void) {
+    ticks = 0xFFFFFE00U; // Wraps 512 ticks in
+    timeout_tick(ticks);
+    CHECK_EQ(sched_timer_start(1, timer_a), 0);
+    CHECK_EQ(sched_timer_start(7, timer_b), 1);
+    CHECK_EQ(sched_timer_start(250, timer_c), 2);
+    run_ticks(1000, 1);
+    CHECK_EQ(calls[0], 1000);
+    CHECK_EQ(calls[1], 142);
+    CHECK_EQ(calls[2], 4);
+    CHECK_EQ(event_dropped(), 0);
+    reset_timers();
+}
+
+static void test_stall(void) {
+    CHECK_EQ(sched_timer_start(10, timer_a), 0);
+    CHECK_EQ(sched_timer_start(3, timer_b), 1);
+
+    // The main loop is stuck for 100 ms: one expiry each is queued, not 10 and 33
+    run_ticks(100, 0);
+    CHECK_EQ(event_pending(), 1);
+    run_events();
+    CHECK_EQ(calls[0], 1);
+    CHECK_EQ(calls[1], 1);
+
+    // Then the timers carry on from their original phase
+    run_ticks(100, 1);
+    CHECK_EQ(calls[0], 11);
+    CHECK_EQ(calls[1], 1 + 33);
+    CHECK_EQ(event_dropped(), 0);
+    reset_timers();
+}
+
+static void test_stale_expiry(void) {
+    CHECK_EQ(sched_timer_start(5, timer_a), 0);
+    run_ticks(5, 0); // Expiry posted, not yet handled
+    sched_timer_stop(0);
+    CHECK_EQ(sched_timer_start(20, timer_b), 0);
+
+    // The queued expiry belongs to the old timer and runs nothing
+    run_events();
+    CHECK_EQ(calls[0], 0);
+    CHECK_EQ(calls[1], 0);
+    run_ticks(19, 1);
+    CHECK_EQ(calls[1], 0);
+    run_ticks(1, 1);
+    CHECK_EQ(calls[1], 1);
+
+    // A stop with nothing restarted also discards the queued expiry
+    run_ticks(20, 0);
+    sched_timer_stop(0);
+    run_events();
+    CHECK_EQ(calls[1], 1);
+    run_ticks(100, 1);
+    CHECK_EQ(calls[1], 1);
+    reset_timers();
+}
+
+int main(void) {
+    test_counts_across_wrap();
+    test_stall();
+    test_stale_expiry();
+    return test_report("test_sched");
+}
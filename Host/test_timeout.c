@@ -0,0 +1,189 @@
+/**
+ * @file test_timeout.c
+ * @brief Randomized host test of the timer wheel against a reference model.
+ *
+ * Keeps a set of timeouts with random delays, from one tick to several
+ * times the wheel span, and randomly cancels, restarts and re-arms them
+ * from their own callbacks while the tick runs across wraparound. Most
+ * steps advance one tick; some jump ahead by up to 100 ticks, and a few
+ * by up to an hour, as after Stop mode. Each
+ * callback is checked against the model: it fired once, on its own tick
+ * when no tick was skipped and in the catch-up otherwise, and in expiry
+ * order. Every 64 steps the model also checks that nothing due is left
+ * and that timeout_next_expiry() names the earliest pending expiry.
+ *
+ *   test_timeout [steps]   default 1000000
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdlib.h>
+#include "test.h"
+#include "timeout.h"
+
+#define TEST_TIMEOUTS 64          /**< Timeouts in play */
+#define TEST_STEPS 1000000UL      /**< Default number of steps */
+#define TEST_START 0xFFF80000U    /**< First tick; wraps 524288 ticks in */
+#define TEST_SPAN (1UL << (TIMEOUT_LEVELS * TIMEOUT_WHEEL_BITS))
+#define TEST_STOP_MAX 3600000U    /**< Longest jump, an hour of Stop mode */
+
+// Reference state of one timeout
+typedef struct {
+    uint32_t expires;
+    int armed;
+} Model;
+
+static Timeout timeouts[TEST_TIMEOUTS];
+static Model model[TEST_TIMEOUTS];
+static uint32_t now = TEST_START;
+static uint32_t previous;          // Tick of the previous timeout_tick() call
+static uint32_t last_fired;        // Expiry of the previous callback in this call
+static unsigned long fired, exact;
+static uint32_t random_state = 0x6D2B79F5U;
+
+uint32_t tick_ms(void) {
+    return now;
+}
+
+/**
+ * @brief xorshift32 generator, so a run is reproducible.
+ *
+ * @param limit Exclusive upper bound.
+ * @return uint32_t Value in [0, limit).
+ */
+static uint32_t test_random(uint32_t limit) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state % limit;
+}
+
+/**
+ * @brief Picks a delay; mostly short, sometimes beyond the wheel span.
+ *
+ * @return uint32_t Delay in ticks, at least 1.
+ */
+static uint32_t random_delay(void) {
+    uint32_t kind = test_random(100);
+
+    if (kind < 60) {
+        return 1 + test_random(64);
+    } else if (kind < 85) {
+        return 65 + test_random(4096 - 64);
+    } else if (kind < 95) {
+        return 4097 + test_random(TEST_SPAN - 4096);
+    }
+    return TEST_SPAN + test_random(4 * TEST_SPAN);
+}
+
+static void timeout_fired(Timeout *timeout);
+
+/**
+ * @brief Starts a timeout in both the wheel and the model.
+ *
+ * @param i Timeout index.
+ */
+static void arm(int i) {
+    uint32_t delay = random_delay();
+
+    timeout_start(&timeouts[i], delay, timeout_fired);
+    model[i].expires = now + delay;
+    model[i].armed = 1;
+}
+
+/**
+ * @brief Callback: checks the expiry against the model and sometimes re-arms.
+ *
+ * @param timeout The timeout that fired.
+ */
+static void timeout_fired(Timeout *timeout) {
+    int i = (int)(timeout - timeouts);
+
+    CHECK(model[i].armed);
+    CHECK(!timeout_active(timeout));
+    // Due by now, and not yet due at the previous call
+    CHECK((int32_t)(now - model[i].expires) >= 0);
+    CHECK((int32_t)(model[i].expires - previous) > 0);
+    // Expiry order within one catch-up
+    CHECK((int32_t)(model[i].expires - last_fired) >= 0);
+    last_fired = model[i].expires;
+    model[i].armed = 0;
+    fired++;
+    if (model[i].expires == now) {
+        exact++;
+    }
+    if (test_random(4) == 0) {
+        arm(i);
+    }
+}
+
+/**
+ * @brief Checks that nothing due was left behind and the earliest expiry is right.
+ */
+static void check_wheel(void) {
+    uint32_t earliest = UINT32_MAX, next;
+    int pending = 0;
+
+    for (int i = 0; i < TEST_TIMEOUTS; i++) {
+        if (!model[i].armed) {
+            CHECK(!timeout_active(&timeouts[i]));
+            continue;
+        }
+        CHECK(timeout_active(&timeouts[i]));
+        CHECK((int32_t)(model[i].expires - now) > 0);
+        if (model[i].expires - now < earliest) {
+            earliest = model[i].expires - now;
+        }
+        pending = 1;
+    }
+    CHECK_EQ(timeout_next_expiry(&next), pending);
+    if (pending) {
+        CHECK_EQ(next, now + earliest);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long steps = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_STEPS;
+    int failures_seen = 0;
+    int wrapped = 0;
+    uint32_t advance;
+
+    for (unsigned long step = 0; step < steps; step++) {
+        int i = (int)test_random(TEST_TIMEOUTS);
+        uint32_t action = test_random(10);
+
+        if (!model[i].armed) {
+            arm(i);
+        } else if (action < 3) {
+            timeout_cancel(&timeouts[i]);
+            model[i].armed = 0;
+        } else if (action < 6) {
+            arm(i); // Restart while active
+        }
+
+        previous = now;
+        last_fired = now - TEST_SPAN * 8;
+        if (test_random(10000) == 0) {
+            advance = 2 + test_random(TEST_STOP_MAX);
+        } else if (test_random(100) == 0) {
+            advance = 2 + test_random(100);
+        } else {
+            advance = 1;
+        }
+        now += advance;
+        wrapped |= now < previous;
+        timeout_tick(now);
+        if ((step & 63) == 0) {
+            check_wheel();
+        }
+        if (test_failures != 0 && !failures_seen) {
+            failures_seen = 1;
+            fprintf(stderr, "first failure at step %lu, tick 0x%08lx\n", step, (unsigned long)now);
+        }
+    }
+    check_wheel();
+    CHECK(wrapped);
+    printf("%lu timeouts fired over %lu steps, %lu on their own tick\n", fired, steps, exact);
+    return test_report("test_timeout");
+}
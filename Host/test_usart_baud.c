@@ -0,0 +1,170 @@
+/**
+ * @file test_usart_baud.c
+ * @brief Host test of the USART2 baud rate and frame configuration.
+ *
+ * Checks the BRR value and the baud rate error of every self-test rate at
+ * the 8 MHz HSI and the 48 MHz PCLK kernel clocks, which rates the
+ * self-test accepts, and the console frame format USART2_Init() programs.
+ * Also checks that output USART2_WriteOrDrop() cannot queue is counted as
+ * a TX overflow, and runs USART2_SelfTest() through the simulator's HDSEL
+ * loopback: clean, with a parity error and with lost bytes. A lost byte
+ * is noticed when the next one arrives, or after four frame times at its
+ * rate when it is the last one.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "test.h"
+#include "../Src/usart.c"
+
+static uint32_t pclk_hz = 48000000U;
+static uint32_t now_us = 0; // Advances 1 us per timebase_us() call
+
+uint32_t clock_pclk_hz(void) {
+    return pclk_hz;
+}
+
+uint32_t timebase_us(void) {
+    return now_us++;
+}
+
+void idle_wait(void) {
+}
+
+void response_send(void) {
+}
+
+// Expected BRR and error (permille) per selftest_baud_rates[] entry
+typedef struct {
+    uint32_t brr;
+    uint32_t error_permille;
+    int supported;
+} BaudExpectation;
+
+static const BaudExpectation expected_8mhz[] = {
+    {6667, 0, 1}, {3333, 0, 1}, {1667, 0, 1}, {833, 0, 1}, {417, 0, 1}, {208, 1, 1},
+    {139, 0, 1}, {69, 6, 1}, {35, 7, 1}, {17, 21, 1}, {9, 35, 0},
+};
+static const BaudExpectation expected_48mhz[] = {
+    {40000, 0, 1}, {20000, 0, 1}, {10000, 0, 1}, {5000, 0, 1}, {2500, 0, 1}, {1250, 0, 1},
+    {833, 0, 1}, {417, 0, 1}, {208, 1, 1}, {104, 1, 1}, {52, 1, 1},
+};
+
+#define RATES (sizeof(selftest_baud_rates) / sizeof(selftest_baud_rates[0]))
+_Static_assert(sizeof(expected_8mhz) / sizeof(expected_8mhz[0]) == RATES, "one expectation per rate");
+_Static_assert(sizeof(expected_48mhz) / sizeof(expected_48mhz[0]) == RATES, "one expectation per rate");
+
+/**
+ * @brief Checks every self-test rate at one kernel clock.
+ */
+static void check_rates(uint32_t kernel_frequency, const BaudExpectation *expected) {
+    for (unsigned i = 0; i < RATES; i++) {
+        uint32_t baud = selftest_baud_rates[i];
+        uint32_t brr = USART_ComputeBRR(kernel_frequency, baud);
+        uint32_t error = USART_BaudErrorPermille(kernel_frequency, baud);
+        int supported = brr >= 16 && error <= SELFTEST_MAX_BAUD_ERROR_PERMILLE;
+
+        CHECK_EQ(brr, expected[i].brr);
+        CHECK_EQ(error, expected[i].error_permille);
+        CHECK_EQ(supported, expected[i].supported);
+    }
+}
+
+/**
+ * @brief Fills the TX buffer and checks which writes are dropped and counted.
+ */
+static void test_tx_drops(void) {
+    const uint8_t line[16] = "21.50 C\r\n";
+    uint32_t before = USART2_TxOverflowCount();
+
+    tx_head = tx_tail = 0;
+    while (USART2_TxSpace() >= (int)sizeof(line)) {
+        CHECK(USART2_WriteOrDrop(line, sizeof(line)));
+    }
+    CHECK_EQ(USART2_TxOverflowCount(), before);
+    // A line that does not fit is dropped whole and counted
+    CHECK(!USART2_WriteOrDrop(line, sizeof(line)));
+    CHECK_EQ(USART2_TxOverflowCount(), before + sizeof(line));
+    CHECK(USART2_TxSpace() > 0);
+    tx_head = tx_tail = 0;
+}
+
+/**
+ * @brief Runs the self-test and checks every rate but the faulty one is clean.
+ *
+ * @param faulty_rate Index into selftest_baud_rates[] expected to see one error, or -1.
+ * @return uint32_t Microseconds the self-test took.
+ */
+static uint32_t run_selftest(int faulty_rate) {
+    USART_SelfTestResult results[RATES];
+    uint32_t cr1 = USART2->CR1, cr3 = USART2->CR3, brr = USART2->BRR;
+    uint32_t start = now_us;
+    int count;
+
+    sim_usart2_frames = 0;
+    USART2->ISR = USART_ISR_TXE | USART_ISR_TC;
+    count = USART2_SelfTest(results, RATES);
+
+    // Every rate but 921600 baud is within reach of the 8 MHz HSI
+    CHECK_EQ(count, RATES - 1);
+    CHECK_EQ(sim_usart2_frames, (RATES - 1) * SELFTEST_PATTERN_LENGTH);
+    for (int i = 0; i < count; i++) {
+        CHECK_EQ(results[i].baud, selftest_baud_rates[i]);
+        CHECK_EQ(results[i].errors, i == faulty_rate ? 1 : 0);
+        CHECK(results[i].bytes_per_second > 0);
+    }
+    // Console configuration restored
+    CHECK_EQ(USART2->CR1, cr1);
+    CHECK_EQ(USART2->CR3, cr3);
+    CHECK_EQ(USART2->BRR, brr);
+    return now_us - start;
+}
+
+/**
+ * @brief Runs the self-test clean, with a parity error and with a lost byte.
+ */
+static void test_selftest(void) {
+    uint32_t clean, parity, lost;
+    // 11-bit frames at 4800 baud: 2292 us each
+    uint32_t timeout_us = SELFTEST_TIMEOUT_FRAMES * SELFTEST_FRAME_BITS * 1000000U / 4800U + 1;
+
+    clean = run_selftest(-1);
+
+    sim_usart2_parity_frame = 5 * SELFTEST_PATTERN_LENGTH + 7; // 38400 baud
+    parity = run_selftest(5);
+    sim_usart2_parity_frame = 0;
+    CHECK_EQ(parity, clean);
+
+    // A lost byte followed by another is noticed when the next one arrives
+    sim_usart2_drop_frame = 2 * SELFTEST_PATTERN_LENGTH + 100; // 4800 baud
+    lost = run_selftest(2);
+    CHECK(lost - clean < 16);
+
+    // The last byte at a rate is given up on after four frame times
+    sim_usart2_drop_frame = 3 * SELFTEST_PATTERN_LENGTH;
+    lost = run_selftest(2);
+    sim_usart2_drop_frame = 0;
+    CHECK(lost - clean > timeout_us);
+    CHECK(lost - clean < timeout_us + 16);
+}
+
+int main(void) {
+    check_rates(8000000U, expected_8mhz);
+    check_rates(48000000U, expected_48mhz);
+
+    // Console frame: 19200 baud from HSI, 8 data bits + odd parity, 1 stop bit
+    USART2_Init();
+    CHECK_EQ(USART2->BRR, 417);
+    CHECK_EQ(USART2->CR1 & USART_CR1_OVER8, 0);
+    CHECK_EQ(USART2->CR1 & (USART_CR1_M0 | USART_CR1_M1), USART_CR1_M0);
+    CHECK_EQ(USART2->CR1 & (USART_CR1_PCE | USART_CR1_PS), USART_CR1_PCE | USART_CR1_PS);
+    CHECK_EQ(USART2->CR2 & USART_CR2_STOP, 0);
+    CHECK_EQ(RCC->CFGR3 & RCC_CFGR3_USART2SW, RCC_CFGR3_USART2SW_HSI);
+    CHECK_EQ(USART2->CR3 & USART_CR3_WUS, USART_CR3_WUS);
+    CHECK(USART2->CR1 & USART_CR1_UESM);
+
+    test_tx_drops();
+    test_selftest();
+    return test_report("test_usart_baud");
+}
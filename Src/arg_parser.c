@@ -0,0 +1,314 @@
+/**
+ * @file arg_parser.c
+ * @brief Validation, conversion and usage text for declarative command arguments.
+ *
+ * Converts the tokens of a command line according to an ArgSpec array.
+ * Integers, hexadecimal values, fixed-point numbers and keywords are
+ * handled with plain integer arithmetic, so no floating point or heap is
+ * needed on the Cortex-M0.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+#include "arg_parser.h"
+
+/**
+ * @brief Parses a signed decimal number with an optional fractional part.
+ *
+ * The result is scaled by 10^decimals, so "1.5" with two decimals gives 150.
+ * Missing fractional digits are padded with zeros; more digits than
+ * `decimals` are rejected rather than silently truncated. The magnitude
+ * may reach 2^31 when negative, so INT32_MIN itself is accepted.
+ *
+ * @param text Token to parse.
+ * @param decimals Number of fractional digits to keep (0 for integers).
+ * @param value Pointer to store the scaled value.
+ * @return int Returns 1 on success, 0 on a syntax error or overflow.
+ */
+static int parse_decimal(const char *text, uint8_t decimals, int32_t *value) {
+    int negative = 0;
+    int digits = 0;
+    int fraction = -1; // Fractional digits seen, -1 before the decimal point
+    int64_t result = 0;
+    int64_t limit;
+
+    if (*text == '-' || *text == '+') {
+        negative = (*text == '-');
+        text++;
+    }
+    limit = (int64_t)((uint32_t)INT32_MAX + (uint32_t)negative);
+    for (; *text != '\0'; text++) {
+        if (*text == '.' && fraction < 0 && decimals > 0) {
+            fraction = 0;
+            continue;
+        }
+        if (!isdigit((unsigned char)*text)) {
+            return 0;
+        }
+        if (fraction >= 0 && ++fraction > decimals) {
+            return 0;
+        }
+        result = result * 10 + (*text - '0');
+        if (result > limit) {
+            return 0;
+        }
+        digits++;
+    }
+    if (digits == 0) {
+        return 0;
+    }
+    for (int i = (fraction < 0) ? 0 : fraction; i < decimals; i++) {
+        result *= 10;
+        if (result > limit) {
+            return 0;
+        }
+    }
+    *value = (int32_t)(negative ? -result : result);
+    return 1;
+}
+
+/**
+ * @brief Parses an unsigned 32-bit hexadecimal number, with optional 0x prefix.
+ *
+ * @param text Token to parse.
+ * @param value Pointer to store the value.
+ * @return int Returns 1 on success, 0 on a syntax error or overflow.
+ */
+static int parse_hex(const char *text, uint32_t *value) {
+    uint32_t result = 0;
+    int digits = 0;
+
+    if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text += 2;
+    }
+    for (; *text != '\0'; text++) {
+        int nibble;
+
+        if (*text >= '0' && *text <= '9') {
+            nibble = *text - '0';
+        } else if (*text >= 'a' && *text <= 'f') {
+            nibble = *text - 'a' + 10;
+        } else if (*text >= 'A' && *text <= 'F') {
+            nibble = *text - 'A' + 10;
+        } else {
+            return 0;
+        }
+        if (++digits > 8) {
+            return 0;
+        }
+        result = (result << 4) | (uint32_t)nibble;
+    }
+    if (digits == 0) {
+        return 0;
+    }
+    *value = result;
+    return 1;
+}
+
+/**
+ * @brief Formats a fixed-point value with its decimal point.
+ *
+ * @param text Output buffer.
+ * @param size Size of the output buffer.
+ * @param value Scaled value.
+ * @param decimals Number of fractional digits.
+ * @return int Length of the text, as returned by snprintf.
+ */
+static int format_fixed(char *text, int size, int32_t value, uint8_t decimals) {
+    uint32_t magnitude = (value < 0) ? (uint32_t)-(int64_t)value : (uint32_t)value;
+    uint32_t scale = 1;
+
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+    if (decimals == 0) {
+        return snprintf(text, size, "%s%lu", (value < 0) ? "-" : "", (unsigned long)magnitude);
+    }
+    return snprintf(text, size, "%s%lu.%0*lu", (value < 0) ? "-" : "", (unsigned long)(magnitude / scale),
+                    decimals, (unsigned long)(magnitude % scale));
+}
+
+/**
+ * @brief Prints a fixed-point value with its decimal point.
+ *
+ * @param value Scaled value.
+ * @param decimals Number of fractional digits.
+ */
+static void print_fixed(int32_t value, uint8_t decimals) {
+    char text[16];
+
+    format_fixed(text, sizeof(text), value, decimals);
+    printf("%s", text);
+}
+
+/**
+ * @brief Prints the expected form of one argument, e.g. "<count:1..100>".
+ *
+ * @param spec Argument specification.
+ * @param optional Non-zero to print it in square brackets.
+ */
+static void print_arg(const ArgSpec *spec, int optional) {
+    printf(optional ? " [%s" : " <%s", spec->name);
+    switch (spec->type) {
+    case ARG_TYPE_INT:
+    case ARG_TYPE_FIXED:
+        printf(":");
+        print_fixed(spec->min, spec->decimals);
+        printf("..");
+        print_fixed(spec->max, spec->decimals);
+        break;
+    case ARG_TYPE_HEX:
+        printf(":hex");
+        break;
+    case ARG_TYPE_ENUM:
+        for (int i = 0; spec->choices[i] != NULL; i++) {
+            printf("%c%s", (i == 0) ? ':' : '|', spec->choices[i]);
+        }
+        break;
+    case ARG_TYPE_WORD:
+        printf(":%ld chars max", (long)spec->max);
+        break;
+    }
+    printf(optional ? "]" : ">");
+}
+
+/**
+ * @brief Checks that an already converted value is acceptable for its argument.
+ *
+ * Used by arg_parse() after conversion, and by callers that receive
+ * values in binary form rather than as text.
+ *
+ * @param spec Argument specification.
+ * @param value Converted value.
+ * @return int Returns 1 if the value is in range, 0 otherwise.
+ */
+int arg_check(const ArgSpec *spec, const ArgValue *value) {
+    switch (spec->type) {
+    case ARG_TYPE_INT:
+    case ARG_TYPE_FIXED:
+        return value->fixed >= spec->min && value->fixed <= spec->max;
+    case ARG_TYPE_HEX:
+        return 1;
+    case ARG_TYPE_ENUM:
+        for (int c = 0; spec->choices[c] != NULL; c++) {
+            if (c == value->choice) {
+                return 1;
+            }
+        }
+        return 0;
+    case ARG_TYPE_WORD:
+        return value->length >= spec->min && value->length <= spec->max;
+    }
+    return 0;
+}
+
+/**
+ * @brief Formats a converted value back into the token a user would type.
+ *
+ * ARG_TYPE_WORD values carry no text, so they give an empty string.
+ *
+ * @param spec Argument specification.
+ * @param value Converted value, already checked with arg_check().
+ * @param text Output buffer.
+ * @param size Size of the output buffer.
+ * @return int Length of the token, or -1 if it does not fit.
+ */
+int arg_format(const ArgSpec *spec, const ArgValue *value, char *text, int size) {
+    int length = 0;
+
+    switch (spec->type) {
+    case ARG_TYPE_INT:
+    case ARG_TYPE_FIXED:
+        length = format_fixed(text, size, value->fixed, spec->decimals);
+        break;
+    case ARG_TYPE_HEX:
+        length = snprintf(text, size, "%lX", (unsigned long)value->u);
+        break;
+    case ARG_TYPE_ENUM:
+        length = snprintf(text, size, "%s", spec->choices[value->choice]);
+        break;
+    case ARG_TYPE_WORD:
+        length = snprintf(text, size, "%s", "");
+        break;
+    }
+    return (length < size) ? length : -1;
+}
+
+/**
+ * @brief Validates and converts command arguments in one pass.
+ *
+ * Prints a message naming the offending argument on failure.
+ *
+ * @param spec Argument specifications, in order.
+ * @param nspec Number of entries in spec.
+ * @param required Number of leading arguments that must be present.
+ * @param argc Number of argument tokens.
+ * @param argv Argument tokens.
+ * @param values Array of at least nspec entries receiving the converted values.
+ * @return int Returns 1 if every argument is valid, 0 otherwise.
+ */
+int arg_parse(const ArgSpec *spec, int nspec, int required, int argc, char *argv[], ArgValue *values) {
+    if (argc < required) {
+        printf("Missing argument <%s>\r\n", spec[argc].name);
+        return 0;
+    }
+    if (argc > nspec) {
+        printf("Unexpected argument '%.32s'\r\n", argv[nspec]);
+        return 0;
+    }
+
+    for (int i = 0; i < argc; i++) {
+        int ok = 0;
+
+        switch (spec[i].type) {
+        case ARG_TYPE_INT:
+        case ARG_TYPE_FIXED:
+            ok = parse_decimal(argv[i], spec[i].decimals, &values[i].fixed) && arg_check(&spec[i], &values[i]);
+            break;
+        case ARG_TYPE_HEX:
+            ok = parse_hex(argv[i], &values[i].u);
+            break;
+        case ARG_TYPE_ENUM:
+            for (int c = 0; spec[i].choices[c] != NULL; c++) {
+                if (strcasecmp(argv[i], spec[i].choices[c]) == 0) {
+                    values[i].choice = c;
+                    ok = 1;
+                    break;
+                }
+            }
+            break;
+        case ARG_TYPE_WORD:
+            values[i].length = (int32_t)strlen(argv[i]);
+            ok = arg_check(&spec[i], &values[i]);
+            break;
+        }
+        if (!ok) {
+            printf("Invalid %s '%.32s', expected", spec[i].name, argv[i]);
+            print_arg(&spec[i], 0);
+            printf("\r\n");
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Prints the usage line generated from a command's argument specification.
+ *
+ * @param command Command name.
+ * @param spec Argument specifications, may be NULL.
+ * @param nspec Number of entries in spec.
+ * @param required Number of mandatory arguments.
+ */
+void arg_print_usage(const char *command, const ArgSpec *spec, int nspec, int required) {
+    printf("%s", command);
+    for (int i = 0; i < nspec; i++) {
+        print_arg(&spec[i], i >= required);
+    }
+    printf("\r\n");
+}
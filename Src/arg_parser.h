@@ -0,0 +1,66 @@
+/**
+ * @file arg_parser.h
+ * @brief Declarative argument specifications for CLI commands.
+ *
+ * Each command can describe its arguments as an array of ArgSpec entries.
+ * The command processor validates and converts all arguments in one pass,
+ * without heap allocation, and hands typed ArgValue entries to the handler.
+ * The same specification is used to generate usage text.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef ARG_PARSER_H
+#define ARG_PARSER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Supported argument types.
+ */
+typedef enum {
+    ARG_TYPE_INT,   /**< Signed decimal integer, range-checked */
+    ARG_TYPE_HEX,   /**< Unsigned 32-bit hexadecimal, optional 0x prefix */
+    ARG_TYPE_FIXED, /**< Signed decimal with fractional digits, stored scaled */
+    ARG_TYPE_ENUM,  /**< One keyword out of a fixed list, stored as its index */
+    ARG_TYPE_WORD   /**< Any token up to max characters; use argv[] for the text */
+} ArgType;
+
+/**
+ * @brief Description of one command argument.
+ */
+typedef struct {
+    const char *name;           /**< Name shown in usage text */
+    ArgType type;               /**< How the token is converted */
+    uint8_t decimals;           /**< ARG_TYPE_FIXED: digits after the decimal point */
+    int32_t min;                /**< Smallest accepted value (scaled for fixed-point) */
+    int32_t max;                /**< Largest accepted value (scaled for fixed-point) */
+    const char *const *choices; /**< ARG_TYPE_ENUM: NULL-terminated keyword list */
+} ArgSpec;
+
+/**
+ * @brief Converted argument value handed to command handlers.
+ */
+typedef union {
+    int32_t i;      /**< ARG_TYPE_INT */
+    uint32_t u;     /**< ARG_TYPE_HEX */
+    int32_t fixed;  /**< ARG_TYPE_FIXED, scaled by 10^decimals */
+    int32_t choice; /**< ARG_TYPE_ENUM, index into choices */
+    int32_t length; /**< ARG_TYPE_WORD, length of the token */
+} ArgValue;
+
+// Argument specification builders
+#define ARG_INT(name, min, max) {name, ARG_TYPE_INT, 0, min, max, 0}
+#define ARG_HEX(name) {name, ARG_TYPE_HEX, 0, 0, 0, 0}
+#define ARG_FIXED(name, decimals, min, max) {name, ARG_TYPE_FIXED, decimals, min, max, 0}
+#define ARG_ENUM(name, choices) {name, ARG_TYPE_ENUM, 0, 0, 0, choices}
+#define ARG_WORD(name, max_length) {name, ARG_TYPE_WORD, 0, 1, max_length, 0}
+
+// Function Declarations
+int arg_parse(const ArgSpec *spec, int nspec, int required, int argc, char *argv[], ArgValue *values);
+int arg_check(const ArgSpec *spec, const ArgValue *value);
+int arg_format(const ArgSpec *spec, const ArgValue *value, char *text, int size);
+void arg_print_usage(const char *command, const ArgSpec *spec, int nspec, int required);
+
+#endif // ARG_PARSER_H
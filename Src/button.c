@@ -0,0 +1,125 @@
+/**
+ * @file button.c
+ * @brief EXTI-driven user button on PC13 with tick-based debounce.
+ *
+ * An edge on PC13 masks its EXTI line and starts a debounce timeout on the
+ * timer wheel. When it expires, the now settled level is sampled and the
+ * line re-armed, so contact bounce costs one interrupt per press or
+ * release. Presses are reported as events: EVENT_BUTTON_LONG as soon as
+ * the button has been held for BUTTON_LONG_MS (a second timeout),
+ * otherwise EVENT_BUTTON_SHORT on release. Nothing polls the pin.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "stm32f0xx.h"
+#include "button.h"
+#include "event.h"
+#include "tick.h"
+#include "timeout.h"
+#include "gpio.h"
+
+#define BUTTON_PORT GPIOC
+#define BUTTON_PIN 13
+// PC13 as an input; the Nucleo board has an external pull-up and the button pulls it low
+#define BUTTON_PINS(X) X(BUTTON_PIN, GPIO_MODE_INPUT, 0, GPIO_PUSH_PULL, GPIO_NO_PULL)
+#define BUTTON_EXTI (1U << BUTTON_PIN)
+
+static Timeout debounce;           // Runs while the level is settling after an edge
+static Timeout long_press;         // Runs while the button is held, until it counts as long
+static int pressed = 0;            // Debounced state
+static int long_sent = 0;          // EVENT_BUTTON_LONG already posted for this press
+static uint32_t press_start;
+
+static void button_settle(Timeout *timeout);
+
+/**
+ * @brief Returns the raw button level.
+ *
+ * @return int 1 while the button is pressed.
+ */
+static int button_level(void) {
+    return !gpio_read(BUTTON_PORT, BUTTON_PIN);
+}
+
+/**
+ * @brief Configures PC13 and EXTI line 13 for both edges.
+ */
+void button_init(void) {
+    RCC->AHBENR |= RCC_AHBENR_GPIOCEN;
+    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGCOMPEN;
+    GPIO_CONFIGURE(BUTTON_PORT, BUTTON_PINS);
+
+    // Route PC13 to EXTI line 13
+    SYSCFG->EXTICR[3] = (SYSCFG->EXTICR[3] & ~SYSCFG_EXTICR4_EXTI13) | SYSCFG_EXTICR4_EXTI13_PC;
+    EXTI->RTSR |= BUTTON_EXTI;
+    EXTI->FTSR |= BUTTON_EXTI;
+    EXTI->PR = BUTTON_EXTI;
+    EXTI->IMR |= BUTTON_EXTI;
+    // Same priority as SysTick, so the edge handler and timeouts never preempt each other
+    NVIC_SetPriority(EXTI4_15_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+    NVIC_EnableIRQ(EXTI4_15_IRQn);
+}
+
+/**
+ * @brief Starts a debounce period; the EXTI line stays masked until it ends.
+ *
+ * The idle manager wakes the MCU from Stop mode for the debounce and
+ * long-press timeouts, so the button needs no Stop hold.
+ */
+static void button_start_debounce(void) {
+    EXTI->IMR &= ~BUTTON_EXTI;
+    timeout_start(&debounce, BUTTON_DEBOUNCE_MS, button_settle);
+}
+
+/**
+ * @brief Long-press timeout: the button has been held for BUTTON_LONG_MS.
+ *
+ * @param timeout The long-press timeout (not used).
+ */
+static void button_long(Timeout *timeout) {
+    long_sent = 1;
+    event_post(EVENT_BUTTON_LONG, tick_ms() - press_start);
+}
+
+/**
+ * @brief Debounce timeout: takes the settled level and re-arms the line.
+ *
+ * @param timeout The debounce timeout (not used).
+ */
+static void button_settle(Timeout *timeout) {
+    int level = button_level();
+
+    if (level && !pressed) {
+        pressed = 1;
+        long_sent = 0;
+        press_start = tick_ms();
+        timeout_start(&long_press, BUTTON_LONG_MS, button_long);
+    } else if (!level && pressed) {
+        pressed = 0;
+        timeout_cancel(&long_press);
+        if (!long_sent) {
+            event_post(EVENT_BUTTON_SHORT, tick_ms() - press_start);
+        }
+    }
+
+    EXTI->PR = BUTTON_EXTI;
+    EXTI->IMR |= BUTTON_EXTI;
+    // An edge during the masked period raised no interrupt; catch it here
+    if (button_level() != pressed) {
+        button_start_debounce();
+    }
+}
+
+/**
+ * @brief EXTI lines 4..15 interrupt: an edge on the button starts a debounce.
+ */
+void EXTI4_15_IRQHandler(void) {
+    if (EXTI->PR & BUTTON_EXTI) {
+        EXTI->PR = BUTTON_EXTI;
+        if (!timeout_active(&debounce)) {
+            button_start_debounce();
+        }
+    }
+}
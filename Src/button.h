@@ -0,0 +1,21 @@
+/**
+ * @file button.h
+ * @brief Header file for the debounced user button on PC13.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include <stdint.h>
+
+#define BUTTON_DEBOUNCE_MS 20  /**< Time the level must settle after an edge */
+#define BUTTON_LONG_MS 1000    /**< Hold time that makes a press long */
+
+// Function Declarations
+void button_init(void);
+void EXTI4_15_IRQHandler(void);
+
+#endif // BUTTON_H
@@ -55,3 +55,17 @@ int cbfifo_dequeue(uint8_t *buffer, volatile int *head, volatile int *tail, uint
     *tail = (*tail + 1) % MAX_BUFFER_SIZE;
     return 1;
 }
+
+/**
+ * @brief Returns the number of free slots in a circular buffer.
+ *
+ * One slot is always kept empty to tell a full buffer from an empty one.
+ *
+ * @param head Pointer to the head index of the buffer.
+ * @param tail Pointer to the tail index of the buffer.
+ * @return int Number of bytes that can be enqueued without failing.
+ */
+int cbfifo_free(volatile int *head, volatile int *tail) {
+    int used = (*head - *tail + MAX_BUFFER_SIZE) % MAX_BUFFER_SIZE;
+    return MAX_BUFFER_SIZE - 1 - used;
+}
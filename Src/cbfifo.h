@@ -38,4 +38,13 @@ int cbfifo_enqueue(uint8_t *buffer, volatile int *head, volatile int *tail, uint
  */
 int cbfifo_dequeue(uint8_t *buffer, volatile int *head, volatile int *tail, uint8_t *data);
 
+/**
+ * @brief Returns the number of free slots in a circular buffer.
+ *
+ * @param head Pointer to the head index of the buffer.
+ * @param tail Pointer to the tail index of the buffer.
+ * @return int Number of bytes that can be enqueued without failing.
+ */
+int cbfifo_free(volatile int *head, volatile int *tail);
+
 #endif // CBFIFO_H
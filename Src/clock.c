@@ -0,0 +1,184 @@
+/**
+ * @file clock.c
+ * @brief Brings the STM32F091 up to 48 MHz and reports the real clock tree.
+ *
+ * SYSCLK runs at 48 MHz, either straight from HSI48 or from the PLL fed by
+ * HSI/2, with AHB and APB undivided. At 48 MHz the flash needs one wait
+ * state, and the prefetch buffer hides most of it for straight-line code;
+ * both are set before the switch, since running from flash at 48 MHz with
+ * zero wait states would fetch garbage.
+ *
+ * Drivers ask for the frequencies here instead of assuming them. The
+ * values are decoded from the RCC registers, so they stay correct when
+ * the setup changes, and also during the short time after a Stop mode
+ * wakeup when the core still runs on HSI.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include "stm32f0xx.h"
+#include "clock.h"
+#include "rpc.h"
+#include "command_processor.h"
+
+_Static_assert(CLOCK_SYSCLK_HZ == 48000000U, "clock_init() only knows the 48 MHz setup");
+
+/**
+ * @brief Starts the configured oscillator (and PLL) and switches SYSCLK to it.
+ *
+ * Used at startup and after every Stop mode wakeup, which leaves the core
+ * on HSI with HSI48 and the PLL turned off.
+ */
+static void clock_switch(void) {
+#if CLOCK_USE_PLL
+    if ((RCC->CR & RCC_CR_PLLON) == 0) {
+        // HSI/2 x 12 = 48 MHz; PLLSRC and PLLMUL may only change with the PLL off
+        RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_PLLSRC | RCC_CFGR_PLLMUL)) | RCC_CFGR_PLLSRC_HSI_DIV2 |
+                    RCC_CFGR_PLLMUL12;
+        RCC->CR |= RCC_CR_PLLON;
+    }
+    while ((RCC->CR & RCC_CR_PLLRDY) == 0);
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_PLL;
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL);
+#else
+    RCC->CR2 |= RCC_CR2_HSI48ON;
+    while ((RCC->CR2 & RCC_CR2_HSI48RDY) == 0);
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_HSI48;
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_HSI48);
+#endif
+}
+
+/**
+ * @brief Sets up flash timing and switches the system to 48 MHz.
+ *
+ * Call first in main(), before any driver derives a divider from the clocks.
+ */
+void clock_init(void) {
+    // One wait state and prefetch before the clock goes above 24 MHz
+    FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | FLASH_ACR_LATENCY | FLASH_ACR_PRFTBE;
+    while ((FLASH->ACR & FLASH_ACR_LATENCY) == 0);
+
+    // AHB and APB undivided: HCLK = PCLK = SYSCLK
+    RCC->CFGR &= ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE);
+    clock_switch();
+    SystemCoreClockUpdate();
+}
+
+/**
+ * @brief Restores the 48 MHz SYSCLK after a Stop mode wakeup.
+ *
+ * Stop mode turns off the PLL and HSI48, and the core always wakes up on
+ * HSI; the flash and bus prescaler settings survive.
+ */
+void clock_restore(void) {
+    clock_switch();
+}
+
+/**
+ * @brief Returns the current SYSCLK frequency, decoded from RCC.
+ *
+ * @return uint32_t SYSCLK in Hz.
+ */
+uint32_t clock_sysclk_hz(void) {
+    uint32_t cfgr = RCC->CFGR;
+    uint32_t multiplier;
+    uint32_t input;
+
+    switch (cfgr & RCC_CFGR_SWS) {
+    case RCC_CFGR_SWS_HSI48:
+        return CLOCK_HSI48_HZ;
+    case RCC_CFGR_SWS_HSE:
+        return HSE_VALUE;
+    case RCC_CFGR_SWS_PLL:
+        multiplier = ((cfgr & RCC_CFGR_PLLMUL) >> RCC_CFGR_PLLMUL_Pos) + 2U;
+        if (multiplier > 16U) {
+            multiplier = 16U; // PLLMUL 1111 is x16, like 1110
+        }
+        switch (cfgr & RCC_CFGR_PLLSRC) {
+        case RCC_CFGR_PLLSRC_HSI_DIV2:
+            return CLOCK_HSI_HZ / 2U * multiplier;
+        case RCC_CFGR_PLLSRC_HSI48_PREDIV:
+            input = CLOCK_HSI48_HZ;
+            break;
+        case RCC_CFGR_PLLSRC_HSE_PREDIV:
+            input = HSE_VALUE;
+            break;
+        default:
+            input = CLOCK_HSI_HZ;
+            break;
+        }
+        return input / ((RCC->CFGR2 & RCC_CFGR2_PREDIV) + 1U) * multiplier;
+    default:
+        return CLOCK_HSI_HZ;
+    }
+}
+
+/**
+ * @brief Returns the current AHB clock (core, SysTick, DMA).
+ *
+ * @return uint32_t HCLK in Hz.
+ */
+uint32_t clock_hclk_hz(void) {
+    uint32_t hpre = (RCC->CFGR & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos;
+    // HPRE 0xxx: /1; 1000..1111: /2, /4, /8, /16, /64, /128, /256, /512
+    static const uint8_t shifts[8] = {1, 2, 3, 4, 6, 7, 8, 9};
+
+    return (hpre < 8U) ? clock_sysclk_hz() : clock_sysclk_hz() >> shifts[hpre - 8U];
+}
+
+/**
+ * @brief Returns the current APB clock (USART, I2C and timer registers).
+ *
+ * @return uint32_t PCLK in Hz.
+ */
+uint32_t clock_pclk_hz(void) {
+    uint32_t ppre = (RCC->CFGR & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos;
+
+    // PPRE 0xx: /1; 100..111: /2, /4, /8, /16
+    return (ppre < 4U) ? clock_hclk_hz() : clock_hclk_hz() >> (ppre - 3U);
+}
+
+/**
+ * @brief Returns the clock of the APB timers (TIM2, TIM6, ...).
+ *
+ * The timers run at twice PCLK whenever the APB prescaler divides.
+ *
+ * @return uint32_t Timer kernel clock in Hz.
+ */
+uint32_t clock_timer_hz(void) {
+    uint32_t ppre = (RCC->CFGR & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos;
+
+    return (ppre < 4U) ? clock_pclk_hz() : clock_pclk_hz() * 2U;
+}
+
+/**
+ * @brief Handler for the "CLOCK" command.
+ *
+ * Prints the clock tree as the drivers see it.
+ *
+ * RPC result: uint32 SYSCLK, HCLK, PCLK and timer clock in Hz, the
+ * SYSCLK source (0 HSI, 1 HSE, 2 PLL, 3 HSI48), the flash wait states
+ * and 1 if the prefetch buffer is on.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void clock_command(int argc, char *argv[], const ArgValue *args) {
+    static const char *const sources[] = {"HSI", "HSE", "PLL", "HSI48"};
+    uint32_t result[7] = {
+        clock_sysclk_hz(), clock_hclk_hz(), clock_pclk_hz(), clock_timer_hz(),
+        (RCC->CFGR & RCC_CFGR_SWS) >> 2, FLASH->ACR & FLASH_ACR_LATENCY, (FLASH->ACR & FLASH_ACR_PRFTBE) ? 1U : 0U,
+    };
+
+    rpc_result(result, sizeof(result));
+    printf("SYSCLK %lu Hz from %s, HCLK %lu Hz, PCLK %lu Hz, timers %lu Hz\r\n",
+           (unsigned long)clock_sysclk_hz(), sources[(RCC->CFGR & RCC_CFGR_SWS) >> 2],
+           (unsigned long)clock_hclk_hz(), (unsigned long)clock_pclk_hz(), (unsigned long)clock_timer_hz());
+    printf("Flash: %lu wait state(s), prefetch %s\r\n", (unsigned long)(FLASH->ACR & FLASH_ACR_LATENCY),
+           (FLASH->ACR & FLASH_ACR_PRFTBE) ? "on" : "off");
+}
+
+REGISTER_COMMAND(clock, "CLOCK", clock_command);
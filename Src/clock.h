@@ -0,0 +1,27 @@
+/**
+ * @file clock.h
+ * @brief Header file for the system clock tree setup.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+#define CLOCK_USE_PLL 0            /**< 1: SYSCLK from the PLL (HSI/2 x 12); 0: straight from HSI48 */
+#define CLOCK_HSI_HZ 8000000U      /**< HSI, also the kernel clock of USART2 (Stop mode) and I2C1 */
+#define CLOCK_HSI48_HZ 48000000U   /**< HSI48 oscillator */
+#define CLOCK_SYSCLK_HZ 48000000U  /**< Target SYSCLK; HCLK and PCLK run undivided */
+
+// Function Declarations
+void clock_init(void);
+void clock_restore(void);
+uint32_t clock_sysclk_hz(void);
+uint32_t clock_hclk_hz(void);
+uint32_t clock_pclk_hz(void);
+uint32_t clock_timer_hz(void);
+
+#endif // CLOCK_H
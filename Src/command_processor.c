@@ -4,7 +4,8 @@
  *
  * This file implements the core command processing logic, including
  * functions for recognizing commands and executing corresponding handlers.
- * The module currently supports commands like "echo", "LED ON", "LED OFF", and "hexdump".
+ * Commands are registered by the modules that implement them and collected
+ * from the "command_table" linker section into a sorted dispatch index.
  *
  * @date 13 November 2024
  * @author Lokesh Senthil Kumar
@@ -13,80 +14,538 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <string.h>
+#include <strings.h>
 #include "command_processor.h"
-#include "led.h"
+#include "arg_parser.h"
+#include "macro.h"
+#include "timebase.h"
+#include "response.h"
+#include "rpc.h"
 
-#define MAX_BUFFER_SIZE 128
+#ifndef MAX_COMMANDS
+#define MAX_COMMANDS 64 /**< Capacity of the sorted dispatch index */
+#endif
+#define MAX_LINE 128    /**< Longest line accepted for completion */
+#define TIME_PREFIX "TIME" /**< Leading word that reports the cost of one command */
 
-// Structure for storing command name and handler function
+// Bounds of the "command_table" section, provided by the linker
+extern const Command __start_command_table[];
+extern const Command __stop_command_table[];
+
+// Dispatch index: every registered command, sorted in strcasecmp() order
+static const Command *command_index[MAX_COMMANDS];
+static int command_count = 0;
+static uint32_t index_signature = 0; // Hash of all names in index order
+
+// Execution time of each command, indexed like command_index
 typedef struct {
-    const char *command;
-    void (*handler)(const char *input);
-} Command;
-
-// Command table containing supported commands and their handlers
-const Command command_table[] = {
-    {"LED ON", led_on_command},
-    {"LED OFF", led_off_command},
-    {NULL, NULL}  // End of table marker
-};
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+} CommandStats;
+
+static CommandStats command_stats[MAX_COMMANDS];
+static uint32_t last_elapsed_us = 0; // Duration of the most recent command_execute()
+
+static void help_command(int argc, char *argv[], const ArgValue *args);
+REGISTER_COMMAND(help, "HELP", help_command);
+
+/**
+ * @brief Builds the sorted dispatch index from the registered commands.
+ *
+ * Insertion sort by name; the section only holds a few dozen entries and
+ * this runs once at startup. Names that are a word-prefix of another name
+ * would make the binary search ambiguous, so they are reported here.
+ */
+void command_processor_init(void) {
+    command_count = 0;
+    for (const Command *command = __start_command_table; command < __stop_command_table; command++) {
+        int i;
+
+        if (command_count == MAX_COMMANDS) {
+            printf("Too many commands, %s not registered\r\n", command->command);
+            continue;
+        }
+        for (i = command_count; i > 0 && strcasecmp(command_index[i - 1]->command, command->command) > 0; i--) {
+            command_index[i] = command_index[i - 1];
+        }
+        command_index[i] = command;
+        command_count++;
+    }
+
+    // FNV-1a over the sorted names; changes whenever the command set does
+    index_signature = 2166136261U;
+    for (int i = 0; i < command_count; i++) {
+        for (const char *c = command_index[i]->command; ; c++) {
+            index_signature = (index_signature ^ (uint8_t)*c) * 16777619U;
+            if (*c == '\0') {
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i + 1 < command_count; i++) {
+        const Command *shorter = command_index[i];
+        const Command *longer = command_index[i + 1];
+
+        if (strncasecmp(shorter->command, longer->command, shorter->length) == 0 &&
+            (longer->command[shorter->length] == ' ' || longer->command[shorter->length] == '\0')) {
+            printf("Command %s conflicts with %s\r\n", shorter->command, longer->command);
+        }
+    }
+}
+
+/**
+ * @brief Splits a line into whitespace-separated tokens in place.
+ *
+ * The first whitespace character after each token is overwritten with '\0'
+ * and argv[] points into the line itself, so nothing is copied.
+ *
+ * @param line The line to tokenize; modified in place.
+ * @param argv Array receiving pointers to the tokens.
+ * @param max_args Capacity of argv.
+ * @return int Number of tokens, or -1 if there are more than max_args.
+ */
+static int tokenize(char *line, char *argv[], int max_args) {
+    int argc = 0;
+
+    while (*line != '\0') {
+        // Skip leading whitespace
+        while (isspace((unsigned char)*line)) {
+            line++;
+        }
+        if (*line == '\0') {
+            break;
+        }
+        if (argc == max_args) {
+            return -1;
+        }
+        argv[argc++] = line;
+        // Find the end of the token and terminate it
+        while (*line != '\0' && !isspace((unsigned char)*line)) {
+            line++;
+        }
+        if (*line != '\0') {
+            *line++ = '\0';
+        }
+    }
+    return argc;
+}
+
+/**
+ * @brief Compares the leading tokens of a line with a command name.
+ *
+ * Every word of the name must equal the corresponding token exactly
+ * (case-insensitive), so "LED ONXYZ" does not match "LED ON". The result
+ * orders consistently with the strcasecmp() order of command_index.
+ *
+ * @param argc Number of tokens.
+ * @param argv The tokens.
+ * @param command The table entry to compare against.
+ * @param words Set to the number of words in the name on a match.
+ * @return int 0 on a match, <0 if the tokens sort before the name, >0 after.
+ */
+static int compare_command(int argc, char *argv[], const Command *command, int *words) {
+    const char *name = command->command;
+
+    for (int i = 0; ; i++) {
+        const char *token;
+
+        if (i == argc) {
+            return -1; // Line ran out of tokens before the name did
+        }
+        token = argv[i];
+        while (*token != '\0' && *name != '\0' && *name != ' ') {
+            int diff = tolower((unsigned char)*token) - tolower((unsigned char)*name);
+            if (diff != 0) {
+                return diff;
+            }
+            token++;
+            name++;
+        }
+        if (*token != '\0') {
+            return 1; // Token is longer than this word of the name
+        }
+        if (*name == ' ') {
+            name++; // Word matched, move on to the next one
+        } else if (*name == '\0') {
+            *words = i + 1;
+            return 0;
+        } else {
+            return -1; // Word of the name is longer than the token
+        }
+    }
+}
+
+/**
+ * @brief Looks up the command named by the leading tokens of a line.
+ *
+ * Binary search over the sorted command_index, so dispatch is O(log n).
+ * The position found is also the command's id, which command_execute()
+ * uses to find its statistics without searching again.
+ *
+ * @param argc Number of tokens.
+ * @param argv The tokens.
+ * @param words Set to the number of tokens consumed by the command name.
+ * @return int Id of the matching command, or -1 if there is none.
+ */
+static int find_command(int argc, char *argv[], int *words) {
+    int low = 0;
+    int high = command_count - 1;
+
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        int cmp = compare_command(argc, argv, command_index[mid], words);
+
+        if (cmp == 0) {
+            return mid;
+        } else if (cmp < 0) {
+            high = mid - 1;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return -1;
+}
 
 /**
- * @brief Processes the user input command by trimming extra spaces and tokenizing the input.
+ * @brief Returns the command with a given id.
  *
- * This function first removes any extra spaces from the input string,
- * tokenizes it to get the main command, and then checks against the command table.
+ * Ids are positions in the dispatch index. They are stable for a given
+ * firmware build; command_signature() tells whether ids recorded earlier
+ * still refer to the same commands.
  *
- * @param input The raw user input string.
+ * @param id Position in the dispatch index.
+ * @return const Command* The command, or NULL if the id is out of range.
  */
-void process_command(const char *input) {
-
-	//Tokenization for removing extra spaces
-    const char *message = input;
-	char output[MAX_BUFFER_SIZE] = {0};
-	int out_index = 0;
-	int in_word = 0;
-
-	// preserve word boundaries
-	for (int i = 0; message[i] != '\0'; i++) {
-		if (!isspace((unsigned char)message[i])) {
-			output[out_index++] = message[i];
-			in_word = 1;
-		} else if (in_word) {
-			output[out_index++] = ' ';
-			in_word = 0;
-		}
-	}
-
-	// Remove trailing space if present
-	if (out_index > 0 && output[out_index - 1] == ' ') {
-		output[out_index - 1] = '\0';
-	} else {
-		output[out_index] = '\0';
-	}
-
-    for (int i = 0; command_table[i].command != NULL; i++) {
-        // Compare input string with each command in the table (case-insensitive)
-        if (strncasecmp(output, command_table[i].command, strlen(command_table[i].command)) == 0) {
-            command_table[i].handler(output);
+const Command *command_by_id(int id) {
+    return (id >= 0 && id < command_count) ? command_index[id] : NULL;
+}
+
+/**
+ * @brief Returns a hash identifying the current set of command names.
+ *
+ * @return uint32_t FNV-1a hash of all names in index order.
+ */
+uint32_t command_signature(void) {
+    return index_signature;
+}
+
+/**
+ * @brief Runs a command handler with already converted arguments.
+ *
+ * Used by process_command() and by replay of pre-tokenized macros, which
+ * skip tokenizing, lookup and argument conversion. The handler's output is
+ * collected in the response arena and queued in one block at the end.
+ * Every run is timed from dispatch until that output has been queued, and
+ * the result is added to the command's statistics.
+ *
+ * @param id Id of the command to run, from the lookup or a stored record.
+ * @param argc Number of arguments.
+ * @param argv Argument tokens.
+ * @param args Converted arguments.
+ */
+void command_execute(int id, int argc, char *argv[], const ArgValue *args) {
+    const Command *command = command_by_id(id);
+    CommandStats *stats;
+    uint32_t start = timebase_us();
+    uint32_t elapsed;
+
+    if (command == NULL) {
+        return;
+    }
+    stats = &command_stats[id];
+    response_begin();
+    command->handler(argc, argv, args);
+    fflush(stdout);
+    response_commit();
+    elapsed = timebase_us() - start;
+    last_elapsed_us = elapsed;
+
+    if (stats->count == 0 || elapsed < stats->min_us) {
+        stats->min_us = elapsed;
+    }
+    if (elapsed > stats->max_us) {
+        stats->max_us = elapsed;
+    }
+    stats->total_us += elapsed;
+    stats->count++;
+}
+
+/**
+ * @brief Processes a single command (one segment of a line).
+ *
+ * The text is tokenized in place and the leading tokens are matched
+ * against the command table. The tokens that follow the command name are
+ * validated and converted against its argument specification, and the
+ * handler receives both the raw tokens and the typed values. A leading
+ * "TIME" runs the rest of the line as usual and then prints its cost.
+ *
+ * @param line The command text; modified in place.
+ */
+static void execute_line(char *line) {
+    char *argv_buffer[MAX_ARGS];
+    char **argv = argv_buffer;
+    int argc = tokenize(line, argv, MAX_ARGS);
+    int words = 0;
+    int timed = 0;
+    int id;
+
+    if (argc < 0) {
+        printf("Too many arguments (max %d)\r\n", MAX_ARGS);
+        return;
+    }
+    if (argc == 0) {
+        return;
+    }
+    if (argc > 1 && strcasecmp(argv[0], TIME_PREFIX) == 0) {
+        timed = 1;
+        argv++;
+        argc--;
+    }
+
+    id = find_command(argc, argv, &words);
+    if (id >= 0) {
+        const Command *command = command_index[id];
+        ArgValue values[MAX_ARGS];
+        char **args = argv + words;
+
+        argc -= words;
+        if (!arg_parse(command->args, command->nargs, command->required, argc, args, values)) {
+            printf("Usage: ");
+            arg_print_usage(command->command, command->args, command->nargs, command->required);
             return;
         }
+        macro_record_command(id, argc, args, values);
+        command_execute(id, argc, args, values);
+        if (timed) {
+            printf("%s: %lu us\r\n", command->command, (unsigned long)last_elapsed_us);
+        }
+        return;
     }
-    // Print error if the command is unknown
-    printf("Unknown command(%s)\r\n", output);
+    // Print error if the command is unknown; echo at most a short prefix of
+    // the token so binary garbage on the line cannot flood the console
+    printf("Unknown command(%.32s)\r\n", argv[0]);
 }
 
-void led_on_command(const char *input) {
-    LED_On();
+/**
+ * @brief Processes a line of user input.
+ *
+ * A line may hold several commands separated by ';'; they are run in
+ * order, each one tokenized in place.
+ *
+ * @param line The raw user input; modified in place.
+ */
+void process_command(char *line) {
+    while (line != NULL) {
+        char *next = strchr(line, ';');
+
+        if (next != NULL) {
+            *next++ = '\0';
+        }
+        execute_line(line);
+        line = next;
+    }
 }
 
 /**
- * @brief Handler for the "LED OFF" command.
+ * @brief Completes a partial word against a set of candidates.
  *
- * This function turns off the LED by calling the `LED_Off` function.
+ * Extends the partial word to the longest prefix shared by all candidates.
+ * A unique candidate is completed in full and followed by a space. If the
+ * candidates cannot be narrowed any further they are listed instead.
  *
- * @param input The user input string (not used in this handler).
+ * @param partial_length Length of the partial word already typed.
+ * @param candidates Matching candidates, all starting with the partial word.
+ * @param count Number of candidates.
+ * @param insert Buffer receiving the characters to append.
+ * @param max_insert Capacity of insert.
+ * @return int Number of characters to append, or -1 if the candidates were listed.
  */
-void led_off_command(const char *input) {
-    LED_Off();
+static int complete_candidates(int partial_length, const char *candidates[], int count,
+                               char *insert, int max_insert) {
+    int common = (int)strlen(candidates[0]);
+    int n = 0;
+
+    for (int i = 1; i < count; i++) {
+        int j = partial_length;
+        while (j < common && tolower((unsigned char)candidates[i][j]) ==
+                             tolower((unsigned char)candidates[0][j])) {
+            j++;
+        }
+        common = j;
+    }
+
+    if (count > 1 && common == partial_length) {
+        printf("\r\n");
+        for (int i = 0; i < count; i++) {
+            printf("%s  ", candidates[i]);
+        }
+        printf("\r\n");
+        fflush(stdout);
+        return -1;
+    }
+
+    for (int i = partial_length; i < common && n < max_insert; i++) {
+        insert[n++] = candidates[0][i];
+    }
+    if (count == 1 && n < max_insert) {
+        insert[n++] = ' ';
+    }
+    return n;
 }
+
+/**
+ * @brief Completes the keyword argument being typed after a command name.
+ *
+ * @param text Normalized line (single spaces, no leading whitespace).
+ * @param insert Buffer receiving the characters to append.
+ * @param max_insert Capacity of insert.
+ * @return int Number of characters to append, or -1 if candidates were listed.
+ */
+static int complete_argument(const char *text, char *insert, int max_insert) {
+    char tokens[MAX_LINE];
+    char *argv[MAX_ARGS];
+    const char *candidates[MAX_ARGS];
+    const char *partial;
+    const Command *command;
+    int argc, words = 0, arg, count = 0, id;
+    int length = (int)strlen(text);
+    int new_word = (length > 0 && text[length - 1] == ' ');
+
+    memcpy(tokens, text, length + 1);
+    argc = tokenize(tokens, argv, MAX_ARGS);
+    if (argc <= 0 || (id = find_command(argc, argv, &words)) < 0) {
+        return 0;
+    }
+    command = command_index[id];
+
+    // Index of the argument under the cursor, and what has been typed of it
+    arg = argc - words - (new_word ? 0 : 1);
+    if (arg < 0 || arg >= command->nargs || command->args[arg].type != ARG_TYPE_ENUM) {
+        return 0;
+    }
+    partial = new_word ? "" : argv[argc - 1];
+
+    for (int i = 0; command->args[arg].choices[i] != NULL && count < MAX_ARGS; i++) {
+        if (strncasecmp(command->args[arg].choices[i], partial, strlen(partial)) == 0) {
+            candidates[count++] = command->args[arg].choices[i];
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+    return complete_candidates((int)strlen(partial), candidates, count, insert, max_insert);
+}
+
+/**
+ * @brief Computes the tab completion for a partially typed line.
+ *
+ * Command names are completed by a prefix search on the sorted dispatch
+ * index: the matches form one contiguous run, found by binary search.
+ * Once a full command name has been typed, keyword (enum) arguments are
+ * completed from its argument specification.
+ *
+ * @param line The line typed so far (cursor at its end).
+ * @param insert Buffer receiving the characters to append to the line.
+ * @param max_insert Capacity of insert.
+ * @return int Number of characters to append, 0 if there is nothing to
+ *             complete, or -1 if the candidates were listed and the line
+ *             needs to be redrawn.
+ */
+int command_complete(const char *line, char *insert, int max_insert) {
+    char text[MAX_LINE];
+    const char *candidates[MAX_COMMANDS];
+    int length = 0;
+    int low = 0, high = command_count;
+    int count = 0;
+
+    // Collapse whitespace so the text can be compared with command names
+    for (; *line != '\0' && length < MAX_LINE - 1; line++) {
+        if (!isspace((unsigned char)*line)) {
+            text[length++] = *line;
+        } else if (length > 0 && text[length - 1] != ' ') {
+            text[length++] = ' ';
+        }
+    }
+    text[length] = '\0';
+
+    // Lower bound of the names that start with the text
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (strncasecmp(command_index[mid]->command, text, length) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    while (low < command_count && strncasecmp(command_index[low]->command, text, length) == 0) {
+        candidates[count++] = command_index[low++]->command;
+    }
+
+    if (count == 0) {
+        return complete_argument(text, insert, max_insert);
+    }
+    return complete_candidates(length, candidates, count, insert, max_insert);
+}
+
+/**
+ * @brief Handler for the "HELP" command.
+ *
+ * Prints the usage line of every command, generated from its argument
+ * specification.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void help_command(int argc, char *argv[], const ArgValue *args) {
+    for (int i = 0; i < command_count; i++) {
+        const Command *command = command_index[i];
+        arg_print_usage(command->command, command->args, command->nargs, command->required);
+    }
+    printf("%s <command...>\r\n", TIME_PREFIX);
+}
+
+/**
+ * @brief Handler for the "PROFILE" command.
+ *
+ * Prints the run count and min/avg/max execution time of every command
+ * that has run, or clears the statistics.
+ *
+ * RPC result of SHOW: per command that has run, uint32 command id, runs,
+ * min, avg and max in us. Commands that do not fit the result block are
+ * left out and the response is flagged as truncated.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: optional action.
+ */
+static void profile_command(int argc, char *argv[], const ArgValue *args) {
+    if (argc > 0 && args[0].choice == 1) {
+        memset(command_stats, 0, sizeof(command_stats));
+        printf("Profile cleared\r\n");
+        return;
+    }
+    printf("%-16s %8s %10s %10s %10s\r\n", "Command", "Runs", "Min us", "Avg us", "Max us");
+    for (int i = 0; i < command_count; i++) {
+        const CommandStats *stats = &command_stats[i];
+
+        if (stats->count > 0) {
+            uint32_t result[5] = {(uint32_t)i, stats->count, stats->min_us,
+                                  (uint32_t)(stats->total_us / stats->count), stats->max_us};
+
+            rpc_result(result, sizeof(result));
+            printf("%-16s %8lu %10lu %10lu %10lu\r\n", command_index[i]->command, (unsigned long)stats->count,
+                   (unsigned long)stats->min_us, (unsigned long)(stats->total_us / stats->count),
+                   (unsigned long)stats->max_us);
+        }
+    }
+}
+
+static const char *const profile_actions[] = {"SHOW", "RESET", NULL};
+static const ArgSpec profile_args[] = {
+    ARG_ENUM("action", profile_actions),
+};
+REGISTER_COMMAND_ARGS(profile, "PROFILE", profile_command, profile_args, 0);
@@ -3,7 +3,9 @@
  * @brief Header file for the command processing module.
  *
  * This module provides function declarations for handling user input commands.
- * It includes functions for processing commands, echoing input, and controlling the LED.
+ * Drivers register their own commands with REGISTER_COMMAND(), which places
+ * the descriptor in the "command_table" linker section; the command
+ * processor builds a sorted dispatch index from that section at startup.
  *
  * @date 13 November 2024
  * @author Lokesh Senthil Kumar
@@ -12,13 +14,43 @@
 #ifndef COMMAND_PROCESSOR_H
 #define COMMAND_PROCESSOR_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include "arg_parser.h"
+
+#define MAX_ARGS 16 /**< Maximum number of tokens on one command line */
+
+// Structure for storing command name, its length, handler and argument specification
+typedef struct {
+    const char *command;
+    uint8_t length;
+    void (*handler)(int argc, char *argv[], const ArgValue *args);
+    const ArgSpec *args;
+    uint8_t nargs;
+    uint8_t required;
+} Command;
+
+// Places a command descriptor in the "command_table" section. The section
+// name is a valid C identifier, so GNU ld provides __start_command_table and
+// __stop_command_table without any linker script changes. The explicit
+// alignment stops the compiler padding entries, so the section can be
+// walked as an array.
+#define COMMAND_SECTION __attribute__((used, section("command_table"), aligned(__alignof__(Command))))
+
+// Registers a command without arguments; the name length is computed at compile time
+#define REGISTER_COMMAND(symbol, name, handler) \
+    static const Command symbol COMMAND_SECTION = {name, sizeof(name) - 1, handler, NULL, 0, 0}
+// Same, for a command taking the arguments described by an ArgSpec array
+#define REGISTER_COMMAND_ARGS(symbol, name, handler, spec, required) \
+    static const Command symbol COMMAND_SECTION = \
+        {name, sizeof(name) - 1, handler, spec, sizeof(spec) / sizeof(spec[0]), required}
 
 // Function Declarations
-void process_command(const char *input);
-void echo_command(const char *input);
-void led_on_command(const char *input);
-void led_off_command(const char *input);
-void normalize_input(const char *input, char *output);
+void command_processor_init(void);
+void process_command(char *line);
+int command_complete(const char *line, char *insert, int max_insert);
+void command_execute(int id, int argc, char *argv[], const ArgValue *args);
+const Command *command_by_id(int id);
+uint32_t command_signature(void);
 
 #endif // COMMAND_PROCESSOR_H
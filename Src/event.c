@@ -0,0 +1,79 @@
+/**
+ * @file event.c
+ * @brief Fixed-capacity event queue from interrupt handlers to the main loop.
+ *
+ * Any interrupt may post, and only the main loop takes events out. A post
+ * runs with interrupts disabled for a few instructions, so handlers of
+ * different priorities can post without corrupting the queue. A full queue
+ * drops the new event and counts it rather than blocking an interrupt.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "stm32f0xx.h"
+#include "event.h"
+
+_Static_assert((EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) == 0, "EVENT_QUEUE_SIZE must be a power of two");
+
+static Event queue[EVENT_QUEUE_SIZE];
+static volatile uint32_t head = 0; // Next slot to fill; only grows
+static volatile uint32_t tail = 0; // Next slot to take; only grows
+static volatile uint32_t dropped = 0;
+
+/**
+ * @brief Queues an event for the main loop; safe to call from any interrupt.
+ *
+ * @param type Kind of event.
+ * @param data Detail for the event.
+ * @return int Returns 1 if queued, 0 if the queue was full and the event was dropped.
+ */
+int event_post(EventType type, uint32_t data) {
+    uint32_t primask = __get_PRIMASK();
+    int queued = 0;
+
+    __disable_irq();
+    if (head - tail < EVENT_QUEUE_SIZE) {
+        queue[head % EVENT_QUEUE_SIZE].type = type;
+        queue[head % EVENT_QUEUE_SIZE].data = data;
+        head++;
+        queued = 1;
+    } else {
+        dropped++;
+    }
+    __set_PRIMASK(primask);
+    return queued;
+}
+
+/**
+ * @brief Takes the oldest event; main loop only.
+ *
+ * @param event Pointer to store the event.
+ * @return int Returns 1 if an event was taken, 0 if the queue is empty.
+ */
+int event_get(Event *event) {
+    if (head == tail) {
+        return 0;
+    }
+    *event = queue[tail % EVENT_QUEUE_SIZE];
+    tail++; // Only the main loop moves tail, so no lock is needed
+    return 1;
+}
+
+/**
+ * @brief Tells whether events are waiting.
+ *
+ * @return int Returns 1 if the queue is not empty.
+ */
+int event_pending(void) {
+    return head != tail;
+}
+
+/**
+ * @brief Returns the number of events lost to a full queue since reset.
+ *
+ * @return uint32_t Dropped events.
+ */
+uint32_t event_dropped(void) {
+    return dropped;
+}
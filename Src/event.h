@@ -0,0 +1,43 @@
+/**
+ * @file event.h
+ * @brief Header file for the main loop event queue.
+ *
+ * Interrupt handlers post small events; the main loop takes them one at a
+ * time and acts on them, so drivers never have to be polled and the work
+ * runs outside interrupt context.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <stdint.h>
+
+#define EVENT_QUEUE_SIZE 16 /**< Events that can wait at once; a power of two */
+
+/**
+ * @brief Kinds of event.
+ */
+typedef enum {
+    EVENT_BUTTON_SHORT, /**< User button released before the long-press time; data = ms held */
+    EVENT_BUTTON_LONG,  /**< User button held for the long-press time */
+    EVENT_TIMER         /**< Periodic timer expired; data identifies the timer */
+} EventType;
+
+/**
+ * @brief One queued event.
+ */
+typedef struct {
+    EventType type; /**< What happened */
+    uint32_t data;  /**< Detail, meaning depends on type */
+} Event;
+
+// Function Declarations
+int event_post(EventType type, uint32_t data);
+int event_get(Event *event);
+int event_pending(void);
+uint32_t event_dropped(void);
+
+#endif // EVENT_H
@@ -0,0 +1,98 @@
+/**
+ * @file flash.c
+ * @brief Internal flash erase and program functions for STM32F0 microcontrollers.
+ *
+ * The flash is programmed one half-word at a time. A half-word can only be
+ * programmed while it is erased (0xFFFF), with one exception: 0x0000 may
+ * be written over any value, which callers can use to invalidate data
+ * without erasing the page.
+ *
+ * The CPU stalls on flash reads while an erase or program operation is in
+ * progress, so interrupts are delayed for up to the page erase time.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "stm32f0xx.h"
+#include "flash.h"
+
+/**
+ * @brief Unlocks the flash control register.
+ */
+static void flash_unlock(void) {
+    if (FLASH->CR & FLASH_CR_LOCK) {
+        FLASH->KEYR = FLASH_KEY1;
+        FLASH->KEYR = FLASH_KEY2;
+    }
+}
+
+/**
+ * @brief Locks the flash control register again.
+ */
+static void flash_lock(void) {
+    FLASH->CR |= FLASH_CR_LOCK;
+}
+
+/**
+ * @brief Waits for the current operation and checks its outcome.
+ *
+ * @return int Returns 1 on success, 0 on a programming or write-protection error.
+ */
+static int flash_wait(void) {
+    while (FLASH->SR & FLASH_SR_BSY);
+
+    if (FLASH->SR & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)) {
+        FLASH->SR = FLASH_SR_PGERR | FLASH_SR_WRPRTERR; // Write 1 to clear
+        return 0;
+    }
+    FLASH->SR = FLASH_SR_EOP;
+    return 1;
+}
+
+/**
+ * @brief Erases one flash page.
+ *
+ * @param address Any address within the page.
+ * @return int Returns 1 on success, 0 on failure.
+ */
+int flash_erase_page(uint32_t address) {
+    int ok;
+
+    flash_unlock();
+    FLASH->CR |= FLASH_CR_PER;
+    FLASH->AR = address;
+    FLASH->CR |= FLASH_CR_STRT;
+    ok = flash_wait();
+    FLASH->CR &= ~FLASH_CR_PER;
+    flash_lock();
+    return ok;
+}
+
+/**
+ * @brief Programs a block of data into erased flash.
+ *
+ * An odd trailing byte is padded with 0xFF.
+ *
+ * @param address Destination, must be half-word aligned.
+ * @param data Source data; no alignment requirement.
+ * @param length Number of bytes.
+ * @return int Returns 1 on success, 0 on failure.
+ */
+int flash_program(uint32_t address, const void *data, uint32_t length) {
+    const uint8_t *bytes = data;
+    int ok = 1;
+
+    flash_unlock();
+    FLASH->CR |= FLASH_CR_PG;
+    for (uint32_t i = 0; i < length && ok; i += 2) {
+        uint16_t halfword = bytes[i];
+        halfword |= (i + 1 < length) ? (uint16_t)(bytes[i + 1] << 8) : 0xFF00U;
+
+        *(volatile uint16_t *)(uintptr_t)(address + i) = halfword;
+        ok = flash_wait();
+    }
+    FLASH->CR &= ~FLASH_CR_PG;
+    flash_lock();
+    return ok;
+}
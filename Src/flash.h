@@ -0,0 +1,23 @@
+/**
+ * @file flash.h
+ * @brief Header file for the internal flash programming driver.
+ *
+ * Declares functions to erase and program pages of the STM32F091RC
+ * internal flash, used for persistent storage.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef FLASH_H
+#define FLASH_H
+
+#include <stdint.h>
+
+#define FLASH_PAGE_SIZE 2048U /**< Erase granularity of the STM32F091RC flash */
+
+// Function Declarations
+int flash_erase_page(uint32_t address);
+int flash_program(uint32_t address, const void *data, uint32_t length);
+
+#endif // FLASH_H
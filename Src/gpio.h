@@ -0,0 +1,170 @@
+/**
+ * @file gpio.h
+ * @brief Compile-time GPIO layer for STM32F0 pins.
+ *
+ * Pins are described by constants only, so every call inlines to plain
+ * register accesses with the masks folded by the compiler: setting or
+ * clearing a pin is a single BSRR/BRR store.
+ *
+ * A driver lists the pins it uses on one port as an X-macro, one
+ * X(pin, mode, af, type, pull) entry per pin:
+ *
+ *     #define USART2_PINS(X) X(2, GPIO_MODE_AF, 1, GPIO_PUSH_PULL, GPIO_NO_PULL) \
+ *                            X(3, GPIO_MODE_AF, 1, GPIO_PUSH_PULL, GPIO_NO_PULL)
+ *     GPIO_CONFIGURE(GPIOA, USART2_PINS);
+ *
+ * GPIO_CONFIGURE() merges the whole list into a single read-modify-write
+ * of each of AFR, OTYPER, PUPDR and MODER, however many pins are listed.
+ *
+ * GPIO_MASK(LIST) gives the pin mask of the same list. The *_mask
+ * functions take such a mask and act on every pin in it at once: one BSRR
+ * or BRR store to drive them, one IDR load to read them. Lines that must
+ * change together, such as a LED bar or several enable pins, therefore
+ * switch in the same bus cycle without passing through mixed states.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef GPIO_H
+#define GPIO_H
+
+#include <stdint.h>
+#include "stm32f0xx.h"
+
+// Pin modes (MODER field values)
+#define GPIO_MODE_INPUT 0U
+#define GPIO_MODE_OUTPUT 1U
+#define GPIO_MODE_AF 2U
+#define GPIO_MODE_ANALOG 3U
+
+// Output types (OTYPER bit values)
+#define GPIO_PUSH_PULL 0U
+#define GPIO_OPEN_DRAIN 1U
+
+// Pull resistors (PUPDR field values)
+#define GPIO_NO_PULL 0U
+#define GPIO_PULL_UP 1U
+#define GPIO_PULL_DOWN 2U
+
+// Register fields of one pin
+#define GPIO_FIELD2(pin, value) ((uint32_t)(value) << (2 * (pin)))
+#define GPIO_AFRL_FIELD(pin, value) ((pin) < 8 ? (uint32_t)(value) << (4 * (pin)) : 0U)
+#define GPIO_AFRH_FIELD(pin, value) ((pin) >= 8 ? (uint32_t)(value) << (4 * ((pin) - 8)) : 0U)
+
+// X-macro visitors: each turns one pin entry into "| field"
+#define GPIO_X_MODER_MASK(pin, mode, af, type, pull) | GPIO_FIELD2(pin, 3U)
+#define GPIO_X_MODER(pin, mode, af, type, pull) | GPIO_FIELD2(pin, mode)
+#define GPIO_X_OTYPER_MASK(pin, mode, af, type, pull) | (1U << (pin))
+#define GPIO_X_OTYPER(pin, mode, af, type, pull) | ((uint32_t)(type) << (pin))
+#define GPIO_X_PUPDR(pin, mode, af, type, pull) | GPIO_FIELD2(pin, pull)
+#define GPIO_X_AFRL_MASK(pin, mode, af, type, pull) | ((mode) == GPIO_MODE_AF ? GPIO_AFRL_FIELD(pin, 0xFU) : 0U)
+#define GPIO_X_AFRL(pin, mode, af, type, pull) | ((mode) == GPIO_MODE_AF ? GPIO_AFRL_FIELD(pin, af) : 0U)
+#define GPIO_X_AFRH_MASK(pin, mode, af, type, pull) | ((mode) == GPIO_MODE_AF ? GPIO_AFRH_FIELD(pin, 0xFU) : 0U)
+#define GPIO_X_AFRH(pin, mode, af, type, pull) | ((mode) == GPIO_MODE_AF ? GPIO_AFRH_FIELD(pin, af) : 0U)
+#define GPIO_X_MASK(pin, mode, af, type, pull) | (1U << (pin))
+
+// Mask of every pin in an X-macro list
+#define GPIO_MASK(LIST) (0U LIST(GPIO_X_MASK))
+
+// Configures every pin of an X-macro list on one port (see the file comment)
+#define GPIO_CONFIGURE(port, LIST) \
+    gpio_configure(port, \
+                   0U LIST(GPIO_X_MODER_MASK), 0U LIST(GPIO_X_MODER), \
+                   0U LIST(GPIO_X_OTYPER_MASK), 0U LIST(GPIO_X_OTYPER), 0U LIST(GPIO_X_PUPDR), \
+                   0U LIST(GPIO_X_AFRL_MASK), 0U LIST(GPIO_X_AFRL), \
+                   0U LIST(GPIO_X_AFRH_MASK), 0U LIST(GPIO_X_AFRH))
+
+/**
+ * @brief Applies precomputed masks and values to a port's configuration registers.
+ *
+ * Called through GPIO_CONFIGURE(), so all arguments are constants and the
+ * tests on the masks disappear at compile time. The alternate function is
+ * selected before MODER switches the pin over, so the pin never briefly
+ * drives a stale function.
+ */
+static inline void gpio_configure(GPIO_TypeDef *port, uint32_t moder_mask, uint32_t moder,
+                                  uint32_t otyper_mask, uint32_t otyper, uint32_t pupdr,
+                                  uint32_t afrl_mask, uint32_t afrl, uint32_t afrh_mask, uint32_t afrh) {
+    if (afrl_mask != 0U) {
+        port->AFR[0] = (port->AFR[0] & ~afrl_mask) | afrl;
+    }
+    if (afrh_mask != 0U) {
+        port->AFR[1] = (port->AFR[1] & ~afrh_mask) | afrh;
+    }
+    port->OTYPER = (port->OTYPER & ~otyper_mask) | otyper;
+    port->PUPDR = (port->PUPDR & ~moder_mask) | pupdr;
+    port->MODER = (port->MODER & ~moder_mask) | moder;
+}
+
+/**
+ * @brief Drives every pin in a mask high (one BSRR store).
+ */
+static inline void gpio_set_mask(GPIO_TypeDef *port, uint32_t mask) {
+    port->BSRR = mask;
+}
+
+/**
+ * @brief Drives every pin in a mask low (one BRR store).
+ */
+static inline void gpio_clear_mask(GPIO_TypeDef *port, uint32_t mask) {
+    port->BRR = mask;
+}
+
+/**
+ * @brief Drives the pins in a mask to the matching bits of a value (one BSRR store).
+ *
+ * Pins outside the mask are left alone, so unrelated outputs on the same
+ * port need no read-modify-write and cannot be disturbed by an interrupt.
+ *
+ * @param port GPIO port.
+ * @param mask Pins to drive.
+ * @param value Levels, one bit per pin; bits outside the mask are ignored.
+ */
+static inline void gpio_write_mask(GPIO_TypeDef *port, uint32_t mask, uint32_t value) {
+    port->BSRR = ((mask & ~value) << 16) | (mask & value);
+}
+
+/**
+ * @brief Reads the input levels of the pins in a mask (one IDR load).
+ *
+ * @return uint32_t IDR bits of the masked pins, at their pin positions.
+ */
+static inline uint32_t gpio_read_mask(GPIO_TypeDef *port, uint32_t mask) {
+    return port->IDR & mask;
+}
+
+/**
+ * @brief Drives a pin high (one BSRR store).
+ */
+static inline void gpio_set(GPIO_TypeDef *port, uint32_t pin) {
+    gpio_set_mask(port, 1U << pin);
+}
+
+/**
+ * @brief Drives a pin low (one BRR store).
+ */
+static inline void gpio_clear(GPIO_TypeDef *port, uint32_t pin) {
+    gpio_clear_mask(port, 1U << pin);
+}
+
+/**
+ * @brief Drives a pin to a level.
+ *
+ * With a constant level this is a single store; otherwise the BSRR set or
+ * reset half is selected arithmetically, still without a branch.
+ */
+static inline void gpio_write(GPIO_TypeDef *port, uint32_t pin, int level) {
+    port->BSRR = (1U << pin) << (level ? 0 : 16);
+}
+
+/**
+ * @brief Reads the input level of a pin.
+ *
+ * @return int 1 if the pin is high, 0 if it is low.
+ */
+static inline int gpio_read(GPIO_TypeDef *port, uint32_t pin) {
+    return gpio_read_mask(port, 1U << pin) != 0U;
+}
+
+#endif // GPIO_H
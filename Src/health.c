@@ -0,0 +1,245 @@
+/**
+ * @file health.c
+ * @brief Health monitor that shows the worst system condition as an LED blink code.
+ *
+ * Watches the USART2 RX/TX overflow counters, the I2C error count, main
+ * loop passes that came close to the watchdog timeout, and resets caused
+ * by a watchdog or a low-power fault. A condition is raised when its
+ * counter has moved since the last HEALTH CLEAR; the highest-priority
+ * raised condition picks the blink code. Fault resets keep their code
+ * until cleared, because the LED is the only way to see them in the field.
+ *
+ * The conditions are evaluated on every main loop pass, which is at least
+ * once per tick while the MCU is awake; that costs a handful of counter
+ * comparisons. Running in the main loop rather than the SysTick handler
+ * means a code change never races a LED command that is reconfiguring
+ * PA5, and it also catches counters raised while the tick was stopped
+ * in Stop mode. A LED command overrides the code until the next change.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include "stm32f0xx.h"
+#include "health.h"
+#include "tick.h"
+#include "led_blink.h"
+#include "usart.h"
+#include "idle.h"
+#include "i2c.h"
+#include "rpc.h"
+#include "command_processor.h"
+
+#define HEALTH_LSI_FREQUENCY 40000 /**< Nominal LSI clock of the IWDG */
+#define HEALTH_IWDG_PRESCALER 3    /**< IWDG_PR value for LSI / 32 */
+#define HEALTH_CODE_ON_MS 200      /**< Pulse length of a blink code */
+#define HEALTH_CODE_OFF_MS 300     /**< Pause between pulses of a blink code */
+#define HEALTH_CODE_GAP_MS 1200    /**< Extra pause between repetitions */
+
+// Conditions, highest priority first
+enum {
+    HEALTH_FAULT_RESET, // Last reset came from a watchdog or a low-power fault
+    HEALTH_NEAR_MISS,   // A main loop pass took at least HEALTH_NEAR_MISS_MS
+    HEALTH_I2C_ERROR,   // Sensor bus NACK, bus error or timeout
+    HEALTH_RX_OVERFLOW, // Console input lost
+    HEALTH_TX_OVERFLOW, // Console output lost
+    HEALTH_CONDITIONS
+};
+
+static const char *const condition_names[HEALTH_CONDITIONS] = {
+    "Fault reset", "Watchdog near-miss", "I2C errors", "RX overflow", "TX overflow",
+};
+// Pulses per blink code; more pulses for more severe conditions
+static const uint8_t condition_pulses[HEALTH_CONDITIONS] = {5, 4, 3, 2, 1};
+
+static uint32_t fault_resets = 0;    // 1 if the last reset was a fault
+static uint32_t reset_flags = 0;     // RCC_CSR reset flags captured at startup
+static uint32_t near_misses = 0;
+static uint32_t longest_pass = 0; // Longest main loop pass in ms
+static uint32_t baseline[HEALTH_CONDITIONS]; // Counter values at the last HEALTH CLEAR
+static uint32_t last_kick = 0;
+static int idle = 1;        // Main loop is waiting for input, not running a pass
+static int shown = -1;               // Condition the LED shows, -1 when healthy
+
+/**
+ * @brief Reads the counter behind a condition.
+ *
+ * @param condition Condition index.
+ * @return uint32_t Current count.
+ */
+static uint32_t condition_count(int condition) {
+    switch (condition) {
+    case HEALTH_FAULT_RESET:
+        return fault_resets;
+    case HEALTH_NEAR_MISS:
+        return near_misses;
+    case HEALTH_I2C_ERROR:
+        return I2C1_ErrorCount();
+    case HEALTH_RX_OVERFLOW:
+        return USART2_RxOverflowCount();
+    default:
+        return USART2_TxOverflowCount();
+    }
+}
+
+/**
+ * @brief Finds the highest-priority raised condition.
+ *
+ * @return int Condition index, or -1 if every counter is at its baseline.
+ */
+static int health_evaluate(void) {
+    for (int i = 0; i < HEALTH_CONDITIONS; i++) {
+        if (condition_count(i) != baseline[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Records the reset cause and starts the watchdog if enabled.
+ *
+ * Call once at startup, after tick_init().
+ */
+void health_init(void) {
+    reset_flags = RCC->CSR & (RCC_CSR_IWDGRSTF | RCC_CSR_WWDGRSTF | RCC_CSR_LPWRRSTF |
+                              RCC_CSR_SFTRSTF | RCC_CSR_PORRSTF | RCC_CSR_PINRSTF);
+    RCC->CSR |= RCC_CSR_RMVF;
+    if (reset_flags & (RCC_CSR_IWDGRSTF | RCC_CSR_WWDGRSTF | RCC_CSR_LPWRRSTF)) {
+        fault_resets = 1;
+    }
+
+#if HEALTH_IWDG
+    // The IWDG keeps counting in Stop mode, so the main loop may only sleep
+    idle_hold_stop();
+    IWDG->KR = 0xCCCC; // Start; this also starts LSI
+    IWDG->KR = 0x5555; // Unlock PR and RLR
+    IWDG->PR = HEALTH_IWDG_PRESCALER;
+    IWDG->RLR = HEALTH_WATCHDOG_MS * (HEALTH_LSI_FREQUENCY / 32) / 1000;
+    while (IWDG->SR != 0) {
+        // Wait for the new prescaler and reload to take effect
+    }
+    IWDG->KR = 0xAAAA;
+#endif
+    last_kick = tick_ms();
+}
+
+/**
+ * @brief Ends the current main loop pass, counting it if it ran long.
+ */
+static void health_end_pass(void) {
+    uint32_t now = tick_ms();
+
+    if (!idle) {
+        uint32_t pass = now - last_kick;
+
+        if (pass > longest_pass) {
+            longest_pass = pass;
+        }
+        if (pass >= HEALTH_NEAR_MISS_MS) {
+            near_misses++;
+        }
+    }
+    last_kick = now;
+}
+
+/**
+ * @brief Marks the start of a main loop pass and updates the LED code.
+ *
+ * Refreshes the watchdog, so it must be called on every pass.
+ */
+void health_kick(void) {
+    int condition;
+
+    health_end_pass();
+    idle = 0;
+#if HEALTH_IWDG
+    IWDG->KR = 0xAAAA;
+#endif
+
+    condition = health_evaluate();
+    if (condition == shown) {
+        return;
+    }
+    shown = condition;
+    if (condition < 0) {
+        LED_BlinkStop(LED_BLINK_USER);
+    } else {
+        BlinkPattern pattern = {
+            .on_ms = HEALTH_CODE_ON_MS,
+            .off_ms = HEALTH_CODE_OFF_MS,
+            .gap_ms = HEALTH_CODE_GAP_MS,
+            .pulses = condition_pulses[condition],
+            .repeat = 0,
+        };
+        LED_BlinkStart(LED_BLINK_USER, &pattern);
+    }
+}
+
+/**
+ * @brief Marks the main loop as waiting for input; the wait is not a pass.
+ */
+void health_idle(void) {
+    health_end_pass();
+    idle = 1;
+}
+
+/**
+ * @brief Handler for the "HEALTH" command.
+ *
+ * SHOW (the default) lists the reset cause and every condition with its
+ * count since the last CLEAR; CLEAR takes the current counts as the new
+ * baseline, which turns the LED code off until something else goes wrong.
+ *
+ * RPC result of SHOW: uint32 RCC_CSR reset flags, the count of each
+ * condition in priority order (fault reset, near-miss, I2C, RX overflow,
+ * TX overflow), the longest loop pass in ms, and the condition the LED
+ * shows (0xFFFFFFFF when healthy).
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: optional action.
+ */
+static void health_command(int argc, char *argv[], const ArgValue *args) {
+    uint32_t result[HEALTH_CONDITIONS + 3];
+
+    if (argc > 0 && args[0].choice == 1) {
+        for (int i = 0; i < HEALTH_CONDITIONS; i++) {
+            baseline[i] = condition_count(i);
+        }
+        longest_pass = 0;
+        printf("Health counters cleared\r\n");
+        return;
+    }
+
+    result[0] = reset_flags;
+    for (int i = 0; i < HEALTH_CONDITIONS; i++) {
+        result[1 + i] = condition_count(i) - baseline[i];
+    }
+    result[1 + HEALTH_CONDITIONS] = longest_pass;
+    result[2 + HEALTH_CONDITIONS] = (uint32_t)shown;
+    rpc_result(result, sizeof(result));
+
+    printf("Reset cause: %s%s%s%s%s%s\r\n",
+           (reset_flags & RCC_CSR_IWDGRSTF) ? "IWDG " : "",
+           (reset_flags & RCC_CSR_WWDGRSTF) ? "WWDG " : "",
+           (reset_flags & RCC_CSR_LPWRRSTF) ? "low-power " : "",
+           (reset_flags & RCC_CSR_SFTRSTF) ? "software " : "",
+           (reset_flags & RCC_CSR_PORRSTF) ? "power-on " : "",
+           (reset_flags & RCC_CSR_PINRSTF) ? "pin " : "");
+    for (int i = 0; i < HEALTH_CONDITIONS; i++) {
+        uint32_t count = condition_count(i) - baseline[i];
+
+        printf("%-20s %8lu  code %u%s\r\n", condition_names[i], (unsigned long)count,
+               condition_pulses[i], (i == shown) ? "  <- LED" : "");
+    }
+    printf("Longest loop pass: %lu ms (near-miss at %u ms)\r\n", (unsigned long)longest_pass,
+           HEALTH_NEAR_MISS_MS);
+}
+
+static const char *const health_actions[] = {"SHOW", "CLEAR", NULL};
+static const ArgSpec health_args[] = {
+    ARG_ENUM("action", health_actions),
+};
+REGISTER_COMMAND_ARGS(health, "HEALTH", health_command, health_args, 0);
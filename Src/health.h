@@ -0,0 +1,23 @@
+/**
+ * @file health.h
+ * @brief Header file for the health monitor and its LED blink codes.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef HEALTH_H
+#define HEALTH_H
+
+#include <stdint.h>
+
+#define HEALTH_IWDG 0             /**< 1: run the IWDG; the console then sleeps instead of entering Stop */
+#define HEALTH_WATCHDOG_MS 1000   /**< Longest main loop pass the watchdog allows */
+#define HEALTH_NEAR_MISS_MS (HEALTH_WATCHDOG_MS / 2) /**< Passes at least this long count as near-misses */
+
+// Function Declarations
+void health_init(void);
+void health_kick(void);
+void health_idle(void);
+
+#endif // HEALTH_H
@@ -0,0 +1,266 @@
+/**
+ * @file hexdump.c
+ * @brief Streaming hex/ASCII memory dump for flash, SRAM and peripherals.
+ *
+ * "HEXDUMP <addr> <len>" only validates the range and starts a background
+ * job. Each step of the job formats one 16-byte line at a time with lookup
+ * tables and hands it to the TX circular buffer in a single block whenever
+ * there is room. Large dumps therefore keep the link busy without blocking
+ * the main loop or going through printf, and several dumps may run at once.
+ *
+ * Peripherals are only dumpable block by block, for the blocks the
+ * STM32F091 implements; the reserved gaps between them bus-fault. Data
+ * registers whose read pops a FIFO or clears a flag (USART RDR, I2C RXDR,
+ * SPI DR, ADC DR, CEC RXDR) are never read and show as "--", so a dump
+ * cannot steal console input or sensor data. Other registers are read as
+ * they are; a timer CCRx read in input capture mode clears its CCxIF.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include "job.h"
+#include "usart.h"
+#include "command_processor.h"
+
+#define HEXDUMP_BYTES_PER_LINE 16
+// "AAAAAAAA: " + 16 x "XX " + extra gap + " |" + 16 chars + "|\r\n"
+#define HEXDUMP_LINE_LENGTH (10 + HEXDUMP_BYTES_PER_LINE * 3 + 1 + 2 + HEXDUMP_BYTES_PER_LINE + 3)
+
+#define HEXDUMP_NO_SKIP 0xFFFF /**< skip_offset of a block with nothing to skip */
+
+// Memory regions that may be dumped; everything else is rejected
+typedef struct {
+    uint32_t start;
+    uint32_t end;         // Exclusive
+    const char *name;
+    uint8_t word_access;  // Peripheral registers must be read as 32-bit words
+    uint16_t skip_offset; // Register that changes state when read, or HEXDUMP_NO_SKIP
+} MemoryRegion;
+
+// One 1 KB peripheral block, with the offset of its read-sensitive data register
+#define PERIPHERAL(base, name, skip) {base, base + 0x400, name, 1, skip}
+
+static const MemoryRegion memory_regions[] = {
+    {0x08000000, 0x08040000, "flash", 0, HEXDUMP_NO_SKIP},
+    {0x1FFFD800, 0x1FFFF810, "system memory", 0, HEXDUMP_NO_SKIP},
+    {0x20000000, 0x20008000, "SRAM", 0, HEXDUMP_NO_SKIP},
+    // APB
+    PERIPHERAL(0x40000000, "TIM2", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40000400, "TIM3", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40001000, "TIM6", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40001400, "TIM7", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40002000, "TIM14", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40002800, "RTC", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40002C00, "WWDG", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40003000, "IWDG", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40003800, "SPI2", 0x0C),
+    PERIPHERAL(0x40004400, "USART2", 0x24),
+    PERIPHERAL(0x40004800, "USART3", 0x24),
+    PERIPHERAL(0x40004C00, "USART4", 0x24),
+    PERIPHERAL(0x40005000, "USART5", 0x24),
+    PERIPHERAL(0x40005400, "I2C1", 0x24),
+    PERIPHERAL(0x40005800, "I2C2", 0x24),
+    PERIPHERAL(0x40006400, "CAN", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40006C00, "CRS", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40007000, "PWR", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40007400, "DAC", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40007800, "CEC", 0x0C),
+    PERIPHERAL(0x40010000, "SYSCFG/COMP", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40010400, "EXTI", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40011400, "USART6", 0x24),
+    PERIPHERAL(0x40011800, "USART7", 0x24),
+    PERIPHERAL(0x40011C00, "USART8", 0x24),
+    PERIPHERAL(0x40012400, "ADC", 0x40),
+    PERIPHERAL(0x40012C00, "TIM1", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40013000, "SPI1", 0x0C),
+    PERIPHERAL(0x40013800, "USART1", 0x24),
+    PERIPHERAL(0x40014000, "TIM15", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40014400, "TIM16", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40014800, "TIM17", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40015800, "DBGMCU", HEXDUMP_NO_SKIP),
+    // AHB1
+    PERIPHERAL(0x40020000, "DMA1", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40020400, "DMA2", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40021000, "RCC", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40022000, "FLASH", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40023000, "CRC", HEXDUMP_NO_SKIP),
+    PERIPHERAL(0x40024000, "TSC", HEXDUMP_NO_SKIP),
+    // AHB2: GPIOA..GPIOF are contiguous
+    {0x48000000, 0x48001800, "GPIO", 1, HEXDUMP_NO_SKIP},
+    {0xE000E000, 0xE000F000, "system control space", 1, HEXDUMP_NO_SKIP},
+};
+
+// Two ASCII digits for every byte value, so a byte is formatted with one lookup
+#define HEX_ROW(h) \
+    {h, '0'}, {h, '1'}, {h, '2'}, {h, '3'}, {h, '4'}, {h, '5'}, {h, '6'}, {h, '7'}, \
+    {h, '8'}, {h, '9'}, {h, 'A'}, {h, 'B'}, {h, 'C'}, {h, 'D'}, {h, 'E'}, {h, 'F'}
+static const char hex_pairs[256][2] = {
+    HEX_ROW('0'), HEX_ROW('1'), HEX_ROW('2'), HEX_ROW('3'),
+    HEX_ROW('4'), HEX_ROW('5'), HEX_ROW('6'), HEX_ROW('7'),
+    HEX_ROW('8'), HEX_ROW('9'), HEX_ROW('A'), HEX_ROW('B'),
+    HEX_ROW('C'), HEX_ROW('D'), HEX_ROW('E'), HEX_ROW('F'),
+};
+
+// State of one dump, kept in the job context
+typedef struct {
+    uint32_t address;
+    uint32_t remaining;
+    const MemoryRegion *region;
+    uint32_t word_address; // Address of the cached peripheral word
+    uint32_t word;
+} HexdumpJob;
+_Static_assert(sizeof(HexdumpJob) <= JOB_CONTEXT_SIZE, "HexdumpJob does not fit a job context");
+
+/**
+ * @brief Finds the region that wholly contains a range.
+ *
+ * @param address Start of the range.
+ * @param length Length of the range in bytes.
+ * @return const MemoryRegion* The region, or NULL if the range is not dumpable.
+ */
+static const MemoryRegion *find_region(uint32_t address, uint32_t length) {
+    for (unsigned i = 0; i < sizeof(memory_regions) / sizeof(memory_regions[0]); i++) {
+        const MemoryRegion *region = &memory_regions[i];
+        if (address >= region->start && address < region->end && length <= region->end - address) {
+            return region;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reads one byte of the dump.
+ *
+ * Peripheral regions are read with aligned 32-bit loads, and each register
+ * is read only once even though it supplies four bytes. The block's
+ * read-sensitive register is not read at all.
+ *
+ * @param dump Dump in progress.
+ * @param address Byte address.
+ * @return int The byte, or -1 if it belongs to a register that is skipped.
+ */
+static int read_byte(HexdumpJob *dump, uint32_t address) {
+    if (!dump->region->word_access) {
+        return *(const volatile uint8_t *)(uintptr_t)address;
+    }
+    if ((address & ~3U) - dump->region->start == dump->region->skip_offset) {
+        return -1;
+    }
+    if ((address & ~3U) != dump->word_address) {
+        dump->word_address = address & ~3U;
+        dump->word = *(const volatile uint32_t *)(uintptr_t)dump->word_address;
+    }
+    return (uint8_t)(dump->word >> ((address & 3U) * 8));
+}
+
+/**
+ * @brief Formats the next line of the dump.
+ *
+ * @param dump Dump in progress.
+ * @param line Buffer of at least HEXDUMP_LINE_LENGTH bytes.
+ * @return int Number of characters written.
+ */
+static int format_line(HexdumpJob *dump, char *line) {
+    uint32_t count = (dump->remaining < HEXDUMP_BYTES_PER_LINE) ? dump->remaining : HEXDUMP_BYTES_PER_LINE;
+    char *hex = line + 10;
+    char *ascii = line + 10 + HEXDUMP_BYTES_PER_LINE * 3 + 1 + 2;
+
+    for (int shift = 24, i = 0; shift >= 0; shift -= 8, i += 2) {
+        const char *pair = hex_pairs[(dump->address >> shift) & 0xFF];
+        line[i] = pair[0];
+        line[i + 1] = pair[1];
+    }
+    line[8] = ':';
+    line[9] = ' ';
+
+    for (uint32_t i = 0; i < HEXDUMP_BYTES_PER_LINE; i++) {
+        if (i == HEXDUMP_BYTES_PER_LINE / 2) {
+            *hex++ = ' ';
+        }
+        if (i < count) {
+            int byte = read_byte(dump, dump->address + i);
+
+            if (byte < 0) {
+                hex[0] = '-';
+                hex[1] = '-';
+                ascii[i] = '.';
+            } else {
+                hex[0] = hex_pairs[byte][0];
+                hex[1] = hex_pairs[byte][1];
+                ascii[i] = (byte >= 0x20 && byte < 0x7F) ? (char)byte : '.';
+            }
+        } else {
+            hex[0] = ' ';
+            hex[1] = ' ';
+            ascii[i] = ' ';
+        }
+        hex[2] = ' ';
+        hex += 3;
+    }
+    hex[0] = ' ';
+    hex[1] = '|';
+    ascii[HEXDUMP_BYTES_PER_LINE] = '|';
+    ascii[HEXDUMP_BYTES_PER_LINE + 1] = '\r';
+    ascii[HEXDUMP_BYTES_PER_LINE + 2] = '\n';
+
+    dump->address += count;
+    dump->remaining -= count;
+    return HEXDUMP_LINE_LENGTH;
+}
+
+/**
+ * @brief Job step: streams as many lines as the TX buffer can take.
+ *
+ * @param context The HexdumpJob of this dump.
+ * @return JobStatus JOB_WAITING while the TX buffer is full, JOB_DONE at the end.
+ */
+static JobStatus hexdump_step(void *context) {
+    HexdumpJob *dump = context;
+    char line[HEXDUMP_LINE_LENGTH];
+
+    while (dump->remaining > 0 && USART2_TxSpace() >= HEXDUMP_LINE_LENGTH) {
+        USART2_Write((const uint8_t *)line, format_line(dump, line));
+    }
+    return (dump->remaining > 0) ? JOB_WAITING : JOB_DONE;
+}
+
+/**
+ * @brief Handler for the "HEXDUMP" command.
+ *
+ * Validates that the whole range lies in one dumpable region, such as one
+ * peripheral block, and starts a background job that streams it.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: start address and length.
+ */
+static void hexdump_command(int argc, char *argv[], const ArgValue *args) {
+    uint32_t address = args[0].u;
+    uint32_t length = (uint32_t)args[1].i;
+    const MemoryRegion *region = find_region(address, length);
+    HexdumpJob *dump;
+
+    if (region == NULL) {
+        printf("Range %08lX+%lu is not in flash, SRAM or one implemented peripheral block\r\n",
+               (unsigned long)address, (unsigned long)length);
+        return;
+    }
+    dump = job_start("HEXDUMP", hexdump_step);
+    if (dump == NULL) {
+        return;
+    }
+    fflush(stdout); // Keep earlier printf output ahead of the dump
+
+    dump->address = address;
+    dump->region = region;
+    dump->word_address = 1; // Never a valid aligned address, so the first word is read
+    dump->remaining = length;
+}
+
+static const ArgSpec hexdump_args[] = {
+    ARG_HEX("addr"),
+    ARG_INT("len", 1, 0x40000),
+};
+REGISTER_COMMAND_ARGS(hexdump, "HEXDUMP", hexdump_command, hexdump_args, 2);
@@ -0,0 +1,186 @@
+/**
+ * @file i2c.c
+ * @brief Polled I2C1 master driver for STM32F091RC microcontroller.
+ *
+ * Runs I2C1 at 100 kHz from the 8 MHz HSI on PB8 (SCL) and PB9 (SDA).
+ * Transfers are short register accesses, so they are polled rather than
+ * interrupt driven; each wait is bounded in real time by the microsecond
+ * timebase, independent of SYSCLK. A NACK, bus error or timeout aborts the
+ * transfer and is counted.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "stm32f0xx.h"
+#include "i2c.h"
+#include "gpio.h"
+#include "timebase.h"
+#include "clock.h"
+
+// PB8 (SCL) and PB9 (SDA) on AF1 = I2C1, open-drain with pull-ups
+#define I2C1_PINS(X) X(8, GPIO_MODE_AF, 1, GPIO_OPEN_DRAIN, GPIO_PULL_UP) \
+                     X(9, GPIO_MODE_AF, 1, GPIO_OPEN_DRAIN, GPIO_PULL_UP)
+// Standard mode 100 kHz: the kernel clock is prescaled to a 4 MHz timing
+// clock, then SCLDEL 4, SDADEL 2, SCLH 0x0F, SCLL 0x13 (RM0091 timing example)
+#define I2C_TIMING_CLOCK 4000000U
+#define I2C_TIMING_100KHZ(kernel) ((((kernel) / I2C_TIMING_CLOCK - 1U) << 28) | 0x00420F13U)
+#define I2C_KERNEL_FREQUENCY CLOCK_HSI_HZ /**< I2C1SW = HSI, see I2C1_Init() */
+#define I2C_TIMEOUT_US 1000U /**< Longest wait for one bus event, about ten byte times at 100 kHz */
+#define I2C_ERROR_FLAGS (I2C_ISR_NACKF | I2C_ISR_BERR | I2C_ISR_ARLO)
+
+static uint32_t error_count = 0;
+
+/**
+ * @brief Initializes I2C1 as a 100 kHz master on PB8/PB9.
+ *
+ * The pins are open-drain with the internal pull-ups enabled; boards with
+ * external pull-ups on the sensor breakout work either way.
+ */
+void I2C1_Init(void) {
+    // Enable clock for GPIOB and I2C1
+    RCC->AHBENR |= RCC_AHBENR_GPIOBEN;
+    RCC->APB1ENR |= RCC_APB1ENR_I2C1EN;
+
+    // Configure PB8 (SCL) and PB9 (SDA) as open-drain AF1 with pull-ups
+    GPIO_CONFIGURE(GPIOB, I2C1_PINS);
+
+    // Clock I2C1 from HSI so the timing does not change with SYSCLK
+    RCC->CFGR3 &= ~RCC_CFGR3_I2C1SW;
+
+    I2C1->CR1 &= ~I2C_CR1_PE;
+    I2C1->TIMINGR = I2C_TIMING_100KHZ(I2C_KERNEL_FREQUENCY);
+    I2C1->CR1 |= I2C_CR1_PE;
+}
+
+/**
+ * @brief Ends a failed transfer and returns the peripheral to idle.
+ *
+ * After a NACK the hardware sends STOP itself; after a bus error or a
+ * timeout the peripheral is reset by toggling PE.
+ */
+static void I2C1_Abort(void) {
+    uint32_t start = timebase_us();
+    int timed_out = 0;
+
+    error_count++;
+    if (I2C1->ISR & I2C_ISR_NACKF) {
+        while (!(I2C1->ISR & I2C_ISR_STOPF) && !timed_out) {
+            timed_out = (timebase_us() - start) >= I2C_TIMEOUT_US;
+        }
+    }
+    if (timed_out || (I2C1->ISR & (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_BUSY))) {
+        I2C1->CR1 &= ~I2C_CR1_PE;
+        I2C1->CR1 |= I2C_CR1_PE;
+    }
+    I2C1->ICR = I2C_ICR_NACKCF | I2C_ICR_STOPCF | I2C_ICR_BERRCF | I2C_ICR_ARLOCF;
+}
+
+/**
+ * @brief Waits for a status flag, watching for errors.
+ *
+ * @param flag I2C_ISR flag to wait for.
+ * @return int Returns 1 once the flag is set, 0 on an error or timeout.
+ */
+static int I2C1_WaitFlag(uint32_t flag) {
+    uint32_t start = timebase_us();
+
+    do {
+        uint32_t isr = I2C1->ISR;
+
+        if (isr & I2C_ERROR_FLAGS) {
+            return 0;
+        }
+        if (isr & flag) {
+            return 1;
+        }
+    } while ((timebase_us() - start) < I2C_TIMEOUT_US);
+    return 0;
+}
+
+/**
+ * @brief Waits for the STOP condition that ends a transfer.
+ *
+ * @return int Returns 1 on success, 0 on an error or timeout.
+ */
+static int I2C1_Finish(void) {
+    if (!I2C1_WaitFlag(I2C_ISR_STOPF)) {
+        I2C1_Abort();
+        return 0;
+    }
+    I2C1->ICR = I2C_ICR_STOPCF;
+    return 1;
+}
+
+/**
+ * @brief Writes consecutive registers of a device.
+ *
+ * @param address 7-bit device address.
+ * @param reg First register address.
+ * @param data Bytes to write.
+ * @param length Number of bytes (up to 254).
+ * @return int Returns 1 on success, 0 on a NACK, bus error or timeout.
+ */
+int I2C1_WriteRegister(uint8_t address, uint8_t reg, const uint8_t *data, uint16_t length) {
+    I2C1->CR2 = ((uint32_t)address << 1) | ((uint32_t)(length + 1) << I2C_CR2_NBYTES_Pos) |
+                I2C_CR2_AUTOEND | I2C_CR2_START;
+
+    if (!I2C1_WaitFlag(I2C_ISR_TXIS)) {
+        I2C1_Abort();
+        return 0;
+    }
+    I2C1->TXDR = reg;
+    for (uint16_t i = 0; i < length; i++) {
+        if (!I2C1_WaitFlag(I2C_ISR_TXIS)) {
+            I2C1_Abort();
+            return 0;
+        }
+        I2C1->TXDR = data[i];
+    }
+    return I2C1_Finish();
+}
+
+/**
+ * @brief Reads consecutive registers of a device.
+ *
+ * Sends the register address, then a repeated START and the read.
+ *
+ * @param address 7-bit device address.
+ * @param reg First register address.
+ * @param data Buffer receiving the bytes.
+ * @param length Number of bytes (1 to 255).
+ * @return int Returns 1 on success, 0 on a NACK, bus error or timeout.
+ */
+int I2C1_ReadRegister(uint8_t address, uint8_t reg, uint8_t *data, uint16_t length) {
+    I2C1->CR2 = ((uint32_t)address << 1) | (1U << I2C_CR2_NBYTES_Pos) | I2C_CR2_START;
+
+    if (!I2C1_WaitFlag(I2C_ISR_TXIS)) {
+        I2C1_Abort();
+        return 0;
+    }
+    I2C1->TXDR = reg;
+    if (!I2C1_WaitFlag(I2C_ISR_TC)) {
+        I2C1_Abort();
+        return 0;
+    }
+
+    I2C1->CR2 = ((uint32_t)address << 1) | I2C_CR2_RD_WRN | ((uint32_t)length << I2C_CR2_NBYTES_Pos) |
+                I2C_CR2_AUTOEND | I2C_CR2_START;
+    for (uint16_t i = 0; i < length; i++) {
+        if (!I2C1_WaitFlag(I2C_ISR_RXNE)) {
+            I2C1_Abort();
+            return 0;
+        }
+        data[i] = (uint8_t)I2C1->RXDR;
+    }
+    return I2C1_Finish();
+}
+
+/**
+ * @brief Returns the number of failed transfers since reset.
+ *
+ * @return uint32_t NACKs, bus errors and timeouts counted so far.
+ */
+uint32_t I2C1_ErrorCount(void) {
+    return error_count;
+}
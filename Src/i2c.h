@@ -0,0 +1,23 @@
+/**
+ * @file i2c.h
+ * @brief Header file for the I2C1 master driver.
+ *
+ * Declares polled register read and write transfers on I2C1 (PB8 = SCL,
+ * PB9 = SDA), used to talk to the STTS22H temperature sensor.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef I2C_H
+#define I2C_H
+
+#include <stdint.h>
+
+// Function Declarations
+void I2C1_Init(void);
+int I2C1_WriteRegister(uint8_t address, uint8_t reg, const uint8_t *data, uint16_t length);
+int I2C1_ReadRegister(uint8_t address, uint8_t reg, uint8_t *data, uint16_t length);
+uint32_t I2C1_ErrorCount(void);
+
+#endif // I2C_H
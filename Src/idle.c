@@ -0,0 +1,324 @@
+/**
+ * @file idle.c
+ * @brief Idle manager choosing Sleep or Stop mode from deadlines and wake sources.
+ *
+ * When the main loop has no work, idle_wait() puts the MCU into the
+ * deepest mode that still meets every obligation:
+ *
+ * - Stop, when no driver holds it off, USART2 can act as a wake source
+ *   (link idle, kernel clock on HSI) and the next timer wheel deadline is
+ *   at least IDLE_STOP_MIN_MS away. The RTC wakeup timer is armed for that
+ *   deadline; console input (EXTI 26) or an EXTI pin such as the button
+ *   ends Stop earlier. On wake the 48 MHz clock tree is restored,
+ *   interrupts are enabled so a console byte is read before it can be
+ *   overrun, and then the time measured by the RTC is added to the tick,
+ *   which runs every timeout that fell due.
+ * - Sleep otherwise; every interrupt, including SysTick, ends it.
+ *
+ * A Stop period lasts until the next deadline however far away it is,
+ * since the wheel jumps to it rather than stepping through every tick;
+ * with an empty wheel the RTC only wakes the MCU once an hour.
+ *
+ * Time spent in each mode, the wake sources of Stop and the reasons Stop
+ * was refused are counted and shown by the IDLE command.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include "stm32f0xx.h"
+#include "idle.h"
+#include "clock.h"
+#include "rtc.h"
+#include "tick.h"
+#include "timebase.h"
+#include "timeout.h"
+#include "event.h"
+#include "usart.h"
+#include "gpio.h"
+#include "rpc.h"
+#include "command_processor.h"
+
+// Power modes with residency counters
+enum {
+    IDLE_MODE_SLEEP,
+    IDLE_MODE_STOP,
+    IDLE_MODES
+};
+
+// What ended a Stop period
+enum {
+    IDLE_WAKE_USART, // Console input, EXTI line 26
+    IDLE_WAKE_EXTI,  // An EXTI pin, e.g. the button
+    IDLE_WAKE_RTC,   // Wakeup timer at the next deadline
+    IDLE_WAKE_OTHER, // Any other interrupt that was already pending
+    IDLE_WAKE_SOURCES
+};
+
+// Why Sleep was used instead of Stop
+enum {
+    IDLE_DENY_HOLD,     // A driver needs its clocks, e.g. a PWM pattern
+    IDLE_DENY_DEADLINE, // The next timeout is too close
+    IDLE_DENY_CONSOLE,  // USART2 cannot wake the MCU right now
+    IDLE_DENY_REASONS
+};
+
+static const char *const mode_names[IDLE_MODES] = {"Sleep", "Stop"};
+static const char *const wake_names[IDLE_WAKE_SOURCES] = {"USART", "EXTI", "RTC", "other"};
+static const char *const deny_names[IDLE_DENY_REASONS] = {"hold", "deadline", "console"};
+
+// Number of users that need clocks kept running, e.g. a PWM pattern
+static volatile int stop_holds = 0;
+// Statistics since the last IDLE CLEAR
+static uint64_t residency_us[IDLE_MODES];
+static uint32_t entries[IDLE_MODES];
+static uint32_t wakes[IDLE_WAKE_SOURCES];
+static uint32_t denials[IDLE_DENY_REASONS];
+static uint32_t stats_start = 0; // Tick of the last IDLE CLEAR
+
+/**
+ * @brief Starts the RTC used to time and end Stop periods.
+ *
+ * Call once at startup, after tick_init().
+ */
+void idle_init(void) {
+    rtc_init();
+    stats_start = tick_ms();
+}
+
+/**
+ * @brief Keeps idle_wait() from entering Stop mode.
+ *
+ * Stop mode halts every timer clock and DMA transfer, so drivers that must
+ * keep running while the main loop is idle take a hold; plain Sleep is used
+ * instead. Holds may be taken and released from interrupt handlers.
+ */
+void idle_hold_stop(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    stop_holds++;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Releases a hold taken with idle_hold_stop().
+ */
+void idle_release_stop(void) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (stop_holds > 0) {
+        stop_holds--;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Sleeps until the next interrupt; interrupts disabled.
+ *
+ * @param reason Why Stop mode was not used.
+ */
+static void idle_sleep(int reason) {
+    uint32_t start = timebase_us();
+
+    denials[reason]++;
+    __WFI(); // Pending interrupts still end WFI while PRIMASK is set
+    residency_us[IDLE_MODE_SLEEP] += timebase_us() - start;
+    entries[IDLE_MODE_SLEEP]++;
+}
+
+/**
+ * @brief Stops the MCU until a wake source fires or the delay ends; interrupts disabled.
+ *
+ * USART2 must have been armed with USART2_PrepareStop(). The tick is not
+ * advanced here, so the caller can enable interrupts first.
+ *
+ * @param delay_ms Time to the next deadline.
+ * @return uint32_t Milliseconds spent stopped, as measured by the RTC.
+ */
+static uint32_t idle_stop(uint32_t delay_ms) {
+    uint32_t start = rtc_ms();
+    uint32_t exti_pending;
+    uint32_t elapsed;
+    int rtc_fired, usart_woke;
+
+    rtc_wakeup_start(delay_ms);
+    PWR->CR = (PWR->CR & ~PWR_CR_PDDS) | PWR_CR_LPDS; // Stop, regulator in low-power mode
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+#if IDLE_WAKE_PROBE
+    gpio_set(GPIOA, 5);
+#endif
+    __WFI();
+#if IDLE_WAKE_PROBE
+    gpio_clear(GPIOA, 5);
+#endif
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    clock_restore(); // The core wakes up on HSI
+#if IDLE_WAKE_PROBE
+    gpio_set(GPIOA, 5); // SYSCLK is back at full speed
+#endif
+
+    // Find the wake source before the interrupt handlers clear the flags
+    exti_pending = EXTI->PR & EXTI->IMR & ~EXTI_PR_PR20;
+    rtc_fired = rtc_wakeup_stop();
+    usart_woke = USART2_FinishStop();
+    if (usart_woke) {
+        wakes[IDLE_WAKE_USART]++;
+    } else if (exti_pending != 0) {
+        wakes[IDLE_WAKE_EXTI]++;
+    } else if (rtc_fired) {
+        wakes[IDLE_WAKE_RTC]++;
+    } else {
+        wakes[IDLE_WAKE_OTHER]++;
+    }
+
+    elapsed = rtc_elapsed_ms(start);
+    residency_us[IDLE_MODE_STOP] += (uint64_t)elapsed * 1000U;
+    entries[IDLE_MODE_STOP]++;
+    return elapsed;
+}
+
+/**
+ * @brief Puts the MCU into Sleep or Stop until there is new work.
+ *
+ * Returns immediately if RX data or a main loop event is pending; both are
+ * checked with interrupts disabled, so nothing posted just before the WFI
+ * is missed. The interrupt that ended the wait runs on return, or, after
+ * Stop, before the tick catches up with the time spent stopped.
+ */
+void idle_wait(void) {
+    uint32_t expires;
+    uint32_t delay_ms = RTC_WAKEUP_MAX_MS;
+    uint32_t stopped_ms = 0;
+
+    __disable_irq();
+    if (USART2_RxPending() || event_pending()) {
+        __enable_irq();
+        return;
+    }
+
+    if (timeout_next_expiry(&expires)) {
+        int32_t remaining = (int32_t)(expires - tick_ms());
+
+        delay_ms = (remaining < IDLE_STOP_MIN_MS) ? 0 :
+                   ((uint32_t)remaining > RTC_WAKEUP_MAX_MS) ? RTC_WAKEUP_MAX_MS : (uint32_t)remaining;
+    }
+
+    if (stop_holds > 0) {
+        idle_sleep(IDLE_DENY_HOLD);
+    } else if (delay_ms == 0) {
+        idle_sleep(IDLE_DENY_DEADLINE);
+    } else if (!USART2_PrepareStop()) {
+        idle_sleep(IDLE_DENY_CONSOLE);
+    } else {
+        stopped_ms = idle_stop(delay_ms);
+    }
+    __enable_irq();
+
+    // SysTick did not run in Stop; account for the time the RTC saw pass
+    if (stopped_ms != 0) {
+        tick_advance(stopped_ms);
+    }
+}
+
+/**
+ * @brief Prints one residency line.
+ *
+ * @param name Mode name.
+ * @param us Time spent in the mode.
+ * @param total_us Time since the statistics were cleared.
+ */
+static void idle_print_residency(const char *name, uint64_t us, uint64_t total_us) {
+    uint32_t permille = (total_us != 0) ? (uint32_t)(us * 1000U / total_us) : 0;
+
+    printf("%-6s %10lu ms  %3lu.%lu%%", name, (unsigned long)(us / 1000U),
+           (unsigned long)(permille / 10U), (unsigned long)(permille % 10U));
+}
+
+/**
+ * @brief Handler for the "IDLE" command.
+ *
+ * SHOW (the default) prints the time spent running, sleeping and stopped
+ * since the last CLEAR, what woke the MCU from Stop, why Stop was refused,
+ * which wake sources are enabled and the measured LSI rate; CLEAR
+ * restarts the statistics.
+ *
+ * RPC result of SHOW: uint32 time since CLEAR, in Sleep and in Stop (ms),
+ * Sleep and Stop entries, Stop wakes by USART, EXTI, RTC and other, Sleep
+ * instead of Stop for hold, deadline and console, and the LSI rate in Hz.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: optional action.
+ */
+static void idle_command(int argc, char *argv[], const ArgValue *args) {
+    uint64_t total_us = (uint64_t)(tick_ms() - stats_start) * 1000U;
+    uint64_t asleep_us = residency_us[IDLE_MODE_SLEEP] + residency_us[IDLE_MODE_STOP];
+    uint32_t result[1 + 2 * IDLE_MODES + IDLE_WAKE_SOURCES + IDLE_DENY_REASONS + 1];
+    int n = 0;
+
+    if (argc > 0 && args[0].choice == 1) {
+        __disable_irq();
+        for (int i = 0; i < IDLE_MODES; i++) {
+            residency_us[i] = 0;
+            entries[i] = 0;
+        }
+        for (int i = 0; i < IDLE_WAKE_SOURCES; i++) {
+            wakes[i] = 0;
+        }
+        for (int i = 0; i < IDLE_DENY_REASONS; i++) {
+            denials[i] = 0;
+        }
+        stats_start = tick_ms();
+        __enable_irq();
+        printf("Idle statistics cleared\r\n");
+        return;
+    }
+
+    if (asleep_us > total_us) {
+        total_us = asleep_us; // Sleep is timed in us, the tick in ms
+    }
+    result[n++] = (uint32_t)(total_us / 1000U);
+    for (int i = 0; i < IDLE_MODES; i++) {
+        result[n++] = (uint32_t)(residency_us[i] / 1000U);
+    }
+    for (int i = 0; i < IDLE_MODES; i++) {
+        result[n++] = entries[i];
+    }
+    for (int i = 0; i < IDLE_WAKE_SOURCES; i++) {
+        result[n++] = wakes[i];
+    }
+    for (int i = 0; i < IDLE_DENY_REASONS; i++) {
+        result[n++] = denials[i];
+    }
+    result[n++] = rtc_lsi_hz();
+    rpc_result(result, sizeof(result));
+
+    idle_print_residency("Run", total_us - asleep_us, total_us);
+    printf("\r\n");
+    for (int i = 0; i < IDLE_MODES; i++) {
+        idle_print_residency(mode_names[i], residency_us[i], total_us);
+        printf("  %lu entries\r\n", (unsigned long)entries[i]);
+    }
+
+    printf("Stop wakes:");
+    for (int i = 0; i < IDLE_WAKE_SOURCES; i++) {
+        printf(" %s %lu", wake_names[i], (unsigned long)wakes[i]);
+    }
+    printf("\r\nSleep instead of Stop:");
+    for (int i = 0; i < IDLE_DENY_REASONS; i++) {
+        printf(" %s %lu", deny_names[i], (unsigned long)denials[i]);
+    }
+    printf("\r\nWake sources: %sRTC, EXTI lines 0x%05lX, holds %d\r\n",
+           (EXTI->IMR & EXTI_IMR_MR26) ? "USART, " : "",
+           (unsigned long)(EXTI->IMR & 0x7FFFFUL & ~EXTI_IMR_MR20), stop_holds);
+    printf("RTC clock: LSI %lu Hz\r\n", (unsigned long)rtc_lsi_hz());
+}
+
+static const char *const idle_actions[] = {"SHOW", "CLEAR", NULL};
+static const ArgSpec idle_args[] = {
+    ARG_ENUM("action", idle_actions),
+};
+REGISTER_COMMAND_ARGS(idle, "IDLE", idle_command, idle_args, 0);
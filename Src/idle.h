@@ -0,0 +1,23 @@
+/**
+ * @file idle.h
+ * @brief Header file for the Sleep/Stop idle manager.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <stdint.h>
+
+#define IDLE_STOP_MIN_MS 3    /**< Deadlines closer than this are waited out in Sleep mode */
+#define IDLE_WAKE_PROBE 0     /**< 1: pulse PA5 low from Stop wakeup to clock_restore() (scope wake latency) */
+
+// Function Declarations
+void idle_init(void);
+void idle_wait(void);
+void idle_hold_stop(void);
+void idle_release_stop(void);
+
+#endif // IDLE_H
@@ -0,0 +1,127 @@
+/**
+ * @file job.c
+ * @brief Cooperative background job table with JOBS and KILL commands.
+ *
+ * Jobs live in a fixed table of MAX_JOBS slots; each slot holds the step
+ * function and JOB_CONTEXT_SIZE bytes of state, so starting a job never
+ * allocates. jobs_run() gives every active job one step per call.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "job.h"
+#include "command_processor.h"
+
+// One job slot
+typedef struct {
+    JobStep step;        // NULL when the slot is free
+    const char *name;
+    uint16_t id;         // Number shown by JOBS and used by KILL
+    uint32_t context[JOB_CONTEXT_SIZE / sizeof(uint32_t)];
+} Job;
+
+static Job jobs[MAX_JOBS];
+static uint16_t next_id = 1;
+
+/**
+ * @brief Starts a background job.
+ *
+ * @param name Name shown by the JOBS command; must stay valid while the job runs.
+ * @param step Step function, called from the main loop until it returns JOB_DONE.
+ * @return void* Zeroed context of JOB_CONTEXT_SIZE bytes for the caller to
+ *               initialize, or NULL if all slots are in use.
+ */
+void *job_start(const char *name, JobStep step) {
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].step == NULL) {
+            memset(jobs[i].context, 0, sizeof(jobs[i].context));
+            jobs[i].name = name;
+            jobs[i].id = next_id++;
+            jobs[i].step = step;
+            printf("[%u] %s started\r\n", jobs[i].id, name);
+            return jobs[i].context;
+        }
+    }
+    printf("No free job slot (max %d)\r\n", MAX_JOBS);
+    return NULL;
+}
+
+/**
+ * @brief Runs one step of every active job.
+ *
+ * @return int Returns 1 if any job has more work ready right away, 0 if all
+ *             jobs are finished or waiting, so the caller may sleep.
+ */
+int jobs_run(void) {
+    int busy = 0;
+
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].step != NULL) {
+            JobStatus status = jobs[i].step(jobs[i].context);
+
+            if (status == JOB_DONE) {
+                jobs[i].step = NULL;
+            } else if (status == JOB_BUSY) {
+                busy = 1;
+            }
+        }
+    }
+    return busy;
+}
+
+/**
+ * @brief Stops every running job (Ctrl-C).
+ */
+void jobs_cancel_all(void) {
+    for (int i = 0; i < MAX_JOBS; i++) {
+        jobs[i].step = NULL;
+    }
+}
+
+/**
+ * @brief Handler for the "JOBS" command.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void jobs_command(int argc, char *argv[], const ArgValue *args) {
+    int count = 0;
+
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].step != NULL) {
+            printf("[%u] %s\r\n", jobs[i].id, jobs[i].name);
+            count++;
+        }
+    }
+    if (count == 0) {
+        printf("No jobs running\r\n");
+    }
+}
+
+/**
+ * @brief Handler for the "KILL" command.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: the job id.
+ */
+static void kill_command(int argc, char *argv[], const ArgValue *args) {
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].step != NULL && jobs[i].id == args[0].i) {
+            jobs[i].step = NULL;
+            printf("[%u] %s killed\r\n", jobs[i].id, jobs[i].name);
+            return;
+        }
+    }
+    printf("No job %ld\r\n", (long)args[0].i);
+}
+
+static const ArgSpec kill_args[] = {
+    ARG_INT("id", 1, 65535),
+};
+REGISTER_COMMAND(jobs_cmd, "JOBS", jobs_command);
+REGISTER_COMMAND_ARGS(kill_cmd, "KILL", kill_command, kill_args, 1);
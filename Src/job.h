@@ -0,0 +1,44 @@
+/**
+ * @file job.h
+ * @brief Header file for cooperative background jobs.
+ *
+ * A command handler that would otherwise run for a long time starts a job
+ * instead and returns at once. The main loop steps every active job
+ * cooperatively, so long-running output such as dumps and sensor streams
+ * can run side by side while the console stays responsive.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef JOB_H
+#define JOB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MAX_JOBS 4          /**< Jobs that can run at the same time */
+#define JOB_CONTEXT_SIZE 32 /**< Bytes of private state available to each job */
+
+/**
+ * @brief Result of one job step.
+ */
+typedef enum {
+    JOB_DONE,   /**< Finished; the slot is freed */
+    JOB_BUSY,   /**< More work is ready; step again as soon as possible */
+    JOB_WAITING /**< Waiting for an interrupt (e.g. TX space); the CPU may sleep */
+} JobStatus;
+
+/**
+ * @brief Step function of a job; must return quickly.
+ *
+ * @param context The job's private state, JOB_CONTEXT_SIZE bytes, zeroed at start.
+ */
+typedef JobStatus (*JobStep)(void *context);
+
+// Function Declarations
+void *job_start(const char *name, JobStep step);
+int jobs_run(void);
+void jobs_cancel_all(void);
+
+#endif // JOB_H
@@ -5,15 +5,36 @@
  * This file contains the implementation of functions to initialize,
  * turn on, and turn off the LED connected to pin PA5 on the STM32F0.
  *
+ * PA5 can also be switched to its TIM2_CH1 alternate function. Brightness
+ * patterns are then computed once into a RAM table of duty cycles, and
+ * DMA1 channel 2 copies one entry into TIM2_CCR1 on every timer update,
+ * circularly. Once a pattern is running it costs no CPU time.
+ *
  * @date 13 November 2024
  * @author Lokesh Senthil Kumar
  */
 
 #include "stm32f0xx.h"
-#include "LED.h"
+#include "led.h"
+#include "led_blink.h"
+#include "gpio.h"
+#include "idle.h"
+#include "clock.h"
+#include "command_processor.h"
+
+#define LED_PORT GPIOA
+#define LED_PIN 5
+// PA5 as a plain output, or on AF2 = TIM2_CH1 for PWM
+#define LED_PINS_GPIO(X) X(LED_PIN, GPIO_MODE_OUTPUT, 0, GPIO_PUSH_PULL, GPIO_NO_PULL)
+#define LED_PINS_PWM(X) X(LED_PIN, GPIO_MODE_AF, 2, GPIO_PUSH_PULL, GPIO_NO_PULL)
+#define LED_MASK GPIO_MASK(LED_PINS_GPIO) /**< Every LED line, switched together by one store */
+#define LED_PWM_FREQUENCY 500            /**< PWM frequency on PA5 in Hz, one pattern step per period */
+#define LED_PWM_STEPS 256                /**< Duty cycle resolution (TIM2 ARR + 1) */
+#define LED_PATTERN_MAX 1000             /**< Pattern table entries: 2 s at LED_PWM_FREQUENCY */
 
-#define led_outmode_clear (3U << (5 * 2))
-#define led_outmode_set (1U << (5 * 2))
+// Duty cycles played by DMA; one entry per PWM period
+static uint8_t pattern_table[LED_PATTERN_MAX];
+static int pwm_active = 0;
 /**
  * @brief Initializes the LED on PA5.
  *
@@ -23,9 +44,8 @@
 void LED_Init(void) {
     // Enable the clock for GPIOA (AHB Bus)
     RCC->AHBENR |= RCC_AHBENR_GPIOAEN;
-    GPIOA->MODER &= ~led_outmode_clear; // 3U (0b11) is used to clear both bits
-    // Set PA5 to output mode (01)
-    GPIOA->MODER |= led_outmode_set; // 1U (0b01) sets the pin to output mode
+    // Set PA5 to output mode
+    GPIO_CONFIGURE(LED_PORT, LED_PINS_GPIO);
 }
 
 /**
@@ -34,8 +54,10 @@ void LED_Init(void) {
  * This function sets the PA5 pin high, turning on the LED.
  */
 void LED_On(void) {
-    // Set the bit for PA5 in the GPIOA BSRR register
-    GPIOA->BSRR = GPIO_BSRR_BS_5;
+    LED_BlinkStop(LED_BLINK_USER);
+    LED_StopPattern();
+    // Set the LED bits in the GPIOA BSRR register
+    gpio_set_mask(LED_PORT, LED_MASK);
 }
 
 /**
@@ -44,6 +66,218 @@ void LED_On(void) {
  * This function resets the PA5 pin, turning off the LED.
  */
 void LED_Off(void) {
-    // Reset the bit for PA5 in the GPIOA BSRR register
-    GPIOA->BSRR = GPIO_BSRR_BR_5;
+    LED_BlinkStop(LED_BLINK_USER);
+    LED_StopPattern();
+    // Reset the LED bits in the GPIOA BRR register
+    gpio_clear_mask(LED_PORT, LED_MASK);
+}
+
+/**
+ * @brief Plays a table of duty cycles on PA5 with TIM2 PWM and circular DMA.
+ *
+ * Each entry is held for one PWM period (1 / LED_PWM_FREQUENCY) and the
+ * table repeats until LED_StopPattern(), LED_On() or LED_Off() is called.
+ * A running blink pattern is stopped first.
+ * Stop mode is held off meanwhile, because it would halt TIM2.
+ *
+ * @param table Duty cycles, 0 (off) to 255 (fully on); must stay valid while playing.
+ * @param length Number of entries.
+ */
+void LED_PlayPattern(const uint8_t *table, uint16_t length) {
+    LED_BlinkStop(LED_BLINK_USER);
+    LED_StopPattern();
+
+    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+
+    // TIM2 channel 1: PWM mode 1, preloaded so duty changes at the update event
+    TIM2->CR1 = 0;
+    TIM2->PSC = clock_timer_hz() / (LED_PWM_FREQUENCY * LED_PWM_STEPS) - 1;
+    TIM2->ARR = LED_PWM_STEPS - 1;
+    TIM2->CCMR1 = TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1PE;
+    TIM2->CCER = TIM_CCER_CC1E;
+    TIM2->CCR1 = table[0];
+    TIM2->EGR = TIM_EGR_UG;
+
+    // DMA1 channel 2 on TIM2_UP: bytes from the table into the 32-bit CCR1
+    DMA1_Channel2->CCR = 0;
+    DMA1->CSELR = (DMA1->CSELR & ~DMA_CSELR_C2S) | DMA1_CSELR_CH2_TIM2_UP;
+    DMA1_Channel2->CPAR = (uint32_t)(uintptr_t)&TIM2->CCR1;
+    DMA1_Channel2->CMAR = (uint32_t)(uintptr_t)table;
+    DMA1_Channel2->CNDTR = length;
+    DMA1_Channel2->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_DIR | DMA_CCR_PSIZE_1 | DMA_CCR_EN;
+
+    TIM2->DIER = TIM_DIER_UDE;
+    TIM2->CR1 = TIM_CR1_ARPE | TIM_CR1_CEN;
+
+    // Hand PA5 to TIM2_CH1
+    GPIO_CONFIGURE(LED_PORT, LED_PINS_PWM);
+
+    idle_hold_stop();
+    pwm_active = 1;
+}
+
+/**
+ * @brief Stops a running pattern and returns PA5 to a plain output.
+ */
+void LED_StopPattern(void) {
+    if (!pwm_active) {
+        return;
+    }
+    GPIO_CONFIGURE(LED_PORT, LED_PINS_GPIO);
+    TIM2->CR1 = 0;
+    TIM2->DIER = 0;
+    DMA1_Channel2->CCR = 0;
+    idle_release_stop();
+    pwm_active = 0;
+}
+
+/**
+ * @brief Maps a perceived brightness to a duty cycle.
+ *
+ * The eye is far more sensitive at low light levels, so a linear ramp of
+ * duty cycle looks like it jumps on and then barely changes. Squaring is
+ * a cheap approximation of the usual gamma curve.
+ *
+ * @param level Perceived brightness, 0 to 255.
+ * @return uint8_t Duty cycle, 0 to 255.
+ */
+static uint8_t led_gamma(uint32_t level) {
+    return (uint8_t)((level * level + 254) / 255);
+}
+
+/**
+ * @brief Fills the pattern table with a breathing curve: fade in, fade out.
+ *
+ * @param length Number of entries (at least 2).
+ */
+static void build_breathe(uint16_t length) {
+    uint16_t half = length / 2;
+
+    for (uint16_t i = 0; i < length; i++) {
+        uint32_t level = (i < half) ? (uint32_t)i * 255 / half : (uint32_t)(length - i) * 255 / (length - half);
+        pattern_table[i] = led_gamma(level);
+    }
+}
+
+/**
+ * @brief Fills the pattern table with a pulse code: `count` flashes, then a pause.
+ *
+ * The period is split into 2 * count + 2 equal slots: count on/off pairs
+ * and a two-slot pause, so codes with different counts are easy to tell apart.
+ *
+ * @param length Number of entries.
+ * @param count Number of flashes.
+ */
+static void build_pulse(uint16_t length, uint16_t count) {
+    uint16_t slots = 2 * count + 2;
+
+    for (uint16_t i = 0; i < length; i++) {
+        uint16_t slot = (uint32_t)i * slots / length;
+        pattern_table[i] = (slot < 2 * count && (slot & 1) == 0) ? 255 : 0;
+    }
+}
+
+/**
+ * @brief Fills the pattern table with a heartbeat: two beats that fade out, then a rest.
+ *
+ * @param length Number of entries.
+ */
+static void build_heartbeat(uint16_t length) {
+    uint16_t beat = length / 6; // Each beat decays over a sixth of the period
+
+    for (uint16_t i = 0; i < length; i++) {
+        uint32_t level = 0;
+
+        if (i < beat) {
+            level = (uint32_t)(beat - i) * 255 / beat;
+        } else if (i >= 2 * beat && i < 3 * beat) {
+            level = (uint32_t)(3 * beat - i) * 160 / beat; // Weaker second beat
+        }
+        pattern_table[i] = led_gamma(level);
+    }
 }
+
+/**
+ * @brief Handler for the "LED ON" command.
+ *
+ * This function turns on the LED by calling the `LED_On` function.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void led_on_command(int argc, char *argv[], const ArgValue *args) {
+    LED_On();
+}
+
+/**
+ * @brief Handler for the "LED OFF" command.
+ *
+ * This function turns off the LED by calling the `LED_Off` function.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void led_off_command(int argc, char *argv[], const ArgValue *args) {
+    LED_Off();
+}
+
+/**
+ * @brief Handler for the "LED PATTERN" command.
+ *
+ * Builds the requested curve in the pattern table and starts playing it.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: pattern, optional period in ms, optional pulse count.
+ */
+static void led_pattern_command(int argc, char *argv[], const ArgValue *args) {
+    uint32_t period = (argc > 1) ? (uint32_t)args[1].i : 1000;
+    uint16_t length = (uint16_t)(period * LED_PWM_FREQUENCY / 1000);
+    uint16_t count = (argc > 2) ? (uint16_t)args[2].i : 3;
+
+    LED_StopPattern(); // The table is about to change under the DMA
+    switch (args[0].choice) {
+    case 0:
+        build_breathe(length);
+        break;
+    case 1:
+        build_pulse(length, count);
+        break;
+    default:
+        build_heartbeat(length);
+        break;
+    }
+    LED_PlayPattern(pattern_table, length);
+}
+
+/**
+ * @brief Handler for the "LED DIM" command.
+ *
+ * Holds PA5 at a fixed brightness through PWM (a one-entry pattern).
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: brightness in percent.
+ */
+static void led_dim_command(int argc, char *argv[], const ArgValue *args) {
+    LED_StopPattern();
+    pattern_table[0] = led_gamma((uint32_t)args[0].i * 255 / 100);
+    LED_PlayPattern(pattern_table, 1);
+}
+
+static const char *const led_patterns[] = {"BREATHE", "PULSE", "HEARTBEAT", NULL};
+static const ArgSpec led_pattern_args[] = {
+    ARG_ENUM("pattern", led_patterns),
+    ARG_INT("period_ms", 100, LED_PATTERN_MAX * 1000 / LED_PWM_FREQUENCY),
+    ARG_INT("count", 1, 8),
+};
+static const ArgSpec led_dim_args[] = {
+    ARG_INT("percent", 0, 100),
+};
+REGISTER_COMMAND(led_on, "LED ON", led_on_command);
+REGISTER_COMMAND(led_off, "LED OFF", led_off_command);
+REGISTER_COMMAND_ARGS(led_pattern, "LED PATTERN", led_pattern_command, led_pattern_args, 1);
+REGISTER_COMMAND_ARGS(led_dim, "LED DIM", led_dim_command, led_dim_args, 1);
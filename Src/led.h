@@ -3,7 +3,8 @@
  * @brief Header file for LED control functions.
  *
  * This header file provides function declarations for initializing,
- * turning on, and turning off the LED connected to PA5 on the STM32F0.
+ * turning on, and turning off the LED connected to PA5 on the STM32F0,
+ * and for playing DMA-driven PWM brightness patterns on it.
  *
  * @date 13 November 2024
  * @author Lokesh Senthil Kumar
@@ -12,9 +13,13 @@
 #ifndef LED_H
 #define LED_H
 
+#include <stdint.h>
+
 // Function Declarations
 void LED_Init(void);
 void LED_On(void);
 void LED_Off(void);
+void LED_PlayPattern(const uint8_t *table, uint16_t length);
+void LED_StopPattern(void);
 
 #endif // LED_H
@@ -0,0 +1,217 @@
+/**
+ * @file led_blink.c
+ * @brief Timer-wheel driven LED blink scheduler with LED BLINK and LED CODE commands.
+ *
+ * Each active channel keeps one timeout on the shared timer wheel for its
+ * next edge. The callback changes the output and files the following edge
+ * relative to the previous one, so patterns do not drift, and an edge
+ * costs O(1) however many channels are blinking. The main loop never
+ * waits on a blink.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stddef.h>
+#include "stm32f0xx.h"
+#include "led_blink.h"
+#include "timeout.h"
+#include "led.h"
+#include "gpio.h"
+#include "command_processor.h"
+
+#define LED_CODE_ON_MS 200   /**< Pulse length of LED CODE */
+#define LED_CODE_OFF_MS 300  /**< Pause between pulses of LED CODE */
+#define LED_CODE_GAP_MS 1200 /**< Extra pause between repetitions of LED CODE */
+
+// State of one output
+typedef struct {
+    BlinkPattern pattern;
+    Timeout edge;         // Next edge on the timer wheel
+    uint16_t groups_left; // Groups still to run; unused when repeating forever
+    uint8_t pulses_left;  // Pulses left in the current group, including the one running
+    uint8_t on;           // Current output level
+    uint8_t active;       // A pattern is running
+} BlinkChannel;
+
+static BlinkChannel channels[LED_BLINK_CHANNELS];
+
+/**
+ * @brief Drives the output of a channel.
+ *
+ * @param channel Channel number.
+ * @param level 1 for on, 0 for off.
+ */
+static void blink_output(int channel, int level) {
+    switch (channel) {
+    case LED_BLINK_USER:
+        gpio_write(GPIOA, 5, level);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Ends the pattern of a channel and turns its output off.
+ *
+ * Must be called with interrupts disabled or from the tick interrupt.
+ *
+ * @param channel Channel number.
+ */
+static void blink_finish(int channel) {
+    if (!channels[channel].active) {
+        return;
+    }
+    timeout_cancel(&channels[channel].edge);
+    channels[channel].active = 0;
+    blink_output(channel, 0);
+}
+
+/**
+ * @brief Timer wheel callback: makes the due edge and files the next one.
+ *
+ * @param timeout The edge timeout of a channel.
+ */
+static void blink_edge(Timeout *timeout) {
+    BlinkChannel *blink = (BlinkChannel *)((char *)timeout - offsetof(BlinkChannel, edge));
+    int channel = (int)(blink - channels);
+    uint32_t next;
+
+    if (!blink->on) {
+        blink->on = 1;
+        blink_output(channel, 1);
+        next = blink->pattern.on_ms;
+    } else {
+        blink->on = 0;
+        blink_output(channel, 0);
+        if (--blink->pulses_left > 0) {
+            next = blink->pattern.off_ms;
+        } else if (blink->pattern.repeat != 0 && --blink->groups_left == 0) {
+            blink_finish(channel);
+            return;
+        } else {
+            blink->pulses_left = blink->pattern.pulses;
+            next = (uint32_t)blink->pattern.off_ms + blink->pattern.gap_ms;
+        }
+    }
+    timeout_start_at(timeout, timeout->expires + next, blink_edge);
+}
+
+/**
+ * @brief Starts a blink pattern on a channel, replacing any running one.
+ *
+ * The output turns on immediately. The pin keeps its level in Stop mode,
+ * and the idle manager wakes the MCU for each edge, so no Stop hold is needed.
+ *
+ * @param channel Channel number; out-of-range channels are ignored.
+ * @param pattern Pattern timing; copied, so it need not stay valid.
+ */
+void LED_BlinkStart(int channel, const BlinkPattern *pattern) {
+    BlinkChannel *blink;
+    uint32_t primask = __get_PRIMASK();
+
+    if (channel < 0 || channel >= LED_BLINK_CHANNELS) {
+        return;
+    }
+    blink = &channels[channel];
+    if (channel == LED_BLINK_USER) {
+        LED_StopPattern(); // Take PA5 back from PWM
+    }
+
+    __disable_irq();
+    blink_finish(channel);
+
+    blink->pattern = *pattern;
+    blink->groups_left = pattern->repeat;
+    blink->pulses_left = pattern->pulses;
+    blink->on = 1;
+    blink->active = 1;
+    blink_output(channel, 1);
+    timeout_start(&blink->edge, pattern->on_ms, blink_edge);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Stops the pattern on a channel and turns its output off.
+ *
+ * Does nothing if the channel is idle, so it is safe to call before
+ * taking over the pin for something else.
+ *
+ * @param channel Channel number; out-of-range channels are ignored.
+ */
+void LED_BlinkStop(int channel) {
+    uint32_t primask = __get_PRIMASK();
+
+    if (channel < 0 || channel >= LED_BLINK_CHANNELS) {
+        return;
+    }
+    __disable_irq();
+    blink_finish(channel);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Handler for the "LED BLINK" command.
+ *
+ * Blinks the LED with the given period and duty cycle (default 50 percent)
+ * for `count` cycles, or until replaced when the count is 0 or omitted.
+ * The command returns at once; the tick interrupt does the blinking.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: period in ms, optional duty in percent, optional count.
+ */
+static void led_blink_command(int argc, char *argv[], const ArgValue *args) {
+    uint32_t period = (uint32_t)args[0].i;
+    uint32_t duty = (argc > 1) ? (uint32_t)args[1].i : 50;
+    BlinkPattern pattern;
+
+    // Keep both phases at least one tick long, so every cycle is visible
+    pattern.on_ms = (uint16_t)(period * duty / 100);
+    if (pattern.on_ms == 0) {
+        pattern.on_ms = 1;
+    }
+    if (pattern.on_ms >= period) {
+        pattern.on_ms = (uint16_t)(period - 1);
+    }
+    pattern.off_ms = (uint16_t)(period - pattern.on_ms);
+    pattern.gap_ms = 0;
+    pattern.pulses = 1;
+    pattern.repeat = (argc > 2) ? (uint16_t)args[2].i : 0;
+    LED_BlinkStart(LED_BLINK_USER, &pattern);
+}
+
+/**
+ * @brief Handler for the "LED CODE" command.
+ *
+ * Flashes the LED in groups of `pulses` short pulses separated by a long
+ * pause, `repeat` times, or until replaced when the repeat is 0 or omitted.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: pulses per group, optional number of groups.
+ */
+static void led_code_command(int argc, char *argv[], const ArgValue *args) {
+    BlinkPattern pattern = {
+        .on_ms = LED_CODE_ON_MS,
+        .off_ms = LED_CODE_OFF_MS,
+        .gap_ms = LED_CODE_GAP_MS,
+        .pulses = (uint8_t)args[0].i,
+        .repeat = (argc > 1) ? (uint16_t)args[1].i : 0,
+    };
+
+    LED_BlinkStart(LED_BLINK_USER, &pattern);
+}
+
+static const ArgSpec led_blink_args[] = {
+    ARG_INT("period_ms", 20, 10000),
+    ARG_INT("duty", 1, 99),
+    ARG_INT("count", 0, 10000),
+};
+static const ArgSpec led_code_args[] = {
+    ARG_INT("pulses", 1, 9),
+    ARG_INT("repeat", 0, 1000),
+};
+REGISTER_COMMAND_ARGS(led_blink, "LED BLINK", led_blink_command, led_blink_args, 1);
+REGISTER_COMMAND_ARGS(led_code, "LED CODE", led_code_command, led_code_args, 1);
@@ -0,0 +1,36 @@
+/**
+ * @file led_blink.h
+ * @brief Header file for the timer-wheel driven LED blink scheduler.
+ *
+ * A blink pattern is a group of `pulses` on/off cycles followed by a gap,
+ * repeated `repeat` times (0 = forever). A plain blink is one pulse per
+ * group with no gap.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef LED_BLINK_H
+#define LED_BLINK_H
+
+#include <stdint.h>
+
+#define LED_BLINK_CHANNELS 1 /**< Outputs driven by the scheduler (PA5) */
+#define LED_BLINK_USER 0     /**< Channel of the user LED */
+
+/**
+ * @brief Timing of a blink pattern, in ticks (ms).
+ */
+typedef struct {
+    uint16_t on_ms;  /**< Time on per pulse */
+    uint16_t off_ms; /**< Time off between pulses of a group */
+    uint16_t gap_ms; /**< Extra time off after each group */
+    uint8_t pulses;  /**< Pulses per group, at least 1 */
+    uint16_t repeat; /**< Number of groups, 0 to repeat forever */
+} BlinkPattern;
+
+// Function Declarations
+void LED_BlinkStart(int channel, const BlinkPattern *pattern);
+void LED_BlinkStop(int channel);
+
+#endif // LED_BLINK_H
@@ -0,0 +1,339 @@
+/**
+ * @file line_editor.c
+ * @brief Console line editor with history and incremental redraw.
+ *
+ * Characters from the RX path are fed in one at a time. The editor keeps
+ * the line and the cursor position, and echoes only what changed on the
+ * terminal: a plain append costs one byte, and recalling a history entry
+ * rewrites only the part after the common prefix. This keeps editing
+ * responsive at 19200 baud.
+ *
+ * Supported keys: printable characters, Backspace/DEL, Delete (ESC[3~),
+ * Left/Right, Home/End (and Ctrl-A/Ctrl-E), Up/Down for history, Ctrl-U to
+ * erase up to the cursor, Ctrl-C to discard the line and Tab to complete
+ * command names and keyword arguments.
+ *
+ * RAM budget: one edit buffer plus LINE_HISTORY_DEPTH history slots, all
+ * LINE_EDITOR_LENGTH bytes each.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <string.h>
+#include "line_editor.h"
+#include "usart.h"
+#include "command_processor.h"
+
+// Control characters
+#define KEY_CTRL_A 0x01
+#define KEY_CTRL_C 0x03
+#define KEY_CTRL_E 0x05
+#define KEY_BACKSPACE 0x08
+#define KEY_TAB 0x09
+#define KEY_CTRL_U 0x15
+#define KEY_ESCAPE 0x1B
+#define KEY_DELETE 0x7F
+
+// Escape sequence parser states
+typedef enum {
+    ESCAPE_NONE,     // Normal input
+    ESCAPE_START,    // Got ESC
+    ESCAPE_CSI,      // Got ESC [ or ESC O
+    ESCAPE_PARAMETER // Got ESC [ <digit>, waiting for '~'
+} EscapeState;
+
+static char line[LINE_EDITOR_LENGTH];
+static int length = 0;  // Characters in the line
+static int cursor = 0;  // Cursor position within the line
+
+static char history[LINE_HISTORY_DEPTH][LINE_EDITOR_LENGTH];
+static int history_newest = -1; // Slot of the most recent entry, -1 when empty
+static int history_count = 0;
+static int history_offset = 0;  // 0 = editing a new line, n = n-th newest entry
+
+static EscapeState escape_state = ESCAPE_NONE;
+static char escape_parameter;
+static uint8_t last_char;
+
+/**
+ * @brief Queues terminal output, waiting for TX space if needed.
+ *
+ * @param data Bytes to send.
+ * @param count Number of bytes.
+ */
+static void editor_write(const char *data, int count) {
+    while (count > 0) {
+        int queued = USART2_Write((const uint8_t *)data, count);
+        data += queued;
+        count -= queued;
+    }
+}
+
+/**
+ * @brief Sends the same character several times.
+ *
+ * @param ch Character to send.
+ * @param count Number of repetitions.
+ */
+static void editor_repeat(char ch, int count) {
+    for (; count > 0; count--) {
+        editor_write(&ch, 1);
+    }
+}
+
+/**
+ * @brief Moves the terminal cursor to a position in the line.
+ *
+ * Moving left sends backspaces; moving right re-sends the characters
+ * already there, which is cheaper than an escape sequence.
+ *
+ * @param position Target position.
+ */
+static void move_cursor(int position) {
+    if (position < cursor) {
+        editor_repeat('\b', cursor - position);
+    } else if (position > cursor) {
+        editor_write(&line[cursor], position - cursor);
+    }
+    cursor = position;
+}
+
+/**
+ * @brief Redraws the line from the cursor to the end and restores the cursor.
+ *
+ * @param erased Number of stale characters to blank past the new end.
+ */
+static void redraw_tail(int erased) {
+    editor_write(&line[cursor], length - cursor);
+    editor_repeat(' ', erased);
+    editor_repeat('\b', length - cursor + erased);
+}
+
+/**
+ * @brief Inserts a printable character at the cursor.
+ *
+ * @param ch Character to insert.
+ */
+static void insert_char(char ch) {
+    if (length >= LINE_EDITOR_LENGTH - 1) {
+        return; // Line full
+    }
+    memmove(&line[cursor + 1], &line[cursor], length - cursor);
+    line[cursor] = ch;
+    length++;
+    editor_write(&line[cursor], 1);
+    cursor++;
+    if (cursor < length) {
+        redraw_tail(0);
+    }
+}
+
+/**
+ * @brief Deletes characters from the line.
+ *
+ * @param position First character to delete.
+ * @param count Number of characters to delete.
+ */
+static void delete_chars(int position, int count) {
+    if (count <= 0) {
+        return;
+    }
+    move_cursor(position);
+    memmove(&line[position], &line[position + count], length - position - count);
+    length -= count;
+    redraw_tail(count);
+}
+
+/**
+ * @brief Replaces the whole line, redrawing only what differs.
+ *
+ * @param text New line contents.
+ */
+static void replace_line(const char *text) {
+    int new_length = (int)strlen(text);
+    int common = 0;
+    int old_length = length;
+
+    while (common < length && common < new_length && line[common] == text[common]) {
+        common++;
+    }
+    move_cursor(common);
+    memcpy(&line[common], &text[common], new_length - common);
+    length = new_length;
+    editor_write(&line[common], length - common);
+    if (old_length > length) {
+        editor_repeat(' ', old_length - length);
+        editor_repeat('\b', old_length - length);
+    }
+    cursor = length;
+}
+
+/**
+ * @brief Completes the word at the end of the line.
+ *
+ * Only the completing characters are sent. If the command processor lists
+ * several candidates instead, the line is redrawn below the list.
+ */
+static void complete_line(void) {
+    char insert[LINE_EDITOR_LENGTH];
+    int count;
+
+    if (cursor != length) {
+        return; // Only complete at the end of the line
+    }
+    line[length] = '\0';
+    count = command_complete(line, insert, LINE_EDITOR_LENGTH - 1 - length);
+    if (count < 0) {
+        editor_write(line, length);
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        insert_char(insert[i]);
+    }
+}
+
+/**
+ * @brief Shows an older or newer history entry in place of the line.
+ *
+ * @param step +1 for an older entry, -1 for a newer one.
+ */
+static void recall_history(int step) {
+    int offset = history_offset + step;
+
+    if (offset < 0 || offset > history_count) {
+        return;
+    }
+    history_offset = offset;
+    if (offset == 0) {
+        replace_line("");
+    } else {
+        int slot = (history_newest - (offset - 1) + LINE_HISTORY_DEPTH) % LINE_HISTORY_DEPTH;
+        replace_line(history[slot]);
+    }
+}
+
+/**
+ * @brief Stores the finished line in the history ring.
+ *
+ * Empty lines and repeats of the newest entry are not stored; once the
+ * ring is full the oldest entry is overwritten.
+ */
+static void save_history(void) {
+    if (length == 0 || (history_count > 0 && strcmp(history[history_newest], line) == 0)) {
+        return;
+    }
+    history_newest = (history_newest + 1) % LINE_HISTORY_DEPTH;
+    memcpy(history[history_newest], line, length + 1);
+    if (history_count < LINE_HISTORY_DEPTH) {
+        history_count++;
+    }
+}
+
+/**
+ * @brief Handles the final character of an escape sequence.
+ *
+ * @param ch The character.
+ */
+static void handle_escape(uint8_t ch) {
+    switch (ch) {
+    case 'A': recall_history(+1); break;  // Up
+    case 'B': recall_history(-1); break;  // Down
+    case 'C': if (cursor < length) move_cursor(cursor + 1); break; // Right
+    case 'D': if (cursor > 0) move_cursor(cursor - 1); break;      // Left
+    case 'H': move_cursor(0); break;      // Home
+    case 'F': move_cursor(length); break; // End
+    default: break;
+    }
+}
+
+/**
+ * @brief Feeds one received character to the line editor.
+ *
+ * @param ch The received character.
+ * @return char* The finished, NUL-terminated line when Enter is pressed,
+ *               NULL otherwise. The buffer is valid until the next call and
+ *               may be modified by the caller.
+ */
+char *line_editor_feed(uint8_t ch) {
+    uint8_t previous = last_char;
+    last_char = ch;
+
+    switch (escape_state) {
+    case ESCAPE_START:
+        escape_state = (ch == '[' || ch == 'O') ? ESCAPE_CSI : ESCAPE_NONE;
+        return NULL;
+    case ESCAPE_CSI:
+        if (ch >= '0' && ch <= '9') {
+            escape_parameter = (char)ch;
+            escape_state = ESCAPE_PARAMETER;
+        } else {
+            escape_state = ESCAPE_NONE;
+            handle_escape(ch);
+        }
+        return NULL;
+    case ESCAPE_PARAMETER:
+        escape_state = ESCAPE_NONE;
+        if (ch == '~') {
+            if (escape_parameter == '3' && cursor < length) {
+                delete_chars(cursor, 1);  // Delete
+            } else if (escape_parameter == '1' || escape_parameter == '7') {
+                move_cursor(0);           // Home
+            } else if (escape_parameter == '4' || escape_parameter == '8') {
+                move_cursor(length);      // End
+            }
+        }
+        return NULL;
+    case ESCAPE_NONE:
+        break;
+    }
+
+    switch (ch) {
+    case '\n':
+        if (previous == '\r') {
+            return NULL; // Second half of CRLF
+        }
+        // Fall through
+    case '\r':
+        editor_write("\r\n", 2);
+        line[length] = '\0';
+        save_history();
+        length = 0;
+        cursor = 0;
+        history_offset = 0;
+        return line;
+    case KEY_BACKSPACE:
+    case KEY_DELETE:
+        if (cursor > 0) {
+            delete_chars(cursor - 1, 1);
+        }
+        break;
+    case KEY_CTRL_U:
+        delete_chars(0, cursor);
+        break;
+    case KEY_TAB:
+        complete_line();
+        break;
+    case KEY_CTRL_A:
+        move_cursor(0);
+        break;
+    case KEY_CTRL_E:
+        move_cursor(length);
+        break;
+    case KEY_CTRL_C:
+        editor_write("^C\r\n", 4);
+        length = 0;
+        cursor = 0;
+        history_offset = 0;
+        break;
+    case KEY_ESCAPE:
+        escape_state = ESCAPE_START;
+        break;
+    default:
+        if (ch >= 0x20 && ch < 0x7F) {
+            insert_char((char)ch);
+        }
+        break;
+    }
+    return NULL;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file line_editor.h
+ * @brief Header file for the console line editor.
+ *
+ * Declares the line editor that sits on the console RX path. It provides
+ * backspace, cursor movement, Ctrl-U and a command history ring in a fixed
+ * RAM budget, and redraws only the characters that change.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef LINE_EDITOR_H
+#define LINE_EDITOR_H
+
+#include <stdint.h>
+
+#define LINE_EDITOR_LENGTH 128 /**< Maximum line length including the terminator */
+#define LINE_HISTORY_DEPTH 8   /**< Number of lines kept in the history ring */
+
+// Function Declarations
+char *line_editor_feed(uint8_t ch);
+
+#endif // LINE_EDITOR_H
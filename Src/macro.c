@@ -0,0 +1,517 @@
+/**
+ * @file macro.c
+ * @brief Named command macros recorded into a flash page and replayed on demand.
+ *
+ * "MACRO RECORD <name>" starts recording: every command entered until
+ * "MACRO END" is run as usual and also appended to the macro page.
+ * "MACRO RUN <name>" replays it. Commands are stored pre-tokenized: the
+ * command id, the already converted ArgValue array and the argument
+ * tokens. Replay therefore calls the handlers directly, with no
+ * tokenizing, table lookup or argument conversion.
+ *
+ * Page layout: a MacroPageHeader followed by records appended in order
+ * (BEGIN, COMMAND..., END). Free space is erased flash (tag 0xFFFF). A
+ * macro is deleted by overwriting its BEGIN tag with 0x0000, so only
+ * "MACRO ERASE" ever erases the page. Command ids are positions in the
+ * dispatch index, so the header stores command_signature(); macros
+ * recorded by a firmware with a different command set are refused.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include "macro.h"
+#include "flash.h"
+
+#define MACRO_FLASH_ADDRESS 0x0803F800U /**< Last page of the 256 KB flash */
+#define MACRO_MAGIC 0x4F43414DU         /**< "MACO" */
+#define MACRO_NAME_LENGTH 15            /**< Longest macro name */
+#define MACRO_TOKEN_BYTES 128           /**< Longest stored argument text */
+#define MACRO_COMMAND_PREFIX "MACRO "     /**< Leading word of the commands in this file */
+
+// Record tags
+#define TAG_FREE 0xFFFFU    // Erased flash, end of the records
+#define TAG_DELETED 0x0000U // BEGIN of a deleted macro
+#define TAG_BEGIN 0x4D42U
+#define TAG_COMMAND 0x4D43U
+#define TAG_END 0x4D45U
+
+// Start of the macro page
+typedef struct {
+    uint32_t magic;
+    uint32_t signature; // command_signature() of the firmware that wrote the page
+} MacroPageHeader;
+
+// Common header of every record; size includes it and is a multiple of 4
+typedef struct {
+    uint16_t tag;
+    uint16_t size;
+} MacroRecord;
+
+// BEGIN record
+typedef struct {
+    MacroRecord record;
+    char name[MACRO_NAME_LENGTH + 1];
+} MacroBeginRecord;
+
+// COMMAND record, followed by ArgValue values[argc] and the NUL-separated tokens
+typedef struct {
+    MacroRecord record;
+    uint8_t id;
+    uint8_t argc;
+    uint16_t token_bytes;
+} MacroCommandRecord;
+
+#define MACRO_PAGE ((const MacroPageHeader *)(uintptr_t)MACRO_FLASH_ADDRESS)
+#define RECORD_AT(offset) ((const MacroRecord *)(uintptr_t)(MACRO_FLASH_ADDRESS + (offset)))
+
+// Firmware image bounds, defined in the linker script: the initial values
+// of .data are stored in flash right after .text and .rodata
+extern uint8_t _sidata;
+extern uint8_t _sdata;
+extern uint8_t _edata;
+
+static int recording = 0;
+
+/**
+ * @brief Checks that the firmware image ends before the macro page.
+ *
+ * The page is not reserved in the linker script, so an image that has
+ * grown into it must never be erased or parsed as macros.
+ *
+ * @param report Non-zero to print why the page cannot be used.
+ * @return int Returns 1 if the image lies entirely below the page.
+ */
+static int page_clear_of_image(int report) {
+    uint32_t image_end = (uint32_t)(uintptr_t)&_sidata + (uint32_t)(&_edata - &_sdata);
+
+    if (image_end > MACRO_FLASH_ADDRESS) {
+        if (report) {
+            printf("Firmware image reaches 0x%08lX, overlapping the macro page\r\n", (unsigned long)image_end);
+        }
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Checks whether the page holds macros usable by this firmware.
+ *
+ * @param report Non-zero to print why the page cannot be used.
+ * @return int Returns 1 if the page is valid and matches the command set.
+ */
+static int page_usable(int report) {
+    if (!page_clear_of_image(report)) {
+        return 0;
+    }
+    if (MACRO_PAGE->magic != MACRO_MAGIC) {
+        if (report) {
+            printf("No macros stored\r\n");
+        }
+        return 0;
+    }
+    if (MACRO_PAGE->signature != command_signature()) {
+        if (report) {
+            printf("Macros were recorded by a different firmware, use MACRO ERASE\r\n");
+        }
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Erases the macro page and writes a fresh header.
+ *
+ * Refuses to touch the page if the firmware image overlaps it. Prints the
+ * reason on failure.
+ *
+ * @return int Returns 1 on success, 0 on failure.
+ */
+static int page_format(void) {
+    MacroPageHeader header = {MACRO_MAGIC, command_signature()};
+
+    if (!page_clear_of_image(1)) {
+        return 0;
+    }
+    if (!flash_erase_page(MACRO_FLASH_ADDRESS) ||
+        !flash_program(MACRO_FLASH_ADDRESS, &header, sizeof(header))) {
+        printf("Flash error\r\n");
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Returns the offset of the record following the given one.
+ *
+ * @param offset Offset of a record.
+ * @return uint32_t Offset of the next record, or FLASH_PAGE_SIZE at the end
+ *                  of the records or if the record is corrupt.
+ */
+static uint32_t next_record(uint32_t offset) {
+    uint16_t size = RECORD_AT(offset)->size;
+
+    if (RECORD_AT(offset)->tag == TAG_FREE || size < sizeof(MacroRecord) || (size & 3U) != 0 ||
+        size > FLASH_PAGE_SIZE - offset) {
+        return FLASH_PAGE_SIZE;
+    }
+    return offset + size;
+}
+
+/**
+ * @brief Checks that a record is large enough for a structure and lies in the page.
+ *
+ * Only the record header is read, so this is safe on any record offset
+ * below the page end.
+ *
+ * @param offset Offset of a record.
+ * @param bytes Bytes the caller is about to read from the record.
+ * @return int Returns 1 if the record's size covers them and ends inside the page.
+ */
+static int record_holds(uint32_t offset, uint32_t bytes) {
+    uint16_t size = RECORD_AT(offset)->size;
+
+    return size >= bytes && size <= FLASH_PAGE_SIZE - offset;
+}
+
+/**
+ * @brief Tells whether a command is one of the MACRO commands.
+ *
+ * MACRO commands are never recorded, so replay treats a stored one as
+ * corruption; replaying MACRO RUN would otherwise recurse without bound.
+ *
+ * @param command A registered command.
+ * @return int Returns 1 for MACRO commands.
+ */
+static int is_macro_command(const Command *command) {
+    return strncasecmp(command->command, MACRO_COMMAND_PREFIX, sizeof(MACRO_COMMAND_PREFIX) - 1) == 0;
+}
+
+/**
+ * @brief Validates a COMMAND record against the page and the command table.
+ *
+ * The header fields are only trusted once the record is known to hold
+ * them, and the arguments and tokens they describe must fit in the record.
+ * The page is the last page of flash, so reading past it would fault.
+ * Stored values get the same range checks as typed arguments.
+ *
+ * @param offset Offset of a COMMAND record.
+ * @param argv Array of MAX_ARGS entries receiving the argument tokens.
+ * @param tokens Buffer of MACRO_TOKEN_BYTES bytes receiving the token text.
+ * @return const Command* The command to run, or NULL if the record is corrupt.
+ */
+static const Command *load_command_record(uint32_t offset, char *argv[], char *tokens) {
+    const MacroCommandRecord *stored = (const MacroCommandRecord *)RECORD_AT(offset);
+    const ArgValue *values = (const ArgValue *)(stored + 1);
+    const Command *command;
+    char *token = tokens;
+    char *end;
+
+    if (!record_holds(offset, sizeof(MacroCommandRecord)) || stored->argc > MAX_ARGS ||
+        stored->token_bytes > MACRO_TOKEN_BYTES ||
+        sizeof(MacroCommandRecord) + stored->argc * sizeof(ArgValue) + stored->token_bytes > stored->record.size) {
+        return NULL;
+    }
+    command = command_by_id(stored->id);
+    if (command == NULL || is_macro_command(command) || stored->argc > command->nargs ||
+        stored->argc < command->required) {
+        return NULL;
+    }
+
+    memcpy(tokens, values + stored->argc, stored->token_bytes);
+    end = tokens + stored->token_bytes;
+    for (int i = 0; i < stored->argc; i++) {
+        char *terminator = memchr(token, '\0', end - token);
+
+        if (terminator == NULL || !arg_check(&command->args[i], &values[i]) ||
+            (command->args[i].type == ARG_TYPE_WORD && values[i].length != terminator - token)) {
+            return NULL;
+        }
+        argv[i] = token;
+        token = terminator + 1;
+    }
+    return command;
+}
+
+/**
+ * @brief Finds the first free byte after the records.
+ *
+ * @return uint32_t Offset of the free space, FLASH_PAGE_SIZE if the page is full.
+ */
+static uint32_t free_offset(void) {
+    uint32_t offset = sizeof(MacroPageHeader);
+
+    while (offset < FLASH_PAGE_SIZE && RECORD_AT(offset)->tag != TAG_FREE) {
+        offset = next_record(offset);
+    }
+    return offset;
+}
+
+/**
+ * @brief Finds a complete (END-terminated) macro by name.
+ *
+ * @param name Macro name, compared case-insensitively.
+ * @return uint32_t Offset of its BEGIN record, or 0 if there is no such macro.
+ */
+static uint32_t find_macro(const char *name) {
+    for (uint32_t offset = sizeof(MacroPageHeader); offset < FLASH_PAGE_SIZE; offset = next_record(offset)) {
+        const MacroBeginRecord *begin = (const MacroBeginRecord *)RECORD_AT(offset);
+
+        // Bounded compare: a damaged record may lack its terminator
+        if (begin->record.tag == TAG_BEGIN && record_holds(offset, sizeof(MacroBeginRecord)) &&
+            strncasecmp(begin->name, name, sizeof(begin->name)) == 0) {
+            for (uint32_t end = next_record(offset); end < FLASH_PAGE_SIZE; end = next_record(end)) {
+                if (RECORD_AT(end)->tag == TAG_END) {
+                    return offset;
+                }
+                if (RECORD_AT(end)->tag != TAG_COMMAND) {
+                    break; // Recording was interrupted
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Appends a record to the page.
+ *
+ * @param record Record to write; record->size must already be set.
+ * @return int Returns 1 on success, 0 if the page is full or programming failed.
+ */
+static int append_record(const MacroRecord *record) {
+    uint32_t offset = free_offset();
+
+    if (record->size > FLASH_PAGE_SIZE - offset) {
+        return 0;
+    }
+    return flash_program(MACRO_FLASH_ADDRESS + offset, record, record->size);
+}
+
+/**
+ * @brief Stops recording after a failure, leaving the macro unterminated.
+ *
+ * An unterminated macro is ignored by MACRO RUN and MACRO LIST.
+ */
+static void abort_recording(void) {
+    recording = 0;
+    printf("Macro storage full or flash error, recording stopped\r\n");
+}
+
+/**
+ * @brief Handler for the "MACRO RECORD" command.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments: the macro name.
+ * @param args Converted arguments (not used in this handler).
+ */
+static void macro_record(int argc, char *argv[], const ArgValue *args) {
+    MacroBeginRecord begin = {{TAG_BEGIN, sizeof(MacroBeginRecord)}, {0}};
+
+    if (recording) {
+        printf("Already recording\r\n");
+        return;
+    }
+    if (MACRO_PAGE->magic != MACRO_MAGIC && !page_format()) {
+        return;
+    }
+    if (!page_usable(1)) {
+        return;
+    }
+    if (find_macro(argv[0]) != 0) {
+        printf("Macro %s already exists, delete it first\r\n", argv[0]);
+        return;
+    }
+
+    strncpy(begin.name, argv[0], MACRO_NAME_LENGTH);
+    if (!append_record(&begin.record)) {
+        abort_recording();
+        return;
+    }
+    recording = 1;
+    printf("Recording %s, finish with MACRO END\r\n", begin.name);
+}
+
+/**
+ * @brief Handler for the "MACRO END" command.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void macro_end(int argc, char *argv[], const ArgValue *args) {
+    MacroRecord end = {TAG_END, sizeof(MacroRecord)};
+
+    if (!recording) {
+        printf("Not recording\r\n");
+        return;
+    }
+    if (!append_record(&end)) {
+        abort_recording();
+        return;
+    }
+    recording = 0;
+    printf("Macro saved\r\n");
+}
+
+/**
+ * @brief Handler for the "MACRO RUN" command.
+ *
+ * Replays the stored commands in order. The converted arguments are used
+ * straight from flash; only the argument text is copied to RAM because
+ * handlers receive it as modifiable strings. Each record is validated
+ * before it is used, and replay stops at the first corrupt one.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments: the macro name.
+ * @param args Converted arguments (not used in this handler).
+ */
+static void macro_run(int argc, char *argv[], const ArgValue *args) {
+    uint32_t offset;
+
+    if (!page_usable(1)) {
+        return;
+    }
+    offset = find_macro(argv[0]);
+    if (offset == 0) {
+        printf("No macro named %s\r\n", argv[0]);
+        return;
+    }
+
+    for (offset = next_record(offset); offset < FLASH_PAGE_SIZE && RECORD_AT(offset)->tag == TAG_COMMAND;
+         offset = next_record(offset)) {
+        const MacroCommandRecord *stored = (const MacroCommandRecord *)RECORD_AT(offset);
+        char tokens[MACRO_TOKEN_BYTES];
+        char *command_argv[MAX_ARGS];
+        const Command *command = load_command_record(offset, command_argv, tokens);
+
+        if (command == NULL) {
+            printf("Corrupt macro record\r\n");
+            return;
+        }
+        command_execute(stored->id, stored->argc, command_argv, (const ArgValue *)(stored + 1));
+    }
+}
+
+/**
+ * @brief Handler for the "MACRO LIST" command.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void macro_list(int argc, char *argv[], const ArgValue *args) {
+    if (!page_usable(1)) {
+        return;
+    }
+    for (uint32_t offset = sizeof(MacroPageHeader); offset < FLASH_PAGE_SIZE; offset = next_record(offset)) {
+        const MacroBeginRecord *begin = (const MacroBeginRecord *)RECORD_AT(offset);
+
+        if (begin->record.tag == TAG_BEGIN && record_holds(offset, sizeof(MacroBeginRecord)) &&
+            find_macro(begin->name) == offset) {
+            int commands = 0;
+            for (uint32_t i = next_record(offset); i < FLASH_PAGE_SIZE && RECORD_AT(i)->tag == TAG_COMMAND;
+                 i = next_record(i)) {
+                commands++;
+            }
+            printf("%-16.*s %d commands\r\n", (int)sizeof(begin->name), begin->name, commands);
+        }
+    }
+    printf("%lu bytes free\r\n", (unsigned long)(FLASH_PAGE_SIZE - free_offset()));
+}
+
+/**
+ * @brief Handler for the "MACRO DELETE" command.
+ *
+ * Overwrites the BEGIN tag with 0x0000; the space is reclaimed by MACRO ERASE.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments: the macro name.
+ * @param args Converted arguments (not used in this handler).
+ */
+static void macro_delete(int argc, char *argv[], const ArgValue *args) {
+    uint16_t deleted = TAG_DELETED;
+    uint32_t offset;
+
+    if (!page_usable(1)) {
+        return;
+    }
+    offset = find_macro(argv[0]);
+    if (offset == 0) {
+        printf("No macro named %s\r\n", argv[0]);
+        return;
+    }
+    if (!flash_program(MACRO_FLASH_ADDRESS + offset, &deleted, sizeof(deleted))) {
+        printf("Flash error\r\n");
+    }
+}
+
+/**
+ * @brief Handler for the "MACRO ERASE" command.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void macro_erase(int argc, char *argv[], const ArgValue *args) {
+    recording = 0;
+    if (page_format()) {
+        printf("All macros erased\r\n");
+    }
+}
+
+static const ArgSpec macro_name_args[] = {
+    ARG_WORD("name", MACRO_NAME_LENGTH),
+};
+REGISTER_COMMAND_ARGS(macro_delete_cmd, "MACRO DELETE", macro_delete, macro_name_args, 1);
+REGISTER_COMMAND(macro_end_cmd, "MACRO END", macro_end);
+REGISTER_COMMAND(macro_erase_cmd, "MACRO ERASE", macro_erase);
+REGISTER_COMMAND(macro_list_cmd, "MACRO LIST", macro_list);
+REGISTER_COMMAND_ARGS(macro_record_cmd, "MACRO RECORD", macro_record, macro_name_args, 1);
+REGISTER_COMMAND_ARGS(macro_run_cmd, "MACRO RUN", macro_run, macro_name_args, 1);
+
+/**
+ * @brief Appends a command to the macro being recorded.
+ *
+ * Called by the command processor after the arguments were converted and
+ * before the handler runs. Does nothing unless recording; MACRO commands
+ * themselves are never recorded.
+ *
+ * @param id Id of the command about to run.
+ * @param argc Number of arguments.
+ * @param argv Argument tokens.
+ * @param args Converted arguments.
+ */
+void macro_record_command(int id, int argc, char *argv[], const ArgValue *args) {
+    static uint32_t buffer[(sizeof(MacroCommandRecord) + MAX_ARGS * sizeof(ArgValue) + MACRO_TOKEN_BYTES + 3) / 4];
+    MacroCommandRecord *stored = (MacroCommandRecord *)buffer;
+    char *tokens = (char *)((ArgValue *)(stored + 1) + argc);
+    uint32_t token_bytes = 0;
+
+    if (!recording || is_macro_command(command_by_id(id))) {
+        return;
+    }
+
+    for (int i = 0; i < argc; i++) {
+        uint32_t length = strlen(argv[i]) + 1;
+        if (token_bytes + length > MACRO_TOKEN_BYTES) {
+            printf("Arguments too long to record\r\n");
+            return;
+        }
+        memcpy(tokens + token_bytes, argv[i], length);
+        token_bytes += length;
+    }
+
+    stored->record.tag = TAG_COMMAND;
+    stored->record.size = (uint16_t)((sizeof(MacroCommandRecord) + argc * sizeof(ArgValue) + token_bytes + 3) & ~3U);
+    stored->id = (uint8_t)id;
+    stored->argc = (uint8_t)argc;
+    stored->token_bytes = (uint16_t)token_bytes;
+    memcpy(stored + 1, args, argc * sizeof(ArgValue));
+    if (!append_record(&stored->record)) {
+        abort_recording();
+    }
+}
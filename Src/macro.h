@@ -0,0 +1,20 @@
+/**
+ * @file macro.h
+ * @brief Header file for command macros stored in flash.
+ *
+ * Declares the hook the command processor uses to record commands while a
+ * macro is being recorded with "MACRO RECORD <name>".
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef MACRO_H
+#define MACRO_H
+
+#include "command_processor.h"
+
+// Function Declarations
+void macro_record_command(int id, int argc, char *argv[], const ArgValue *args);
+
+#endif // MACRO_H
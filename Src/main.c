@@ -5,22 +5,145 @@
 #include <string.h>
 #include <stdlib.h>
 #include "stm32f0xx.h"
+#include "clock.h"
 #include "usart.h"
 #include "led.h"
 #include "command_processor.h"
+#include "job.h"
+#include "rpc.h"
+#include "timebase.h"
+#include "tick.h"
+#include "idle.h"
+#include "health.h"
+#include "event.h"
+#include "button.h"
+#include "sensor.h"
+#include "sched.h"
+#include "line_editor.h"
 #include "stts22h_reg.h"
 
+/**
+ * @brief Acts on one event posted by a driver.
+ *
+ * A short press of the user button prints one temperature sample through
+ * a background job; a long press stops every job, like Ctrl-C. Timer
+ * expiries run their callbacks.
+ *
+ * @param event The event to handle.
+ */
+static void handle_event(const Event *event) {
+    switch (event->type) {
+    case EVENT_TIMER:
+        sched_timer_expired(event->data);
+        break;
+    case EVENT_BUTTON_SHORT:
+        if (!rpc_active()) { // No text output while the console is in binary mode
+            sensor_stream_start(1);
+        }
+        break;
+    case EVENT_BUTTON_LONG:
+        if (!rpc_active()) {
+            jobs_cancel_all();
+            printf("Button: all jobs stopped\r\n");
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Task: handles one event posted by an interrupt handler.
+ *
+ * @return int 1 if an event was handled, 0 if the queue was empty.
+ */
+static int event_task(void) {
+    Event event;
+
+    if (!event_get(&event)) {
+        return 0;
+    }
+    handle_event(&event);
+    return 1;
+}
+
+/**
+ * @brief Task: passes one received byte to the RPC decoder or the line editor.
+ *
+ * Reads straight from the RX buffer, bypassing stdin buffering. A complete
+ * line runs its command to completion before the task returns.
+ *
+ * @return int 1 if a byte was processed, 0 if the RX buffer was empty.
+ */
+static int console_task(void) {
+    uint8_t ch;
+    char *line;
+
+    if (!USART2_ReadByte(&ch)) {
+        return 0;
+    }
+
+    if (rpc_active()) {
+        rpc_feed(ch);
+        return 1;
+    }
+    if (rpc_escape(ch)) {
+        // Host automation switches to binary request/response frames
+        rpc_enter();
+        return 1;
+    }
+
+    if (ch == 0x03) {
+        // Ctrl-C stops all background jobs
+        jobs_cancel_all();
+    }
+    // The line editor echoes and returns the line once Enter is pressed
+    line = line_editor_feed(ch);
+    if (line != NULL && line[0] != '\0') {
+        process_command(line);
+    }
+    return 1;
+}
+
+/**
+ * @brief Task: steps each background job once.
+ *
+ * Jobs are paused in binary mode so their text cannot corrupt the frames.
+ *
+ * @return int 1 if a job has more work ready, 0 if all are idle or waiting.
+ */
+static int job_task(void) {
+    return !rpc_active() && jobs_run();
+}
+
+// Main loop tasks, highest priority first
+static const SchedTask tasks[] = {
+    event_task,
+    console_task,
+    job_task,
+};
+
 int main(void) {
+    // Run at 48 MHz; every driver below derives its dividers from the clock tree
+    clock_init();
     // Initialize USART2 for serial communication
     USART2_Init();
     // Initialize the GPIO for LED control
     LED_Init();
+    // Start the microsecond timebase used for command timing
+    timebase_init();
+    tick_init();
+    // Time Stop mode with the RTC so timeouts can wake the MCU
+    idle_init();
+    // Record the reset cause and start watching the main loop
+    health_init();
+    // Report user button presses as events
+    button_init();
+    // Build the command dispatch index from the registered commands
+    command_processor_init();
 
 
     printf("$$ Welcome to SerialIO!\r\n");
 
-    while (1) {
-        printf("123");
-
-    }
+    // Run the tasks; whenever none of them has work ready the MCU sleeps,
+    // or stops until the next timeout once TX has drained
+    sched_run(tasks, sizeof(tasks) / sizeof(tasks[0]));
 }
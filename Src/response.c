@@ -0,0 +1,102 @@
+/**
+ * @file response.c
+ * @brief Response arena and the console's _write() system call.
+ *
+ * newlib hands formatted printf output to _write(). The default
+ * implementation in syscalls.c passes it to __io_putchar() one character
+ * at a time; this strong definition replaces it. Between response_begin()
+ * and response_commit() the text is appended to the arena with memcpy.
+ * The whole response is then queued with one bulk write, so it reaches
+ * the TX buffer contiguously and cannot interleave with job output.
+ * Outside a command, output is written through in bulk directly.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "response.h"
+#include "usart.h"
+
+static char arena[RESPONSE_ARENA_SIZE];
+static int arena_length = 0;
+static int depth = 0; // Nesting of response_begin(), e.g. commands run by a macro
+
+/**
+ * @brief Sends the arena contents and empties it.
+ */
+static void response_flush(void) {
+    USART2_WriteAll((const uint8_t *)arena, arena_length);
+    arena_length = 0;
+}
+
+/**
+ * @brief Starts collecting a command's output in the arena.
+ *
+ * Calls may nest; only the outermost response_commit() sends the text.
+ */
+void response_begin(void) {
+    depth++;
+}
+
+/**
+ * @brief Ends a response and queues the collected output in one write.
+ */
+void response_commit(void) {
+    if (depth > 0 && --depth == 0) {
+        response_flush();
+    }
+}
+
+/**
+ * @brief Sends the output collected so far without ending the response.
+ *
+ * For commands that block for a while after printing a banner, so the
+ * banner reaches the host before the wait instead of after it.
+ */
+void response_send(void) {
+    fflush(stdout);
+    if (depth > 0) {
+        response_flush();
+    }
+}
+
+/**
+ * @brief newlib output hook for stdout and stderr.
+ *
+ * @param file File descriptor (only 1 and 2 are routed to the console).
+ * @param ptr Text to write.
+ * @param len Number of bytes.
+ * @return int Number of bytes accepted, or -1 for other descriptors.
+ */
+int _write(int file, char *ptr, int len) {
+    int remaining = len;
+
+    if (file != 1 && file != 2) {
+        return -1;
+    }
+    if (depth == 0) {
+        USART2_WriteAll((const uint8_t *)ptr, len);
+        return len;
+    }
+
+    while (remaining > 0) {
+        int chunk = RESPONSE_ARENA_SIZE - arena_length;
+
+        if (chunk == 0) {
+            // Larger than the arena: stream it block by block
+            response_flush();
+            continue;
+        }
+        if (chunk > remaining) {
+            chunk = remaining;
+        }
+        memcpy(arena + arena_length, ptr, chunk);
+        arena_length += chunk;
+        ptr += chunk;
+        remaining -= chunk;
+    }
+    return len;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file response.h
+ * @brief Header file for the command response arena.
+ *
+ * While a command runs, everything it prints is collected in a fixed-size
+ * arena and handed to the TX path in one bulk write when it finishes.
+ * Output larger than the arena is streamed in arena-sized blocks.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef RESPONSE_H
+#define RESPONSE_H
+
+#define RESPONSE_ARENA_SIZE 256 /**< Bytes collected before a block is sent */
+
+// Function Declarations
+void response_begin(void);
+void response_commit(void);
+void response_send(void);
+int _write(int file, char *ptr, int len);
+
+#endif // RESPONSE_H
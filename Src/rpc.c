@@ -0,0 +1,502 @@
+/**
+ * @file rpc.c
+ * @brief Binary request/response mode sharing the text CLI's command registry.
+ *
+ * Host automation sends RPC_ESCAPE_SEQUENCE and then exchanges CRC-checked frames
+ * instead of typing commands and scraping printf text. A CALL names the
+ * command by its dispatch index id and carries its arguments already
+ * converted, so the firmware skips tokenizing, lookup and number parsing.
+ * Handlers run unchanged. Handlers that have machine-readable results add
+ * packed fields with rpc_result(); their printf text is discarded unless
+ * the CALL sets RPC_CALL_TEXT, which captures it into the response.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "rpc.h"
+#include "usart.h"
+#include "timeout.h"
+#include "command_processor.h"
+
+#define RPC_TOKEN_BYTES 128 /**< Room for the argv text rebuilt from packed arguments */
+
+// DESCRIBE sends ArgType values as the protocol's type codes
+_Static_assert(ARG_TYPE_INT == RPC_ARG_INT && ARG_TYPE_HEX == RPC_ARG_HEX && ARG_TYPE_FIXED == RPC_ARG_FIXED &&
+               ARG_TYPE_ENUM == RPC_ARG_ENUM && ARG_TYPE_WORD == RPC_ARG_WORD,
+               "ArgType does not match the RPC argument type codes");
+// A CALL response is seq, status and result length, then the results
+_Static_assert(RPC_MAX_RESULT <= RPC_MAX_PAYLOAD - 3, "RPC_MAX_RESULT does not fit a response");
+
+// Receive state machine, one state per frame field
+typedef enum {
+    RPC_WAIT_SOF,
+    RPC_WAIT_LENGTH,
+    RPC_WAIT_PAYLOAD,
+    RPC_WAIT_CRC_LOW,
+    RPC_WAIT_CRC_HIGH
+} RpcRxState;
+
+static int active = 0;
+static int escape_matched = 0;     // Leading bytes of the escape sequence seen in text mode
+static Timeout idle_timeout;       // Ends binary mode when the host goes quiet
+static volatile uint8_t idle_expired = 0;
+static const uint8_t escape_sequence[RPC_ESCAPE_LENGTH] = RPC_ESCAPE_SEQUENCE;
+
+static struct {
+    RpcRxState state;
+    uint8_t length;
+    uint8_t count;
+    uint16_t crc;
+    uint8_t crc_low;
+    uint8_t payload[RPC_MAX_PAYLOAD];
+} rx;
+
+// Response being built; payload[0..1] are seq and status
+static struct {
+    uint8_t payload[RPC_MAX_PAYLOAD];
+    int length;
+    uint8_t capturing;  // A CALL is running and may add results and text
+    uint8_t truncated;  // Results or text did not fit
+    uint8_t result_length;
+    uint8_t result[RPC_MAX_RESULT];
+} tx;
+
+/**
+ * @brief Timeout callback: the host sent nothing for RPC_IDLE_TIMEOUT_MS.
+ *
+ * Runs in the tick interrupt, so it only flags the expiry; rpc_active()
+ * leaves binary mode in the main loop.
+ *
+ * @param timeout The idle timeout (not used).
+ */
+static void rpc_idle_expired(Timeout *timeout) {
+    idle_expired = 1;
+}
+
+/**
+ * @brief Restarts the idle timeout after a received byte.
+ */
+static void rpc_idle_restart(void) {
+    timeout_start(&idle_timeout, RPC_IDLE_TIMEOUT_MS, rpc_idle_expired);
+    idle_expired = 0;
+}
+
+/**
+ * @brief Returns the console to text mode.
+ */
+static void rpc_leave(void) {
+    timeout_cancel(&idle_timeout);
+    active = 0;
+}
+
+/**
+ * @brief Matches a text mode byte against the escape sequence.
+ *
+ * The sequence starts with a byte that appears nowhere else in it, so a
+ * mismatch only has to check whether it starts a new attempt.
+ *
+ * @param ch Byte received in text mode.
+ * @return int Returns 1 when ch completes RPC_ESCAPE_SEQUENCE, 0 otherwise.
+ */
+int rpc_escape(uint8_t ch) {
+    if (ch == escape_sequence[escape_matched]) {
+        escape_matched++;
+    } else {
+        escape_matched = (ch == escape_sequence[0]);
+    }
+    if (escape_matched == RPC_ESCAPE_LENGTH) {
+        escape_matched = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Switches the console into binary mode.
+ *
+ * Pending text output is flushed first so it cannot end up inside a frame.
+ */
+void rpc_enter(void) {
+    fflush(stdout);
+    rx.state = RPC_WAIT_SOF;
+    escape_matched = 0;
+    rpc_idle_restart();
+    active = 1;
+}
+
+/**
+ * @brief Reports whether the console is in binary mode.
+ *
+ * Leaves binary mode first if the idle timeout has expired.
+ *
+ * @return int Returns 1 in binary mode, 0 in text mode.
+ */
+int rpc_active(void) {
+    if (active && idle_expired) {
+        rpc_leave();
+    }
+    return active;
+}
+
+/**
+ * @brief Queues bytes for transmission, waiting for room in the TX buffer.
+ *
+ * @param data Bytes to send.
+ * @param length Number of bytes.
+ */
+static void rpc_write(const uint8_t *data, int length) {
+    while (length > 0) {
+        int queued = USART2_Write(data, length);
+
+        data += queued;
+        length -= queued;
+    }
+}
+
+/**
+ * @brief Adds a byte to the response payload.
+ *
+ * @param byte Byte to add.
+ * @return int Returns 1 if it fit, 0 if the payload is full.
+ */
+static int rpc_put(uint8_t byte) {
+    if (tx.length >= RPC_MAX_PAYLOAD) {
+        tx.truncated = 1;
+        return 0;
+    }
+    tx.payload[tx.length++] = byte;
+    return 1;
+}
+
+/**
+ * @brief Adds a 32-bit little-endian value to the response payload.
+ *
+ * @param value Value to add.
+ */
+static void rpc_put32(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        rpc_put((uint8_t)(value >> (8 * i)));
+    }
+}
+
+/**
+ * @brief Reads a 32-bit little-endian value from a request.
+ *
+ * @param data First byte of the value.
+ * @return uint32_t The value.
+ */
+static uint32_t rpc_get32(const uint8_t *data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/**
+ * @brief Output hook collecting a command's printf text into the response.
+ *
+ * @param ch Character printed by the handler.
+ * @return int Returns the character.
+ */
+static int rpc_capture(int ch) {
+    rpc_put((uint8_t)ch);
+    return ch;
+}
+
+/**
+ * @brief Output hook dropping a command's printf text.
+ *
+ * @param ch Character printed by the handler.
+ * @return int Returns the character.
+ */
+static int rpc_discard(int ch) {
+    return ch;
+}
+
+/**
+ * @brief Appends packed result fields to the response of the running CALL.
+ *
+ * Handlers call this unconditionally; outside a CALL it does nothing, so
+ * the same handler serves the text console and binary clients. The
+ * layout of the fields is part of each command's documentation.
+ *
+ * @param data Packed little-endian fields.
+ * @param length Number of bytes.
+ * @return int Returns 1 if the fields were added, 0 outside a CALL or if they do not fit.
+ */
+int rpc_result(const void *data, int length) {
+    if (!tx.capturing) {
+        return 0;
+    }
+    if (length > RPC_MAX_RESULT - tx.result_length) {
+        tx.truncated = 1;
+        return 0;
+    }
+    memcpy(tx.result + tx.result_length, data, length);
+    tx.result_length += length;
+    return 1;
+}
+
+/**
+ * @brief Sends the response payload as a frame.
+ */
+static void rpc_send_response(void) {
+    uint8_t header[2] = {RPC_SOF, (uint8_t)tx.length};
+    uint16_t crc = rpc_crc16_update(0xFFFF, header[1]);
+    uint8_t trailer[2];
+
+    for (int i = 0; i < tx.length; i++) {
+        crc = rpc_crc16_update(crc, tx.payload[i]);
+    }
+    trailer[0] = (uint8_t)crc;
+    trailer[1] = (uint8_t)(crc >> 8);
+    rpc_write(header, 2);
+    rpc_write(tx.payload, tx.length);
+    rpc_write(trailer, 2);
+}
+
+/**
+ * @brief Handles a HELLO request: protocol version and command table identity.
+ */
+static void rpc_hello(void) {
+    int count = 0;
+
+    while (command_by_id(count) != NULL) {
+        count++;
+    }
+    rpc_put(RPC_VERSION);
+    rpc_put32(command_signature());
+    rpc_put((uint8_t)count);
+    rpc_put(RPC_MAX_PAYLOAD);
+}
+
+/**
+ * @brief Handles a DESCRIBE request: name and argument specification of a command.
+ *
+ * @param data Request data: the command id.
+ * @param length Length of the request data.
+ * @return uint8_t Response status.
+ */
+static uint8_t rpc_describe(const uint8_t *data, int length) {
+    const Command *command = (length == 1) ? command_by_id(data[0]) : NULL;
+
+    if (command == NULL) {
+        return RPC_STATUS_BAD_COMMAND;
+    }
+    rpc_put(command->nargs);
+    rpc_put(command->required);
+    rpc_put(command->length);
+    for (int i = 0; i < command->length; i++) {
+        rpc_put((uint8_t)command->command[i]);
+    }
+    for (int i = 0; i < command->nargs; i++) {
+        rpc_put((uint8_t)command->args[i].type);
+        rpc_put(command->args[i].decimals);
+        rpc_put32((uint32_t)command->args[i].min);
+        rpc_put32((uint32_t)command->args[i].max);
+    }
+    return tx.truncated ? RPC_STATUS_TRUNCATED : RPC_STATUS_OK;
+}
+
+/**
+ * @brief Converts packed CALL arguments into the values and tokens a handler expects.
+ *
+ * Values are checked against the command's specification exactly as typed
+ * arguments would be, and argv[] is rebuilt so handlers that read the
+ * tokens behave the same in both modes.
+ *
+ * @param command The command being called.
+ * @param data Packed arguments, starting with argc.
+ * @param length Length of the packed arguments.
+ * @param argv Array of MAX_ARGS entries receiving the tokens.
+ * @param values Array of MAX_ARGS entries receiving the values.
+ * @param tokens Buffer of RPC_TOKEN_BYTES bytes holding the token text.
+ * @return int Number of arguments, or -1 if they are malformed or out of range.
+ */
+static int rpc_unpack_args(const Command *command, const uint8_t *data, int length,
+                           char *argv[], ArgValue *values, char *tokens) {
+    int argc;
+    int used = 0;
+    int offset = 1;
+
+    if (length < 1) {
+        return -1;
+    }
+    argc = data[0];
+    if (argc < command->required || argc > command->nargs || argc > MAX_ARGS) {
+        return -1;
+    }
+    for (int i = 0; i < argc; i++) {
+        const ArgSpec *spec = &command->args[i];
+        int token_length;
+
+        argv[i] = tokens + used;
+        if (spec->type == ARG_TYPE_WORD) {
+            if (offset >= length) {
+                return -1;
+            }
+            token_length = data[offset++];
+            if (token_length > length - offset || token_length >= RPC_TOKEN_BYTES - used ||
+                memchr(data + offset, '\0', token_length) != NULL) {
+                return -1;
+            }
+            memcpy(argv[i], data + offset, token_length);
+            argv[i][token_length] = '\0';
+            offset += token_length;
+            values[i].length = token_length;
+            if (!arg_check(spec, &values[i])) {
+                return -1;
+            }
+        } else {
+            if (length - offset < 4) {
+                return -1;
+            }
+            values[i].u = rpc_get32(data + offset);
+            offset += 4;
+            if (!arg_check(spec, &values[i])) {
+                return -1;
+            }
+            token_length = arg_format(spec, &values[i], argv[i], RPC_TOKEN_BYTES - used);
+            if (token_length < 0) {
+                return -1;
+            }
+        }
+        used += token_length + 1;
+    }
+    return (offset == length) ? argc : -1;
+}
+
+/**
+ * @brief Handles a CALL request: runs a command and returns its results and, if asked, its text.
+ *
+ * @param data Request data: command id, flags, then the packed arguments.
+ * @param length Length of the request data.
+ * @return uint8_t Response status.
+ */
+static uint8_t rpc_call(const uint8_t *data, int length) {
+    const Command *command = (length >= 2) ? command_by_id(data[0]) : NULL;
+    char *argv[MAX_ARGS];
+    ArgValue values[MAX_ARGS];
+    char tokens[RPC_TOKEN_BYTES];
+    int argc;
+    int header;
+
+    if (command == NULL) {
+        return RPC_STATUS_BAD_COMMAND;
+    }
+    argc = rpc_unpack_args(command, data + 2, length - 2, argv, values, tokens);
+    if (argc < 0) {
+        return RPC_STATUS_BAD_ARGS;
+    }
+
+    // Reserve the result length byte; the text follows the results
+    header = tx.length;
+    rpc_put(0);
+    tx.result_length = 0;
+    tx.capturing = 1;
+    USART2_SetOutputHook((data[1] & RPC_CALL_TEXT) ? rpc_capture : rpc_discard);
+    command_execute(data[0], argc, argv, values);
+    fflush(stdout);
+    USART2_SetOutputHook(NULL);
+    tx.capturing = 0;
+
+    // Move the captured text up to make room for the result fields
+    if (tx.length + tx.result_length > RPC_MAX_PAYLOAD) {
+        tx.length = RPC_MAX_PAYLOAD - tx.result_length;
+        tx.truncated = 1;
+    }
+    memmove(tx.payload + header + 1 + tx.result_length, tx.payload + header + 1, tx.length - header - 1);
+    memcpy(tx.payload + header + 1, tx.result, tx.result_length);
+    tx.payload[header] = tx.result_length;
+    tx.length += tx.result_length;
+    return tx.truncated ? RPC_STATUS_TRUNCATED : RPC_STATUS_OK;
+}
+
+/**
+ * @brief Executes a complete request frame and sends the response.
+ */
+static void rpc_dispatch(void) {
+    const uint8_t *data = rx.payload + 2;
+    int length = rx.length - 2;
+    uint8_t status = RPC_STATUS_OK;
+
+    if (rx.length < 2) {
+        return; // Too short to answer; the host times out and retries
+    }
+    tx.payload[0] = rx.payload[0];
+    tx.length = 2;
+    tx.truncated = 0;
+
+    switch (rx.payload[1]) {
+    case RPC_OP_HELLO:
+        rpc_hello();
+        break;
+    case RPC_OP_DESCRIBE:
+        status = rpc_describe(data, length);
+        break;
+    case RPC_OP_CALL:
+        status = rpc_call(data, length);
+        break;
+    case RPC_OP_EXIT:
+        rpc_leave();
+        break;
+    default:
+        status = RPC_STATUS_BAD_OP;
+        break;
+    }
+    if (status != RPC_STATUS_OK && status != RPC_STATUS_TRUNCATED) {
+        tx.length = 2; // Errors carry no data
+    }
+    tx.payload[1] = status;
+    rpc_send_response();
+}
+
+/**
+ * @brief Feeds one received byte to the frame decoder.
+ *
+ * Outside a frame, Ctrl-C or a bare CR returns the console to text mode
+ * and every other byte, including a repeated escape sequence, is ignored.
+ * Frames with a bad CRC are dropped without a response.
+ *
+ * @param ch Received byte.
+ */
+void rpc_feed(uint8_t ch) {
+    rpc_idle_restart();
+
+    switch (rx.state) {
+    case RPC_WAIT_SOF:
+        if (ch == RPC_SOF) {
+            rx.state = RPC_WAIT_LENGTH;
+        } else if (ch == 0x03 || ch == '\r') {
+            rpc_leave();
+        }
+        break;
+    case RPC_WAIT_LENGTH:
+        if (ch > RPC_MAX_PAYLOAD) {
+            rx.state = RPC_WAIT_SOF;
+            break;
+        }
+        rx.length = ch;
+        rx.count = 0;
+        rx.crc = rpc_crc16_update(0xFFFF, ch);
+        rx.state = (ch == 0) ? RPC_WAIT_CRC_LOW : RPC_WAIT_PAYLOAD;
+        break;
+    case RPC_WAIT_PAYLOAD:
+        rx.payload[rx.count++] = ch;
+        rx.crc = rpc_crc16_update(rx.crc, ch);
+        if (rx.count == rx.length) {
+            rx.state = RPC_WAIT_CRC_LOW;
+        }
+        break;
+    case RPC_WAIT_CRC_LOW:
+        rx.crc_low = ch;
+        rx.state = RPC_WAIT_CRC_HIGH;
+        break;
+    case RPC_WAIT_CRC_HIGH:
+        rx.state = RPC_WAIT_SOF;
+        if (rx.crc == (uint16_t)(rx.crc_low | (ch << 8))) {
+            rpc_dispatch();
+        }
+        break;
+    }
+}
@@ -0,0 +1,27 @@
+/**
+ * @file rpc.h
+ * @brief Header file for the binary RPC mode of the console.
+ *
+ * Declares the functions used by the main loop to detect the escape
+ * sequence, switch the console into binary mode and feed it received
+ * bytes, and by command handlers to return packed result fields. The
+ * frame format is in rpc_protocol.h.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef RPC_H
+#define RPC_H
+
+#include <stdint.h>
+#include "rpc_protocol.h"
+
+// Function Declarations
+int rpc_escape(uint8_t ch);
+void rpc_enter(void);
+int rpc_active(void);
+void rpc_feed(uint8_t ch);
+int rpc_result(const void *data, int length);
+
+#endif // RPC_H
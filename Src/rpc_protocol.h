@@ -0,0 +1,84 @@
+/**
+ * @file rpc_protocol.h
+ * @brief Frame format and opcodes of the binary RPC mode.
+ *
+ * Shared by the firmware and the host client library in Host/. Sending
+ * RPC_ESCAPE_SEQUENCE on the console switches it from text to binary
+ * mode; from then on every request and response is one frame:
+ *
+ *     RPC_SOF | length | payload[length] | crc16 (little endian)
+ *
+ * The CRC-16/CCITT (poly 0x1021, init 0xFFFF) covers the length byte and
+ * the payload. A request payload is `seq, op, data...`; the response
+ * echoes `seq` and follows it with a status byte and the op's data.
+ * Multi-byte fields are little endian.
+ *
+ * Outside a frame, Ctrl-C or a bare CR returns the console to text mode,
+ * as does RPC_IDLE_TIMEOUT_MS without a received byte, so an operator who
+ * lands in binary mode by accident gets the text console back.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef RPC_PROTOCOL_H
+#define RPC_PROTOCOL_H
+
+#include <stdint.h>
+
+// Console bytes that enter binary mode: Ctrl-B, then three bytes that never occur in UTF-8 text
+#define RPC_ESCAPE_SEQUENCE {0x02, 0xFF, 0xFE, 0xFD}
+#define RPC_ESCAPE_LENGTH 4
+#define RPC_IDLE_TIMEOUT_MS 5000U /**< Binary mode ends after this long without a received byte */
+#define RPC_SOF 0x7E          /**< First byte of every frame */
+#define RPC_MAX_PAYLOAD 200   /**< Largest payload in either direction */
+#define RPC_MAX_RESULT 192    /**< Largest block of packed result fields */
+#define RPC_VERSION 2
+
+// Request opcodes
+#define RPC_OP_HELLO 0x00    /**< -> version, command signature (4), command count, max payload */
+#define RPC_OP_DESCRIBE 0x01 /**< id -> nargs, required, name length, name, then per argument:
+                                  type, decimals, min (4), max (4) */
+#define RPC_OP_CALL 0x02     /**< id, flags, argc, packed arguments -> result length, results, text */
+#define RPC_OP_EXIT 0x03     /**< -> nothing; the console returns to text mode */
+
+// CALL flags
+#define RPC_CALL_TEXT 0x01   /**< Return the command's printf text; without it the text is discarded */
+
+// Response status codes
+#define RPC_STATUS_OK 0x00
+#define RPC_STATUS_BAD_OP 0x01      /**< Unknown opcode or malformed request */
+#define RPC_STATUS_BAD_COMMAND 0x02 /**< No command with that id */
+#define RPC_STATUS_BAD_ARGS 0x03    /**< Wrong argument count, type or range */
+#define RPC_STATUS_TRUNCATED 0x04   /**< Command ran, but its output did not fit the frame */
+
+// Argument type codes reported by DESCRIBE; equal to ArgType in arg_parser.h
+#define RPC_ARG_INT 0
+#define RPC_ARG_HEX 1
+#define RPC_ARG_FIXED 2
+#define RPC_ARG_ENUM 3
+#define RPC_ARG_WORD 4
+
+/*
+ * Packed CALL arguments, one per argument in specification order:
+ * RPC_ARG_WORD is a length byte followed by the characters, every other
+ * type is its ArgValue as a 32-bit integer (enum = choice index,
+ * fixed-point = scaled value).
+ */
+
+/**
+ * @brief Adds one byte to a CRC-16/CCITT.
+ *
+ * @param crc CRC so far (0xFFFF initially).
+ * @param byte Next byte.
+ * @return uint16_t The updated CRC.
+ */
+static inline uint16_t rpc_crc16_update(uint16_t crc, uint8_t byte) {
+    crc ^= (uint16_t)byte << 8;
+    for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+#endif // RPC_PROTOCOL_H
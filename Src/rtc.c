@@ -0,0 +1,236 @@
+/**
+ * @file rtc.c
+ * @brief RTC on LSI as a millisecond clock and Stop mode wakeup timer.
+ *
+ * The RTC is the only timer that keeps counting in Stop mode. The
+ * calendar is prescaled to about 1 kHz (PREDIV_A) and 1 Hz (PREDIV_S),
+ * so the subsecond register counts roughly milliseconds and rtc_ms() can
+ * measure how long the core was stopped. The wakeup timer ends a Stop
+ * period at the next software deadline through EXTI line 20.
+ *
+ * LSI is only specified to 30..50 kHz, so rtc_init() measures it first:
+ * TIM14 captures RTCCLK against the timer clock. The prescalers and
+ * wakeup counts are derived from the measured rate, which makes Stop
+ * timing about as accurate as the HSI48 or HSI oscillator behind SYSCLK
+ * (around 1 %) at the temperature and supply of the measurement. LSI
+ * drift after that is not tracked.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "stm32f0xx.h"
+#include "rtc.h"
+#include "clock.h"
+#include "timebase.h"
+
+#define RTC_ASYNC_HZ 1000U          /**< Target ck_apre; about one subsecond step per ms */
+#define RTC_CAL_EDGES 8U            /**< LSI periods per TIM14 capture (IC1 prescaler) */
+#define RTC_CAL_CAPTURES 16U        /**< Capture intervals averaged */
+#define RTC_CAL_TIMEOUT_US 20000U   /**< Longest wait for the captures */
+#define RTC_LSI_MIN_HZ 25000U       /**< Measurements outside this range are rejected */
+#define RTC_LSI_MAX_HZ 60000U
+
+static uint32_t lsi_hz = RTC_LSI_HZ;        // Measured LSI, nominal until rtc_init()
+static uint32_t sync_div = RTC_ASYNC_HZ;    // PREDIV_S + 1, subsecond steps per second
+static uint32_t wakeup_div16_hz = RTC_LSI_HZ / 16U; // Wakeup timer clock for short delays
+
+/**
+ * @brief Measures the LSI frequency with TIM14 input capture of RTCCLK.
+ *
+ * RTCCLK must already be LSI. TIM14 runs from the timer clock with
+ * channel 1 remapped to RTCCLK and captures every RTC_CAL_EDGES-th
+ * rising edge; the capture intervals are summed over RTC_CAL_CAPTURES
+ * periods. Takes about 4 ms.
+ *
+ * @return uint32_t LSI in Hz, or RTC_LSI_HZ if no plausible rate was seen.
+ */
+static uint32_t rtc_measure_lsi(void) {
+    uint32_t start, previous = 0, total = 0;
+    uint32_t captures = 0;
+    uint32_t measured;
+
+    RCC->APB1ENR |= RCC_APB1ENR_TIM14EN;
+    TIM14->CR1 = 0;
+    TIM14->PSC = 0;
+    TIM14->ARR = 0xFFFF;
+    TIM14->OR = TIM14_OR_TI1_RMP_0;                     // TI1 from RTCCLK
+    TIM14->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_IC1PSC; // IC1 on TI1, every 8th edge
+    TIM14->CCER = TIM_CCER_CC1E;
+    TIM14->EGR = TIM_EGR_UG;
+    TIM14->SR = 0;
+    TIM14->CR1 = TIM_CR1_CEN;
+
+    // Eight LSI periods are well under the 1.3 ms the 16-bit counter spans at 48 MHz
+    start = timebase_us();
+    while (captures <= RTC_CAL_CAPTURES && (timebase_us() - start) < RTC_CAL_TIMEOUT_US) {
+        if (TIM14->SR & TIM_SR_CC1IF) {
+            uint32_t capture = TIM14->CCR1;
+
+            TIM14->SR &= ~TIM_SR_CC1IF;
+            if (captures > 0) {
+                total += (capture - previous) & 0xFFFFU;
+            }
+            previous = capture;
+            captures++;
+        }
+    }
+
+    TIM14->CR1 = 0;
+    TIM14->CCER = 0;
+    RCC->APB1ENR &= ~RCC_APB1ENR_TIM14EN;
+
+    if (captures <= RTC_CAL_CAPTURES || total == 0) {
+        return RTC_LSI_HZ; // No RTCCLK edges
+    }
+    measured = (uint32_t)((uint64_t)clock_timer_hz() * RTC_CAL_EDGES * RTC_CAL_CAPTURES / total);
+    if (measured < RTC_LSI_MIN_HZ || measured > RTC_LSI_MAX_HZ) {
+        return RTC_LSI_HZ;
+    }
+    return measured;
+}
+
+/**
+ * @brief Starts LSI, measures it, and runs the RTC calendar from it at 1 Hz.
+ *
+ * The RTC sits in the backup domain, so writes need DBP and the write
+ * protection keys. The calendar starts at 00:00:00; only differences are
+ * used. Needs clock_init() and timebase_init() to have run.
+ */
+void rtc_init(void) {
+    uint32_t async_div;
+
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+    PWR->CR |= PWR_CR_DBP;
+
+    RCC->CSR |= RCC_CSR_LSION;
+    while ((RCC->CSR & RCC_CSR_LSIRDY) == 0);
+    if ((RCC->BDCR & RCC_BDCR_RTCSEL) != RCC_BDCR_RTCSEL_LSI) {
+        // The clock source can only be changed by resetting the backup domain
+        RCC->BDCR |= RCC_BDCR_BDRST;
+        RCC->BDCR &= ~RCC_BDCR_BDRST;
+        RCC->BDCR |= RCC_BDCR_RTCSEL_LSI;
+    }
+    RCC->BDCR |= RCC_BDCR_RTCEN;
+
+    // ck_apre near 1 kHz, then the synchronous divider closest to 1 Hz
+    lsi_hz = rtc_measure_lsi();
+    async_div = (lsi_hz + RTC_ASYNC_HZ / 2U) / RTC_ASYNC_HZ;
+    sync_div = (lsi_hz + async_div / 2U) / async_div;
+    wakeup_div16_hz = lsi_hz / 16U;
+
+    RTC->WPR = 0xCA;
+    RTC->WPR = 0x53;
+    RTC->ISR |= RTC_ISR_INIT;
+    while ((RTC->ISR & RTC_ISR_INITF) == 0);
+    RTC->PRER = ((async_div - 1U) << RTC_PRER_PREDIV_A_Pos) | (sync_div - 1U);
+    RTC->TR = 0;
+    RTC->CR |= RTC_CR_BYPSHAD; // Read the counters directly; no shadow sync after Stop
+    RTC->ISR &= ~RTC_ISR_INIT;
+
+    // Wakeup timer event on EXTI line 20, rising edge
+    EXTI->IMR |= EXTI_IMR_MR20;
+    EXTI->RTSR |= EXTI_RTSR_TR20;
+    NVIC_EnableIRQ(RTC_IRQn);
+}
+
+/**
+ * @brief Returns the LSI frequency measured by rtc_init().
+ *
+ * @return uint32_t LSI in Hz; RTC_LSI_HZ if the measurement failed.
+ */
+uint32_t rtc_lsi_hz(void) {
+    return lsi_hz;
+}
+
+/**
+ * @brief Returns the RTC time of day in milliseconds.
+ *
+ * With the shadow registers bypassed, TR and SSR are read until two
+ * readings agree, so a carry between them cannot tear the result.
+ *
+ * @return uint32_t Milliseconds since midnight, below RTC_DAY_MS.
+ */
+uint32_t rtc_ms(void) {
+    uint32_t tr, ssr;
+
+    do {
+        ssr = RTC->SSR & RTC_SSR_SS;
+        tr = RTC->TR;
+    } while (ssr != (RTC->SSR & RTC_SSR_SS) || tr != RTC->TR);
+
+    uint32_t hours = ((tr & RTC_TR_HT) >> RTC_TR_HT_Pos) * 10U + ((tr & RTC_TR_HU) >> RTC_TR_HU_Pos);
+    uint32_t minutes = ((tr & RTC_TR_MNT) >> RTC_TR_MNT_Pos) * 10U + ((tr & RTC_TR_MNU) >> RTC_TR_MNU_Pos);
+    uint32_t seconds = ((tr & RTC_TR_ST) >> RTC_TR_ST_Pos) * 10U + ((tr & RTC_TR_SU) >> RTC_TR_SU_Pos);
+
+    // SSR counts down from PREDIV_S within each second
+    return ((hours * 60U + minutes) * 60U + seconds) * 1000U + (sync_div - 1U - ssr) * 1000U / sync_div;
+}
+
+/**
+ * @brief Returns the milliseconds since an earlier rtc_ms() reading.
+ *
+ * @param since Earlier rtc_ms() value, less than a day ago.
+ * @return uint32_t Elapsed milliseconds.
+ */
+uint32_t rtc_elapsed_ms(uint32_t since) {
+    uint32_t now = rtc_ms();
+
+    return (now >= since) ? (now - since) : (now + RTC_DAY_MS - since);
+}
+
+/**
+ * @brief Arms the wakeup timer to fire once after a delay.
+ *
+ * Delays up to about 20 s count LSI/16 for sub-millisecond steps; longer
+ * ones count whole seconds and are rounded down, so the wakeup is never late.
+ *
+ * @param delay_ms Delay, 1 to RTC_WAKEUP_MAX_MS; larger values are clamped.
+ */
+void rtc_wakeup_start(uint32_t delay_ms) {
+    uint32_t wucksel, wutr;
+
+    if (delay_ms > RTC_WAKEUP_MAX_MS) {
+        delay_ms = RTC_WAKEUP_MAX_MS;
+    }
+    if (delay_ms < 65536U * 1000U / wakeup_div16_hz) {
+        wucksel = 0; // RTCCLK / 16
+        wutr = delay_ms * wakeup_div16_hz / 1000U;
+    } else {
+        wucksel = RTC_CR_WUCKSEL_2; // ck_spre, 1 Hz
+        wutr = delay_ms / 1000U;
+    }
+
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    while ((RTC->ISR & RTC_ISR_WUTWF) == 0);
+    RTC->WUTR = (wutr > 0) ? wutr - 1U : 0;
+    RTC->CR = (RTC->CR & ~RTC_CR_WUCKSEL) | wucksel;
+    RTC->ISR &= ~RTC_ISR_WUTF;
+    EXTI->PR = EXTI_PR_PR20;
+    RTC->CR |= RTC_CR_WUTE | RTC_CR_WUTIE;
+}
+
+/**
+ * @brief Disarms the wakeup timer and tells whether it had fired.
+ *
+ * @return int Returns 1 if the wakeup timer expired, 0 otherwise.
+ */
+int rtc_wakeup_stop(void) {
+    int fired = (RTC->ISR & RTC_ISR_WUTF) != 0;
+
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    RTC->ISR &= ~RTC_ISR_WUTF;
+    EXTI->PR = EXTI_PR_PR20;
+    return fired;
+}
+
+/**
+ * @brief RTC interrupt: acknowledges a wakeup timer event.
+ *
+ * Normally rtc_wakeup_stop() has cleared the flags before interrupts are
+ * enabled again; this only catches an expiry after that point.
+ */
+void RTC_IRQHandler(void) {
+    RTC->ISR &= ~RTC_ISR_WUTF;
+    EXTI->PR = EXTI_PR_PR20;
+}
@@ -0,0 +1,27 @@
+/**
+ * @file rtc.h
+ * @brief Header file for the RTC millisecond clock and wakeup timer.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef RTC_H
+#define RTC_H
+
+#include <stdint.h>
+
+#define RTC_LSI_HZ 40000U              /**< Nominal LSI, used if the measurement fails (30..50 kHz over parts and temperature) */
+#define RTC_DAY_MS 86400000U           /**< rtc_ms() wraps at midnight */
+#define RTC_WAKEUP_MAX_MS 3600000U     /**< Longest wakeup rtc_wakeup_start() accepts */
+
+// Function Declarations
+void rtc_init(void);
+uint32_t rtc_lsi_hz(void);
+uint32_t rtc_ms(void);
+uint32_t rtc_elapsed_ms(uint32_t since);
+void rtc_wakeup_start(uint32_t delay_ms);
+int rtc_wakeup_stop(void);
+void RTC_IRQHandler(void);
+
+#endif // RTC_H
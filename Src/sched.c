@@ -0,0 +1,147 @@
+/**
+ * @file sched.c
+ * @brief Run-to-completion scheduler with periodic timers and WFI idle.
+ *
+ * The main loop is a fixed, ordered list of tasks. Each pass gives every
+ * task one bounded unit of work in priority order; a task never blocks,
+ * so the worst-case response to an event is one pass. When no task has
+ * work ready the core sleeps in idle_wait() until an interrupt brings new
+ * work, so an idle system spends almost no time running.
+ *
+ * Periodic timers live on the shared timer wheel. An expiry only posts an
+ * EVENT_TIMER; the callback runs later from the event task in the main
+ * loop, so timer work never runs in interrupt context. A timer that is
+ * still pending when it expires again is not posted twice.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stddef.h>
+#include "stm32f0xx.h"
+#include "sched.h"
+#include "event.h"
+#include "health.h"
+#include "timeout.h"
+#include "idle.h"
+
+// State of one periodic timer
+typedef struct {
+    Timeout timeout;             // Next expiry on the timer wheel
+    SchedTimerCallback callback; // NULL when the slot is free
+    uint32_t period;
+    volatile uint8_t pending;    // Expiry posted but not yet handled
+    uint8_t generation;          // Bumped on every start, so stale expiries can be recognised
+} SchedTimer;
+
+static SchedTimer timers[SCHED_MAX_TIMERS];
+
+/**
+ * @brief Runs the tasks forever, sleeping whenever none has work ready.
+ *
+ * @param tasks Tasks in priority order, highest first.
+ * @param count Number of tasks.
+ */
+void sched_run(const SchedTask *tasks, int count) {
+    for (;;) {
+        int busy = 0;
+
+        // Each pass refreshes the watchdog and updates the health LED code
+        health_kick();
+        for (int i = 0; i < count; i++) {
+            busy |= tasks[i]();
+        }
+        if (!busy) {
+            health_idle();
+            idle_wait();
+        }
+    }
+}
+
+/**
+ * @brief Timer wheel callback: posts the expiry and files the next one.
+ *
+ * The next expiry is one period after this one, so the period does not
+ * drift. A timer whose last expiry is still pending is not posted again.
+ *
+ * @param timeout The timeout of a periodic timer.
+ */
+static void sched_timer_due(Timeout *timeout) {
+    SchedTimer *timer = (SchedTimer *)((char *)timeout - offsetof(SchedTimer, timeout));
+    uint32_t index = (uint32_t)(timer - timers);
+
+    timeout_start_at(timeout, timeout->expires + timer->period, sched_timer_due);
+    if (!timer->pending && event_post(EVENT_TIMER, index | ((uint32_t)timer->generation << 8))) {
+        timer->pending = 1;
+    }
+}
+
+/**
+ * @brief Starts a periodic timer.
+ *
+ * Timers do not hold off Stop mode; the idle manager wakes the MCU for
+ * the next expiry.
+ *
+ * @param period_ms Period in ticks (ms), at least 1; the first expiry is one period from now.
+ * @param callback Function to run in the main loop on each expiry.
+ * @return int Timer handle, or -1 if every slot is in use.
+ */
+int sched_timer_start(uint32_t period_ms, SchedTimerCallback callback) {
+    uint32_t primask = __get_PRIMASK();
+
+    for (int i = 0; i < SCHED_MAX_TIMERS; i++) {
+        if (timers[i].callback != NULL) {
+            continue;
+        }
+        __disable_irq();
+        timers[i].period = period_ms;
+        timers[i].pending = 0;
+        timers[i].generation++;
+        timers[i].callback = callback;
+        timeout_start(&timers[i].timeout, period_ms, sched_timer_due);
+        __set_PRIMASK(primask);
+        return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Stops a periodic timer; an expiry already posted is discarded.
+ *
+ * @param timer Handle from sched_timer_start(); out-of-range or stopped handles are ignored.
+ */
+void sched_timer_stop(int timer) {
+    uint32_t primask = __get_PRIMASK();
+
+    if (timer < 0 || timer >= SCHED_MAX_TIMERS) {
+        return;
+    }
+    __disable_irq();
+    if (timers[timer].callback != NULL) {
+        timeout_cancel(&timers[timer].timeout);
+        timers[timer].callback = NULL;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Runs the callback of an expired timer; called for each EVENT_TIMER.
+ *
+ * An expiry posted before the timer was stopped, or before its slot was
+ * reused, carries an old generation and is ignored.
+ *
+ * @param data Event data: timer handle in bits 0..7, generation in bits 8..15.
+ */
+void sched_timer_expired(uint32_t data) {
+    uint32_t timer = data & 0xFFU;
+    SchedTimerCallback callback;
+
+    if (timer >= SCHED_MAX_TIMERS || timers[timer].generation != (uint8_t)(data >> 8)) {
+        return;
+    }
+    callback = timers[timer].callback;
+    timers[timer].pending = 0;
+    if (callback != NULL) {
+        callback();
+    }
+}
@@ -0,0 +1,34 @@
+/**
+ * @file sched.h
+ * @brief Header file for the run-to-completion scheduler and its periodic timers.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+
+#define SCHED_MAX_TIMERS 4 /**< Periodic timers that can run at the same time */
+
+/**
+ * @brief One scheduler task; does one bounded unit of work and returns.
+ *
+ * @return int 1 if the task has more work ready now, 0 if it is waiting for an interrupt.
+ */
+typedef int (*SchedTask)(void);
+
+/**
+ * @brief Timer callback; runs in the main loop, never in an interrupt.
+ */
+typedef void (*SchedTimerCallback)(void);
+
+// Function Declarations
+void sched_run(const SchedTask *tasks, int count);
+int sched_timer_start(uint32_t period_ms, SchedTimerCallback callback);
+void sched_timer_stop(int timer);
+void sched_timer_expired(uint32_t data);
+
+#endif // SCHED_H
@@ -0,0 +1,376 @@
+/**
+ * @file sensor.c
+ * @brief STTS22H temperature sensor access and TEMP commands.
+ *
+ * Binds ST's platform-independent STTS22H driver to the I2C1 driver and
+ * takes one-shot conversions. "TEMP READ" prints one reading; "TEMP STREAM"
+ * runs as a background job that starts a conversion, polls for its end
+ * every SENSOR_POLL_MS and prints each sample once the TX buffer has room,
+ * so sampling overlaps with console input and other jobs and the CPU
+ * sleeps between polls.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stdio.h>
+#include "sensor.h"
+#include "i2c.h"
+#include "usart.h"
+#include "job.h"
+#include "rpc.h"
+#include "sched.h"
+#include "tick.h"
+#include "timebase.h"
+#include "timeout.h"
+#include "command_processor.h"
+#include "stts22h_reg.h"
+
+#define SENSOR_LINE_LENGTH 16      /**< Longest sample line, e.g. "-327.68 C\r\n" */
+#define SENSOR_READ_TIMEOUT_US 50000U /**< TEMP READ gives up after several one-shot conversion times */
+#define SENSOR_POLL_MS 2           /**< Interval between data-ready polls of a TEMP STREAM conversion */
+
+static int sensor_ready = 0;
+static int log_timer = -1;     // Periodic timer of TEMP LOG, -1 when off
+static int log_converting = 0; // TEMP LOG has a conversion in flight
+static Timeout stream_poll;    // Wakes the main loop for the next TEMP STREAM poll
+
+/**
+ * @brief stmdev_ctx_t write callback.
+ *
+ * @return int32_t 0 on success, -1 on a bus error (ST driver convention).
+ */
+static int32_t sensor_write(void *handle, uint8_t reg, const uint8_t *data, uint16_t length) {
+    return I2C1_WriteRegister(STTS22H_I2C_ADDRESS, reg, data, length) ? 0 : -1;
+}
+
+/**
+ * @brief stmdev_ctx_t read callback.
+ *
+ * @return int32_t 0 on success, -1 on a bus error (ST driver convention).
+ */
+static int32_t sensor_read(void *handle, uint8_t reg, uint8_t *data, uint16_t length) {
+    return I2C1_ReadRegister(STTS22H_I2C_ADDRESS, reg, data, length) ? 0 : -1;
+}
+
+static stmdev_ctx_t sensor_ctx = {
+    .write_reg = sensor_write,
+    .read_reg = sensor_read,
+};
+
+/**
+ * @brief Checks the sensor identity and prepares it for one-shot reads.
+ *
+ * Called on first use, so the board still starts without a sensor fitted.
+ *
+ * @return int Returns 1 if the sensor answered with the STTS22H id, 0 otherwise.
+ */
+int sensor_init(void) {
+    uint8_t id = 0;
+
+    if (sensor_ready) {
+        return 1;
+    }
+    I2C1_Init();
+    if (stts22h_dev_id_get(&sensor_ctx, &id) != 0 || id != STTS22H_ID) {
+        printf("No STTS22H at 0x%02X (id %02X)\r\n", STTS22H_I2C_ADDRESS, id);
+        return 0;
+    }
+    // The temperature is read as two consecutive registers
+    if (stts22h_auto_increment_set(&sensor_ctx, 1) != 0) {
+        return 0;
+    }
+    sensor_ready = 1;
+    return 1;
+}
+
+/**
+ * @brief Starts a one-shot conversion.
+ *
+ * @return int Returns 1 on success, 0 on a bus error.
+ */
+int sensor_start_conversion(void) {
+    return stts22h_temp_data_rate_set(&sensor_ctx, STTS22H_ONE_SHOT) == 0;
+}
+
+/**
+ * @brief Collects the result of a one-shot conversion if it has finished.
+ *
+ * @param centi_celsius Pointer to store the temperature in 0.01 degC.
+ * @return int Returns 1 with a new sample, 0 while converting, -1 on a bus error.
+ */
+int sensor_poll_conversion(int16_t *centi_celsius) {
+    uint8_t ready = 0;
+
+    if (stts22h_temp_flag_data_ready_get(&sensor_ctx, &ready) != 0) {
+        return -1;
+    }
+    if (!ready) {
+        return 0;
+    }
+    // The register value is already in hundredths of a degree
+    return (stts22h_temperature_raw_get(&sensor_ctx, centi_celsius) == 0) ? 1 : -1;
+}
+
+/**
+ * @brief Formats a temperature as "DD.DD C\r\n".
+ *
+ * @param line Buffer of at least SENSOR_LINE_LENGTH bytes.
+ * @param centi_celsius Temperature in 0.01 degC.
+ * @return int Number of characters written.
+ */
+static int format_sample(char *line, int16_t centi_celsius) {
+    int magnitude = (centi_celsius < 0) ? -centi_celsius : centi_celsius;
+
+    return snprintf(line, SENSOR_LINE_LENGTH, "%s%d.%02d C\r\n", (centi_celsius < 0) ? "-" : "",
+                    magnitude / 100, magnitude % 100);
+}
+
+/**
+ * @brief Handler for the "TEMP READ" command.
+ *
+ * Polls for the end of the conversion for at most SENSOR_READ_TIMEOUT_US,
+ * so a sensor that answers but never reports ready cannot stall the main
+ * loop.
+ *
+ * RPC result: int16 temperature in 0.01 degC.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void temp_read_command(int argc, char *argv[], const ArgValue *args) {
+    char line[SENSOR_LINE_LENGTH];
+    int16_t centi_celsius;
+    int status = 0;
+    uint32_t start;
+
+    if (!sensor_init()) {
+        return;
+    }
+    if (sensor_start_conversion()) {
+        start = timebase_us();
+        while (status == 0 && (timebase_us() - start) < SENSOR_READ_TIMEOUT_US) {
+            status = sensor_poll_conversion(&centi_celsius);
+        }
+    }
+    if (status != 1) {
+        printf("Temperature read failed\r\n");
+        return;
+    }
+    rpc_result(&centi_celsius, sizeof(centi_celsius));
+    format_sample(line, centi_celsius);
+    printf("%s", line);
+}
+
+// State of a TEMP STREAM job, kept in the job context
+typedef struct {
+    uint32_t remaining;  // Samples still to print, 0 for no limit
+    uint32_t poll_at;    // Tick of the next data-ready poll
+    uint8_t converting;  // A conversion has been started
+} TempStreamJob;
+_Static_assert(sizeof(TempStreamJob) <= JOB_CONTEXT_SIZE, "TempStreamJob does not fit a job context");
+
+/**
+ * @brief stream_poll callback; the expiry itself wakes the main loop.
+ *
+ * @param timeout The expired timeout (not used).
+ */
+static void temp_stream_wake(Timeout *timeout) {
+}
+
+/**
+ * @brief Schedules the next data-ready poll of a stream.
+ *
+ * All streams share stream_poll, which is kept at the earliest pending
+ * poll. It lives outside the job context, so a killed job at most causes
+ * one spurious wakeup.
+ *
+ * @param stream The stream to poll.
+ * @return JobStatus JOB_WAITING, for the caller to return.
+ */
+static JobStatus temp_stream_wait(TempStreamJob *stream) {
+    if (!timeout_active(&stream_poll) || (int32_t)(stream_poll.expires - stream->poll_at) > 0) {
+        timeout_start_at(&stream_poll, stream->poll_at, temp_stream_wake);
+    }
+    return JOB_WAITING;
+}
+
+/**
+ * @brief Job step: starts a conversion or prints its result.
+ *
+ * A conversion is only started once the TX buffer can hold its line, so a
+ * slow link lowers the sample rate instead of dropping samples. While it
+ * runs the job waits on a timeout and polls the sensor every
+ * SENSOR_POLL_MS, instead of keeping the main loop spinning on the bus.
+ * Other jobs may fill the TX buffer meanwhile, so the space is checked
+ * again before the result is collected; the sample waits in the sensor
+ * until its line fits.
+ *
+ * @param context The TempStreamJob of this stream.
+ * @return JobStatus JOB_WAITING while converting or waiting for TX space,
+ *                   JOB_BUSY once a sample was printed, JOB_DONE after the
+ *                   last sample or a bus error.
+ */
+static JobStatus temp_stream_step(void *context) {
+    TempStreamJob *stream = context;
+    char line[SENSOR_LINE_LENGTH];
+    int16_t centi_celsius;
+    int status;
+
+    if (!stream->converting) {
+        if (USART2_TxSpace() < SENSOR_LINE_LENGTH) {
+            return JOB_WAITING;
+        }
+        if (!sensor_start_conversion()) {
+            printf("TEMP STREAM: sensor not responding\r\n");
+            return JOB_DONE;
+        }
+        stream->converting = 1;
+        stream->poll_at = tick_ms() + SENSOR_POLL_MS;
+        return temp_stream_wait(stream);
+    }
+
+    // Woken by something else before the poll is due
+    if ((int32_t)(tick_ms() - stream->poll_at) < 0) {
+        return temp_stream_wait(stream);
+    }
+    if (USART2_TxSpace() < SENSOR_LINE_LENGTH) {
+        return JOB_WAITING; // The TX interrupt wakes the main loop as the buffer drains
+    }
+    status = sensor_poll_conversion(&centi_celsius);
+    if (status == 0) {
+        stream->poll_at = tick_ms() + SENSOR_POLL_MS;
+        return temp_stream_wait(stream);
+    }
+    if (status < 0) {
+        printf("TEMP STREAM: sensor not responding\r\n");
+        return JOB_DONE;
+    }
+    stream->converting = 0;
+    USART2_Write((const uint8_t *)line, format_sample(line, centi_celsius));
+    if (stream->remaining != 0 && --stream->remaining == 0) {
+        return JOB_DONE;
+    }
+    return JOB_BUSY;
+}
+
+/**
+ * @brief Starts a background job printing back-to-back samples.
+ *
+ * Returns at once; the samples are printed by the job as conversions
+ * complete, so callers such as event handlers never wait on the bus.
+ *
+ * @param count Samples to print, 0 to stream until the job is killed.
+ * @return int Returns 1 if the job was started, 0 if the sensor or a job slot is unavailable.
+ */
+int sensor_stream_start(uint32_t count) {
+    TempStreamJob *stream;
+
+    if (!sensor_init()) {
+        return 0;
+    }
+    stream = job_start("TEMP STREAM", temp_stream_step);
+    if (stream == NULL) {
+        return 0;
+    }
+    fflush(stdout); // Keep the job banner ahead of the samples
+    stream->remaining = count;
+    return 1;
+}
+
+/**
+ * @brief Handler for the "TEMP STREAM" command.
+ *
+ * Starts a background job printing back-to-back samples until the count
+ * is reached or the job is killed.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: optional sample count.
+ */
+static void temp_stream_command(int argc, char *argv[], const ArgValue *args) {
+    sensor_stream_start((argc > 0) ? (uint32_t)args[0].i : 0);
+}
+
+/**
+ * @brief Stops periodic logging.
+ */
+static void temp_log_stop(void) {
+    sched_timer_stop(log_timer);
+    log_timer = -1;
+    log_converting = 0;
+}
+
+/**
+ * @brief TEMP LOG timer callback: prints the last conversion and starts the next.
+ *
+ * Runs in the main loop once per period. The conversion started on one
+ * expiry is normally finished by the next, so nothing waits on the bus;
+ * if it is not, that period is skipped. Samples are dropped rather than
+ * queued while TX is full, which counts as a TX overflow in HEALTH, or
+ * while the console is in binary mode.
+ */
+static void temp_log_sample(void) {
+    char line[SENSOR_LINE_LENGTH];
+    int16_t centi_celsius;
+
+    if (log_converting) {
+        int status = sensor_poll_conversion(&centi_celsius);
+
+        if (status == 0) {
+            return;
+        }
+        log_converting = 0;
+        if (status < 0) {
+            temp_log_stop();
+            return;
+        }
+        if (!rpc_active()) {
+            USART2_WriteOrDrop((const uint8_t *)line, format_sample(line, centi_celsius));
+        }
+    }
+    if (!sensor_start_conversion()) {
+        temp_log_stop();
+        return;
+    }
+    log_converting = 1;
+}
+
+/**
+ * @brief Handler for the "TEMP LOG" command.
+ *
+ * Prints a sample every period_ms from a periodic timer, with no job and
+ * no busy waiting; without an argument, stops logging.
+ *
+ * @param argc Number of arguments.
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments: optional period in ms.
+ */
+static void temp_log_command(int argc, char *argv[], const ArgValue *args) {
+    temp_log_stop();
+    if (argc == 0) {
+        printf("Temperature logging off\r\n");
+        return;
+    }
+    if (!sensor_init()) {
+        return;
+    }
+    log_timer = sched_timer_start((uint32_t)args[0].i, temp_log_sample);
+    if (log_timer < 0) {
+        printf("No free timer\r\n");
+        return;
+    }
+    temp_log_sample(); // Start the first conversion now
+    printf("Logging temperature every %ld ms\r\n", (long)args[0].i);
+}
+
+static const ArgSpec temp_log_args[] = {
+    ARG_INT("period_ms", 10, 60000),
+};
+static const ArgSpec temp_stream_args[] = {
+    ARG_INT("count", 1, 100000),
+};
+REGISTER_COMMAND(temp_read, "TEMP READ", temp_read_command);
+REGISTER_COMMAND_ARGS(temp_stream, "TEMP STREAM", temp_stream_command, temp_stream_args, 0);
+REGISTER_COMMAND_ARGS(temp_log, "TEMP LOG", temp_log_command, temp_log_args, 0);
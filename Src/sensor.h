@@ -0,0 +1,26 @@
+/**
+ * @file sensor.h
+ * @brief Header file for the STTS22H temperature sensor module.
+ *
+ * Declares the one-shot temperature read used by the "TEMP READ" and
+ * "TEMP STREAM" commands. Temperatures are in hundredths of a degree
+ * Celsius, the sensor's native resolution, so no floating point is needed.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include <stdint.h>
+
+#define STTS22H_I2C_ADDRESS 0x3C /**< 7-bit address with ADDR strapped as on the SparkFun board */
+
+// Function Declarations
+int sensor_init(void);
+int sensor_start_conversion(void);
+int sensor_poll_conversion(int16_t *centi_celsius);
+int sensor_stream_start(uint32_t count);
+
+#endif // SENSOR_H
@@ -29,6 +29,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "tick.h"
 
 
 /* Variables */
@@ -139,10 +140,20 @@ int _unlink(char *name)
   return -1;
 }
 
+/* Process time is the 1 ms tick, scaled to CLOCKS_PER_SEC; newlib
+ * defines that as 100 on ARM, so clock() counts 10 ms units there */
+_Static_assert(CLOCKS_PER_SEC <= 1000 && 1000 % CLOCKS_PER_SEC == 0,
+               "CLOCKS_PER_SEC must divide the 1 ms tick rate");
+
 int _times(struct tms *buf)
 {
-  (void)buf;
-  return -1;
+  clock_t ticks = (clock_t)(tick_ms() / (1000U / CLOCKS_PER_SEC));
+
+  buf->tms_utime = ticks;
+  buf->tms_stime = 0;
+  buf->tms_cutime = 0;
+  buf->tms_cstime = 0;
+  return ticks;
 }
 
 int _stat(char *file, struct stat *st)
@@ -0,0 +1,59 @@
+/**
+ * @file tick.c
+ * @brief 1 ms system tick from SysTick.
+ *
+ * Keeps a millisecond counter and advances the timer wheel from the
+ * SysTick interrupt; every time-based driver files its timeouts there.
+ * For finer intervals use timebase_us().
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "stm32f0xx.h"
+#include "tick.h"
+#include "timeout.h"
+#include "clock.h"
+
+static volatile uint32_t ticks = 0;
+
+/**
+ * @brief Starts SysTick at TICK_FREQUENCY from the core clock (HCLK).
+ */
+void tick_init(void) {
+    SysTick_Config(clock_hclk_hz() / TICK_FREQUENCY);
+}
+
+/**
+ * @brief Returns the milliseconds elapsed since tick_init().
+ *
+ * @return uint32_t Millisecond count, wrapping after about 49 days.
+ */
+uint32_t tick_ms(void) {
+    return ticks;
+}
+
+/**
+ * @brief Adds time that passed while SysTick was stopped and runs due timeouts.
+ *
+ * Used after Stop mode, which halts SysTick; the time slept is measured by
+ * the RTC.
+ *
+ * @param elapsed_ms Milliseconds to add.
+ */
+void tick_advance(uint32_t elapsed_ms) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    ticks += elapsed_ms;
+    timeout_tick(ticks);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief SysTick interrupt: advances the tick and runs due timeouts.
+ */
+void SysTick_Handler(void) {
+    ticks++;
+    timeout_tick(ticks);
+}
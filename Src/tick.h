@@ -0,0 +1,22 @@
+/**
+ * @file tick.h
+ * @brief Header file for the 1 ms SysTick tick.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef TICK_H
+#define TICK_H
+
+#include <stdint.h>
+
+#define TICK_FREQUENCY 1000 /**< Ticks per second */
+
+// Function Declarations
+void tick_init(void);
+uint32_t tick_ms(void);
+void tick_advance(uint32_t elapsed_ms);
+void SysTick_Handler(void);
+
+#endif // TICK_H
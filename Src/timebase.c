@@ -0,0 +1,71 @@
+/**
+ * @file timebase.c
+ * @brief Free-running microsecond counter on TIM6.
+ *
+ * TIM6 is a basic timer with no pins, so using it as the timebase leaves
+ * the general-purpose timers free for PWM. It is prescaled to 1 MHz and
+ * runs over the full 16-bit range; the update interrupt counts overflows
+ * and timebase_us() combines both into one 32-bit value.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include "stm32f0xx.h"
+#include "timebase.h"
+#include "clock.h"
+
+#define TIMEBASE_FREQUENCY 1000000 /**< Counter rate, 1 us per tick */
+
+static volatile uint32_t overflows = 0; // Upper 16 bits of the microsecond count
+
+/**
+ * @brief Starts TIM6 as a 1 MHz free-running counter.
+ *
+ * The prescaler is derived from the real timer clock, so clock_init()
+ * must have run first.
+ */
+void timebase_init(void) {
+    RCC->APB1ENR |= RCC_APB1ENR_TIM6EN;
+
+    TIM6->CR1 = 0;
+    TIM6->PSC = clock_timer_hz() / TIMEBASE_FREQUENCY - 1;
+    TIM6->ARR = 0xFFFF;
+    TIM6->EGR = TIM_EGR_UG;  // Load the prescaler now
+    TIM6->SR = 0;            // UG sets UIF; do not count it as an overflow
+    TIM6->DIER = TIM_DIER_UIE;
+    TIM6->CR1 = TIM_CR1_URS | TIM_CR1_CEN; // Only overflows raise UIF
+
+    NVIC_EnableIRQ(TIM6_DAC_IRQn);
+}
+
+/**
+ * @brief Returns the microseconds elapsed since timebase_init().
+ *
+ * Safe to call with interrupts enabled or disabled: an overflow that has
+ * happened but not yet been serviced is detected from the pending flag.
+ *
+ * @return uint32_t Microsecond count, wrapping every 2^32 us.
+ */
+uint32_t timebase_us(void) {
+    uint32_t primask = __get_PRIMASK();
+    uint32_t high, low;
+
+    __disable_irq();
+    high = overflows;
+    low = TIM6->CNT;
+    // An overflow pending since the counter wrapped belongs to this reading
+    if ((TIM6->SR & TIM_SR_UIF) && low < 0x8000) {
+        high++;
+    }
+    __set_PRIMASK(primask);
+    return (high << 16) | low;
+}
+
+/**
+ * @brief TIM6 update interrupt: counts counter overflows.
+ */
+void TIM6_DAC_IRQHandler(void) {
+    TIM6->SR &= ~TIM_SR_UIF;
+    overflows++;
+}
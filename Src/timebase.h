@@ -0,0 +1,22 @@
+/**
+ * @file timebase.h
+ * @brief Header file for the microsecond timebase.
+ *
+ * TIM6 counts microseconds; its overflow interrupt extends the 16-bit
+ * counter to 32 bits, so intervals up to about 71 minutes can be measured.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+// Function Declarations
+void timebase_init(void);
+uint32_t timebase_us(void);
+void TIM6_DAC_IRQHandler(void);
+
+#endif // TIMEBASE_H
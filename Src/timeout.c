@@ -0,0 +1,313 @@
+/**
+ * @file timeout.c
+ * @brief Hierarchical timer wheel giving O(1) software timeouts on the 1 ms tick.
+ *
+ * Level 0 has one slot per tick for the next 64 ticks; each slot of level
+ * 1 covers 64 ticks, and each slot of level 2 covers 4096. A timeout goes
+ * into the level whose span covers its delay, as a doubly linked list
+ * entry, so starting and cancelling are O(1). Each tick runs the level 0
+ * slot of that tick; every 64 ticks the next level 1 slot is cascaded
+ * into level 0, and every 4096 ticks the next level 2 slot into the lower
+ * levels. Delays beyond level 2 are parked in its furthest slot and
+ * re-filed when it cascades.
+ *
+ * Blink patterns, button debounce and scheduler timers all share this
+ * wheel, so the tick costs one empty-slot test when nothing is due,
+ * however many timeouts are pending.
+ *
+ * After Stop mode the wheel may be far behind the tick. It then jumps
+ * straight to the earliest expiry and files every timeout again from
+ * there, which is what cascading the skipped slots would have done, so
+ * catching up costs a slot scan per due expiry, not one step per tick.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#include <stddef.h>
+#include "stm32f0xx.h"
+#include "timeout.h"
+#include "tick.h"
+
+#define TIMEOUT_SLOTS (1U << TIMEOUT_WHEEL_BITS)
+#define TIMEOUT_SLOT_MASK (TIMEOUT_SLOTS - 1U)
+#define TIMEOUT_LEVEL_SHIFT(level) ((level) * TIMEOUT_WHEEL_BITS)
+#define TIMEOUT_SPAN (1UL << (TIMEOUT_LEVELS * TIMEOUT_WHEEL_BITS)) /**< Longest delay filed directly */
+
+// Slot list heads; each is a circular list through a dummy entry
+static Timeout wheel[TIMEOUT_LEVELS][TIMEOUT_SLOTS];
+static uint32_t wheel_next = 0; // Next tick to process
+static uint32_t wheel_count = 0; // Timeouts on the wheel
+static int wheel_ready = 0;
+
+/**
+ * @brief Makes every slot an empty circular list; done on first use.
+ */
+static void timeout_init(void) {
+    for (int level = 0; level < TIMEOUT_LEVELS; level++) {
+        for (uint32_t slot = 0; slot < TIMEOUT_SLOTS; slot++) {
+            wheel[level][slot].next = &wheel[level][slot];
+            wheel[level][slot].prev = &wheel[level][slot];
+        }
+    }
+    wheel_next = tick_ms() + 1U;
+    wheel_ready = 1;
+}
+
+/**
+ * @brief Files a timeout into the slot that covers its expiry.
+ *
+ * Must be called with interrupts disabled or from the tick interrupt.
+ *
+ * @param timeout Inactive timeout with expires set.
+ */
+static void timeout_file(Timeout *timeout) {
+    uint32_t delta = timeout->expires - wheel_next;
+    Timeout *head;
+    int level;
+
+    if ((int32_t)delta < 0) {
+        // Already due: run it on the next tick processed
+        head = &wheel[0][wheel_next & TIMEOUT_SLOT_MASK];
+    } else {
+        uint32_t expires = timeout->expires;
+
+        if (delta >= TIMEOUT_SPAN) {
+            expires = wheel_next + TIMEOUT_SPAN - 1U; // Parked; re-filed on cascade
+        }
+        for (level = 0; level < TIMEOUT_LEVELS - 1; level++) {
+            if ((expires - wheel_next) < (1UL << TIMEOUT_LEVEL_SHIFT(level + 1))) {
+                break;
+            }
+        }
+        head = &wheel[level][(expires >> TIMEOUT_LEVEL_SHIFT(level)) & TIMEOUT_SLOT_MASK];
+    }
+
+    timeout->prev = head->prev;
+    timeout->next = head;
+    head->prev->next = timeout;
+    head->prev = timeout;
+    wheel_count++;
+}
+
+/**
+ * @brief Takes a timeout out of its slot; interrupts disabled.
+ */
+static void timeout_unlink(Timeout *timeout) {
+    timeout->prev->next = timeout->next;
+    timeout->next->prev = timeout->prev;
+    timeout->next = NULL;
+    timeout->prev = NULL;
+    wheel_count--;
+}
+
+/**
+ * @brief Starts (or restarts) a timeout at an absolute tick.
+ *
+ * Periodic users pass their previous expiry plus the period, so the
+ * period does not drift with callback latency.
+ *
+ * @param timeout Timeout to start; if already active it is moved.
+ * @param expires Tick at which the callback runs; a past tick runs it on the next tick.
+ * @param callback Function to run on expiry, in the tick interrupt.
+ */
+void timeout_start_at(Timeout *timeout, uint32_t expires, TimeoutCallback callback) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (!wheel_ready) {
+        timeout_init();
+    }
+    if (timeout->next != NULL) {
+        timeout_unlink(timeout);
+    }
+    timeout->expires = expires;
+    timeout->callback = callback;
+    timeout_file(timeout);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Starts (or restarts) a timeout a number of ticks from now.
+ *
+ * @param timeout Timeout to start; if already active it is moved.
+ * @param delay_ms Delay in ticks (ms).
+ * @param callback Function to run on expiry, in the tick interrupt.
+ */
+void timeout_start(Timeout *timeout, uint32_t delay_ms, TimeoutCallback callback) {
+    timeout_start_at(timeout, tick_ms() + delay_ms, callback);
+}
+
+/**
+ * @brief Stops a timeout; does nothing if it is not active.
+ *
+ * @param timeout Timeout to stop.
+ */
+void timeout_cancel(Timeout *timeout) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (timeout->next != NULL) {
+        timeout_unlink(timeout);
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Tells whether a timeout is waiting to expire.
+ *
+ * @param timeout Timeout to test.
+ * @return int Returns 1 if active, 0 otherwise.
+ */
+int timeout_active(const Timeout *timeout) {
+    return timeout->next != NULL;
+}
+
+/**
+ * @brief Finds the earliest expiry on the wheel.
+ *
+ * Walks every slot, so it is meant for the idle path, where it decides
+ * how long the core may stop; it must be called with interrupts disabled.
+ *
+ * @param expires Pointer to store the tick of the earliest expiry.
+ * @return int Returns 1 if a timeout is pending, 0 if the wheel is empty.
+ */
+int timeout_next_expiry(uint32_t *expires) {
+    uint32_t earliest = UINT32_MAX;
+
+    if (!wheel_ready || wheel_count == 0) {
+        return 0;
+    }
+    for (int level = 0; level < TIMEOUT_LEVELS; level++) {
+        for (uint32_t slot = 0; slot < TIMEOUT_SLOTS; slot++) {
+            const Timeout *head = &wheel[level][slot];
+
+            for (const Timeout *timeout = head->next; timeout != head; timeout = timeout->next) {
+                int32_t delta = (int32_t)(timeout->expires - wheel_next);
+                uint32_t ahead = (delta < 0) ? 0 : (uint32_t)delta;
+
+                if (ahead < earliest) {
+                    earliest = ahead;
+                }
+            }
+        }
+    }
+    *expires = wheel_next + earliest;
+    return 1;
+}
+
+/**
+ * @brief Re-files every timeout of one slot into the lower levels.
+ *
+ * @param head Slot list head.
+ */
+static void timeout_cascade(Timeout *head) {
+    while (head->next != head) {
+        Timeout *timeout = head->next;
+
+        timeout_unlink(timeout);
+        timeout_file(timeout);
+    }
+}
+
+/**
+ * @brief Moves the wheel to a later tick without stepping through the ticks between.
+ *
+ * Takes every timeout off the wheel and files it again relative to the
+ * new position. No timeout may expire before that position.
+ *
+ * @param target Next tick to process.
+ */
+static void timeout_skip(uint32_t target) {
+    Timeout pending; // Every timeout, while the wheel is emptied
+
+    pending.next = &pending;
+    pending.prev = &pending;
+    for (int level = 0; level < TIMEOUT_LEVELS; level++) {
+        for (uint32_t slot = 0; slot < TIMEOUT_SLOTS; slot++) {
+            Timeout *head = &wheel[level][slot];
+
+            if (head->next == head) {
+                continue;
+            }
+            head->next->prev = pending.prev;
+            pending.prev->next = head->next;
+            head->prev->next = &pending;
+            pending.prev = head->prev;
+            head->next = head;
+            head->prev = head;
+        }
+    }
+
+    wheel_next = target;
+    while (pending.next != &pending) {
+        Timeout *timeout = pending.next;
+
+        timeout_unlink(timeout);
+        timeout_file(timeout);
+    }
+}
+
+/**
+ * @brief Advances the wheel and runs expired callbacks; called from the tick interrupt.
+ *
+ * When more than a level 0 turn behind, e.g. after Stop mode, the wheel
+ * jumps to the earliest expiry (or the current tick) instead of stepping;
+ * an empty wheel jumps straight to the current tick.
+ *
+ * @param now Current tick.
+ */
+void timeout_tick(uint32_t now) {
+    Timeout due; // Timeouts of the slot being run
+
+    if (!wheel_ready) {
+        return; // Nothing was ever started
+    }
+    while ((int32_t)(now - wheel_next) >= 0) {
+        Timeout *head = &wheel[0][wheel_next & TIMEOUT_SLOT_MASK];
+
+        if (wheel_count == 0) {
+            wheel_next = now + 1U;
+            break;
+        }
+        if ((now - wheel_next) >= TIMEOUT_SLOTS) {
+            uint32_t earliest;
+
+            timeout_next_expiry(&earliest);
+            if ((int32_t)(now - earliest) < 0) {
+                earliest = now;
+            }
+            if (earliest != wheel_next) {
+                timeout_skip(earliest);
+                head = &wheel[0][wheel_next & TIMEOUT_SLOT_MASK];
+            }
+        }
+
+        // At the start of each higher-level slot, move its timeouts down first
+        for (int level = 1; level < TIMEOUT_LEVELS; level++) {
+            if ((wheel_next & ((1UL << TIMEOUT_LEVEL_SHIFT(level)) - 1U)) != 0) {
+                break;
+            }
+            timeout_cascade(&wheel[level][(wheel_next >> TIMEOUT_LEVEL_SHIFT(level)) & TIMEOUT_SLOT_MASK]);
+        }
+
+        // Take the due timeouts off the wheel before running any callback, so
+        // one that restarts itself is filed for a later pass, never this one
+        wheel_next++;
+        if (head->next == head) {
+            continue;
+        }
+        due.next = head->next;
+        due.prev = head->prev;
+        due.next->prev = &due;
+        due.prev->next = &due;
+        head->next = head;
+        head->prev = head;
+        while (due.next != &due) {
+            Timeout *timeout = due.next;
+
+            timeout_unlink(timeout);
+            timeout->callback(timeout);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/**
+ * @file timeout.h
+ * @brief Header file for the hierarchical timer wheel on the 1 ms tick.
+ *
+ * A Timeout is embedded in the state of its owner, so starting one never
+ * allocates; the callback finds its owner from the Timeout pointer.
+ *
+ * @date 16 October 2026
+ * @author Lokesh Senthil Kumar
+ */
+
+#ifndef TIMEOUT_H
+#define TIMEOUT_H
+
+#include <stdint.h>
+
+#define TIMEOUT_WHEEL_BITS 6 /**< log2 of the slots per wheel level */
+#define TIMEOUT_LEVELS 3     /**< Wheel levels; 64, 4096 and 262144 ticks deep */
+
+typedef struct Timeout Timeout;
+
+/**
+ * @brief Expiry callback; runs in the tick interrupt and must be short.
+ *
+ * The timeout is already inactive, so the callback may start it again.
+ */
+typedef void (*TimeoutCallback)(Timeout *timeout);
+
+/**
+ * @brief A pending software timeout; zero-initialize before first use.
+ */
+struct Timeout {
+    Timeout *next;            /**< Slot list links, NULL while inactive */
+    Timeout *prev;
+    uint32_t expires;         /**< Tick at which the callback runs */
+    TimeoutCallback callback; /**< Function to run on expiry */
+};
+
+// Function Declarations
+void timeout_start(Timeout *timeout, uint32_t delay_ms, TimeoutCallback callback);
+void timeout_start_at(Timeout *timeout, uint32_t expires, TimeoutCallback callback);
+void timeout_cancel(Timeout *timeout);
+int timeout_active(const Timeout *timeout);
+int timeout_next_expiry(uint32_t *expires);
+void timeout_tick(uint32_t now);
+
+#endif // TIMEOUT_H
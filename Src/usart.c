@@ -10,19 +10,32 @@
  * @author Lokesh Senthil Kumar
  */
 
+#include <stdio.h>
 #include "stm32f0xx.h"
-#include "USART.h"
+#include "usart.h"
 #include "cbfifo.h"
+#include "gpio.h"
+#include "clock.h"
+#include "idle.h"
+#include "timebase.h"
+#include "response.h"
+#include "command_processor.h"
 
 #define MAX_BUFFER_SIZE 128 /**< Maximum size for RX and TX circular buffers */
-#define AF_Mode_PA2_PA3_clear ((3U << (2 * 2)) | (3U << (2 * 3)))
-#define AF_Mode_PA2_PA3_set (2U << (2 * 2)) | (2U << (2 * 3))
+// PA2 (TX) and PA3 (RX) on AF1 = USART2
+#define USART2_PINS(X) X(2, GPIO_MODE_AF, 1, GPIO_PUSH_PULL, GPIO_NO_PULL) \
+                       X(3, GPIO_MODE_AF, 1, GPIO_PUSH_PULL, GPIO_NO_PULL)
 // Configuration Defines
 #define USART_BAUD_RATE   19200         /**< Baud rate for USART communication */
 #define USART_DATA_and_parity_BITS   9             /**< Number of data bits and parity bit (8 or 9) */
 #define USART_PARITY      'O'           /**< Parity: 'N' (None), 'E' (Even), 'O' (Odd) */
 #define USART_STOP_BITS   1             /**< Stop bits: 1 or 2 */
-#define peripheral_frequency 24000000
+#define USART_LOW_POWER_IDLE 1          /**< 1: clock from HSI so console input can wake the MCU from Stop */
+
+#define SELFTEST_PATTERN_LENGTH 256     /**< Bytes pushed through the link per baud rate */
+#define SELFTEST_TIMEOUT_FRAMES 4       /**< Frame times without a reception before a byte is declared lost */
+#define SELFTEST_FRAME_BITS (1 + USART_DATA_and_parity_BITS + USART_STOP_BITS) /**< Start, data, parity and stop bits */
+#define SELFTEST_MAX_BAUD_ERROR_PERMILLE 25 /**< Rates further off than this are not supported */
 
 
 // Circular buffers for RX and TX
@@ -30,6 +43,43 @@ static uint8_t rx_buffer[MAX_BUFFER_SIZE];
 static uint8_t tx_buffer[MAX_BUFFER_SIZE];
 static volatile int rx_head = 0, rx_tail = 0;
 static volatile int tx_head = 0, tx_tail = 0;
+// When set, printf output goes here instead of the TX buffer
+static int (*output_hook)(int ch) = NULL;
+// Received bytes lost to a full RX buffer or a hardware overrun
+static volatile uint32_t rx_overflows = 0;
+// Output characters dropped because the TX buffer was full
+static volatile uint32_t tx_overflows = 0;
+
+// Standard rates tried by the link self-test, lowest first
+static const uint32_t selftest_baud_rates[] = {
+    1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600
+};
+
+/**
+ * @brief Returns the USART2 kernel clock selected in USART2_Init().
+ *
+ * HSI when the console must receive in Stop mode, PCLK otherwise.
+ *
+ * @return uint32_t Kernel clock in Hz.
+ */
+static uint32_t USART2_KernelFrequency(void) {
+#if USART_LOW_POWER_IDLE
+    return CLOCK_HSI_HZ;
+#else
+    return clock_pclk_hz();
+#endif
+}
+
+/**
+ * @brief Computes the BRR value for 16x oversampling, rounded to nearest.
+ *
+ * @param kernel_frequency USART kernel clock in Hz.
+ * @param baud Requested baud rate.
+ * @return uint32_t BRR register value.
+ */
+static uint32_t USART_ComputeBRR(uint32_t kernel_frequency, uint32_t baud) {
+    return (kernel_frequency + baud / 2) / baud;
+}
 
 
 /**
@@ -45,14 +95,19 @@ void USART2_Init(void) {
     RCC->APB1ENR |= RCC_APB1ENR_USART2EN;
 
     // Configure PA2 (TX) and PA3 (RX) for USART2 (Alternate Function Mode)
-    GPIOA->MODER &= ~AF_Mode_PA2_PA3_clear;
-    GPIOA->MODER |= AF_Mode_PA2_PA3_set;
-    GPIOA->AFR[0] &= ~(GPIO_AFRL_AFSEL2_Msk | GPIO_AFRL_AFSEL3_Msk);
-    GPIOA->AFR[0] |= (1U << GPIO_AFRL_AFSEL2_Pos) | (1U << GPIO_AFRL_AFSEL3_Pos);
+    GPIO_CONFIGURE(GPIOA, USART2_PINS);
+
+#if USART_LOW_POWER_IDLE
+    // Clock USART2 from HSI so it can receive while the core is in Stop mode
+    RCC->CFGR3 = (RCC->CFGR3 & ~RCC_CFGR3_USART2SW) | RCC_CFGR3_USART2SW_HSI;
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+#else
+    RCC->CFGR3 = (RCC->CFGR3 & ~RCC_CFGR3_USART2SW) | RCC_CFGR3_USART2SW_PCLK;
+#endif
 
     // Configure USART Baud Rate
     USART2->CR1 &= ~USART_CR1_OVER8;  // Use 16x oversampling
-    USART2->BRR = (peripheral_frequency / USART_BAUD_RATE);
+    USART2->BRR = USART_ComputeBRR(USART2_KernelFrequency(), USART_BAUD_RATE);
 
     // Configure Parity
     if (USART_PARITY == 'N') {
@@ -86,6 +141,14 @@ void USART2_Init(void) {
     // Enable RXNE and TXE interrupts
     USART2->CR1 |= USART_CR1_RXNEIE | USART_CR1_TXEIE;
 
+#if USART_LOW_POWER_IDLE
+    // Wake from Stop once a complete frame is in RDR (WUS = 11), so the
+    // character that woke us is received normally and never lost
+    USART2->CR3 = (USART2->CR3 & ~USART_CR3_WUS) | USART_CR3_WUS_0 | USART_CR3_WUS_1;
+    USART2->CR1 |= USART_CR1_UESM;
+    EXTI->IMR |= EXTI_IMR_MR26; // USART2 wakeup is EXTI line 26
+#endif
+
     // Enable USART2 interrupt in the NVIC
     NVIC_EnableIRQ(USART2_IRQn);
 }
@@ -97,29 +160,359 @@ void USART2_Init(void) {
  * @return int Returns the sent character.
  */
 int __io_putchar(int ch) {
-    cbfifo_enqueue(tx_buffer, &tx_head, &tx_tail, (uint8_t)ch);
+    if (output_hook != NULL) {
+        return output_hook(ch);
+    }
+    if (!cbfifo_enqueue(tx_buffer, &tx_head, &tx_tail, (uint8_t)ch)) {
+        tx_overflows++;
+    }
     USART2->CR1 |= USART_CR1_TXEIE; // Enable TXE interrupt
     return ch;
 }
 
+/**
+ * @brief Diverts printf output, e.g. to capture a command's text for RPC.
+ *
+ * @param hook Function receiving each character, or NULL to send to USART2 again.
+ */
+void USART2_SetOutputHook(int (*hook)(int ch)) {
+    output_hook = hook;
+}
+
+/**
+ * @brief Returns how many bytes can be queued for transmission right now.
+ *
+ * @return int Free space in the TX circular buffer.
+ */
+int USART2_TxSpace(void) {
+    return cbfifo_free(&tx_head, &tx_tail);
+}
+
+/**
+ * @brief Queues a block of data for transmission in one call.
+ *
+ * Copies as much of the block as fits into the TX circular buffer and
+ * enables the TXE interrupt once, instead of once per character.
+ *
+ * @param data Bytes to send.
+ * @param length Number of bytes.
+ * @return int Number of bytes queued.
+ */
+int USART2_Write(const uint8_t *data, int length) {
+    int queued = 0;
+
+    while (queued < length && cbfifo_enqueue(tx_buffer, &tx_head, &tx_tail, data[queued])) {
+        queued++;
+    }
+    USART2->CR1 |= USART_CR1_TXEIE;
+    return queued;
+}
+
+/**
+ * @brief Queues a block for transmission if it fits, otherwise drops it.
+ *
+ * For output that must not wait, such as periodic samples: the block is
+ * queued whole or not at all, and a dropped block is added to the TX
+ * overflow count so the loss shows up in HEALTH.
+ *
+ * @param data Bytes to send.
+ * @param length Number of bytes.
+ * @return int Returns 1 if the block was queued, 0 if it was dropped.
+ */
+int USART2_WriteOrDrop(const uint8_t *data, int length) {
+    // The TX interrupt only ever frees space, so the block fits once checked
+    if (USART2_TxSpace() < length) {
+        tx_overflows += (uint32_t)length;
+        return 0;
+    }
+    USART2_Write(data, length);
+    return 1;
+}
+
+/**
+ * @brief Queues a whole block for transmission, waiting for room as needed.
+ *
+ * Used for console text, so it honours the output hook set with
+ * USART2_SetOutputHook(). Must not be called with interrupts disabled.
+ *
+ * @param data Bytes to send.
+ * @param length Number of bytes.
+ */
+void USART2_WriteAll(const uint8_t *data, int length) {
+    if (output_hook != NULL) {
+        for (int i = 0; i < length; i++) {
+            output_hook(data[i]);
+        }
+        return;
+    }
+    while (length > 0) {
+        int queued = USART2_Write(data, length);
+
+        data += queued;
+        length -= queued;
+    }
+}
+
+/**
+ * @brief Non-blocking read of one received character.
+ *
+ * @param ch Pointer to store the received character.
+ * @return int Returns 1 if a character was read, 0 if the RX buffer is empty.
+ */
+int USART2_ReadByte(uint8_t *ch) {
+    return cbfifo_dequeue(rx_buffer, &rx_head, &rx_tail, ch);
+}
+
+/**
+ * @brief Tells whether received bytes are waiting to be read.
+ *
+ * @return int Returns 1 if the RX buffer is not empty, 0 otherwise.
+ */
+int USART2_RxPending(void) {
+    return rx_head != rx_tail;
+}
+
+/**
+ * @brief Arms USART2 as a Stop mode wake source, if it can be one now.
+ *
+ * The console can only wake the MCU when it runs from HSI and the link is
+ * completely idle (TX buffer empty, TC set, BUSY clear); otherwise the
+ * idle manager must use Sleep, where the TXE interrupt keeps the output
+ * going. Call with interrupts disabled.
+ *
+ * @return int Returns 1 if armed, 0 if Stop mode would lose console traffic.
+ */
+int USART2_PrepareStop(void) {
+#if USART_LOW_POWER_IDLE
+    if (tx_head != tx_tail || !(USART2->ISR & USART_ISR_TC) || (USART2->ISR & USART_ISR_BUSY)) {
+        return 0;
+    }
+    USART2->ICR = USART_ICR_WUCF;
+    USART2->CR3 |= USART_CR3_WUFIE;
+    return 1;
+#else
+    return 0; // PCLK stops in Stop mode
+#endif
+}
+
+/**
+ * @brief Disarms the Stop mode wakeup after the MCU has woken up.
+ *
+ * @return int Returns 1 if USART2 was the wake source, 0 otherwise.
+ */
+int USART2_FinishStop(void) {
+#if USART_LOW_POWER_IDLE
+    USART2->CR3 &= ~USART_CR3_WUFIE;
+    return (USART2->ISR & USART_ISR_WUF) != 0;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Returns the number of received bytes lost since reset.
+ *
+ * @return uint32_t Bytes dropped because the RX buffer was full, plus hardware overruns.
+ */
+uint32_t USART2_RxOverflowCount(void) {
+    return rx_overflows;
+}
+
+/**
+ * @brief Returns the number of output characters dropped since reset.
+ *
+ * @return uint32_t Characters USART2_WriteOrDrop() and __io_putchar() discarded because
+ *                  the TX buffer was full.
+ */
+uint32_t USART2_TxOverflowCount(void) {
+    return tx_overflows;
+}
+
 /**
  * @brief Receives a character via USART2 (used by getchar).
  *
+ * Sleeps between characters instead of busy-waiting on the RX buffer.
+ *
  * @return int Returns the received character.
  */
 int __io_getchar(void) {
     uint8_t ch;
-    while (cbfifo_dequeue(rx_buffer, &rx_head, &rx_tail, &ch) == 0);
+    while (USART2_ReadByte(&ch) == 0) {
+        idle_wait();
+    }
     return ch;
 }
 
+/**
+ * @brief Returns the baud rate error in permille for a given BRR setting.
+ *
+ * @param kernel_frequency USART kernel clock in Hz.
+ * @param baud Requested baud rate.
+ * @return uint32_t Absolute deviation of the real baud rate, in 1/1000.
+ */
+static uint32_t USART_BaudErrorPermille(uint32_t kernel_frequency, uint32_t baud) {
+    uint32_t brr = USART_ComputeBRR(kernel_frequency, baud);
+    uint32_t actual = kernel_frequency / brr;
+    uint32_t delta = (actual > baud) ? (actual - baud) : (baud - actual);
+    return (uint32_t)(((uint64_t)delta * 1000) / baud);
+}
+
+/**
+ * @brief Next value of the self-test pattern (16-bit Galois LFSR).
+ *
+ * @param lfsr Pointer to the LFSR state, must be non-zero.
+ * @return uint8_t Next pattern byte.
+ */
+static uint8_t USART_NextPattern(uint16_t *lfsr) {
+    for (int i = 0; i < 8; i++) {
+        *lfsr = (*lfsr >> 1) ^ (-(*lfsr & 1U) & 0xB400U);
+    }
+    return (uint8_t)*lfsr;
+}
+
+/**
+ * @brief Pushes a pseudo-random pattern through the looped-back link.
+ *
+ * Transmission and reception overlap, so frames are sent back to back at
+ * the configured rate. Any mismatch, lost byte or PE/FE/NE/ORE flag counts
+ * as an error. A byte is declared lost when nothing arrives for timeout_us,
+ * measured with timebase_us(), or when the frame after it arrives instead.
+ *
+ * @param seed Non-zero LFSR seed.
+ * @param timeout_us Longest gap between two receptions, in microseconds.
+ * @return uint32_t Number of errors detected.
+ */
+static uint32_t USART2_LoopbackPattern(uint16_t seed, uint32_t timeout_us) {
+    uint16_t tx_lfsr = seed, rx_lfsr = seed;
+    uint32_t errors = 0;
+    int sent = 0, received = 0;
+    uint32_t last = timebase_us();
+
+    while (received < SELFTEST_PATTERN_LENGTH) {
+        uint32_t isr = USART2->ISR;
+
+        if (isr & (USART_ISR_PE | USART_ISR_FE | USART_ISR_NE | USART_ISR_ORE)) {
+            USART2->ICR = USART_ICR_PECF | USART_ICR_FECF | USART_ICR_NCF | USART_ICR_ORECF;
+            errors++;
+        }
+        if (isr & USART_ISR_RXNE) {
+            uint8_t byte = (uint8_t)(USART2->RDR & 0xFF);
+            if (byte != USART_NextPattern(&rx_lfsr)) {
+                uint16_t next_lfsr = rx_lfsr;
+                // With two frames in flight, the one after a lost byte arrives first
+                if (received + 1 < sent && byte == USART_NextPattern(&next_lfsr)) {
+                    rx_lfsr = next_lfsr;
+                    received++;
+                }
+                errors++;
+            }
+            received++;
+            last = timebase_us();
+        } else if (timebase_us() - last > timeout_us) {
+            // Byte lost; skip it and keep the pattern generators in step
+            USART_NextPattern(&rx_lfsr);
+            received++;
+            errors++;
+            last = timebase_us();
+        }
+        // Keep at most two frames in flight so RDR can never overrun
+        if (sent < SELFTEST_PATTERN_LENGTH && sent - received < 2 && (isr & USART_ISR_TXE)) {
+            USART2->TDR = USART_NextPattern(&tx_lfsr);
+            sent++;
+        }
+    }
+    return errors;
+}
+
+/**
+ * @brief Runs the single-wire loopback self-test at every supported baud rate.
+ *
+ * USART2 is switched to half-duplex mode (HDSEL), where the receiver is
+ * internally connected to the TX line, and each rate in
+ * selftest_baud_rates[] whose BRR error is within
+ * SELFTEST_MAX_BAUD_ERROR_PERMILLE is exercised with a pseudo-random
+ * pattern using the console frame format. A byte counts as lost after
+ * SELFTEST_TIMEOUT_FRAMES frame times at the rate under test. The USART2
+ * interrupt is masked during the test and the original configuration is
+ * restored afterwards.
+ * Throughput is the pattern length over the transfer time measured with
+ * timebase_us(), so it includes every gap between frames.
+ *
+ * Note: the test patterns are visible on PA2, so the host terminal will
+ * show garbage while the test runs.
+ *
+ * @param results Array receiving one entry per tested baud rate.
+ * @param max_results Capacity of the results array.
+ * @return int Number of entries written to results.
+ */
+int USART2_SelfTest(USART_SelfTestResult *results, int max_results) {
+    uint32_t kernel_frequency = USART2_KernelFrequency();
+    uint32_t cr1, cr3, brr;
+    uint32_t start, elapsed;
+    int count = 0;
+
+    // Let pending console output finish at the normal rate
+    while (tx_head != tx_tail);
+    while ((USART2->ISR & USART_ISR_TC) == 0);
+
+    NVIC_DisableIRQ(USART2_IRQn);
+    cr1 = USART2->CR1;
+    cr3 = USART2->CR3;
+    brr = USART2->BRR;
+
+    USART2->CR1 &= ~USART_CR1_UE;
+    USART2->CR1 &= ~(USART_CR1_RXNEIE | USART_CR1_TXEIE | USART_CR1_UESM);
+    USART2->CR3 = (USART2->CR3 & ~(USART_CR3_WUFIE | USART_CR3_WUS)) | USART_CR3_HDSEL;
+
+    for (unsigned i = 0; i < sizeof(selftest_baud_rates) / sizeof(selftest_baud_rates[0]); i++) {
+        uint32_t baud = selftest_baud_rates[i];
+        uint32_t timeout_us;
+
+        if (count >= max_results) {
+            break;
+        }
+        if (USART_ComputeBRR(kernel_frequency, baud) < 16 ||
+            USART_BaudErrorPermille(kernel_frequency, baud) > SELFTEST_MAX_BAUD_ERROR_PERMILLE) {
+            continue; // Not reachable from this kernel clock
+        }
+
+        USART2->BRR = USART_ComputeBRR(kernel_frequency, baud);
+        USART2->CR1 |= USART_CR1_UE;
+        (void)USART2->RDR; // Discard anything left over
+        USART2->ICR = USART_ICR_PECF | USART_ICR_FECF | USART_ICR_NCF | USART_ICR_ORECF;
+
+        results[count].baud = baud;
+        timeout_us = (uint32_t)((uint64_t)SELFTEST_TIMEOUT_FRAMES * SELFTEST_FRAME_BITS * 1000000U / baud) + 1;
+        start = timebase_us();
+        results[count].errors = USART2_LoopbackPattern((uint16_t)(0xACE1U + i), timeout_us);
+        elapsed = timebase_us() - start;
+        results[count].bytes_per_second =
+            (elapsed != 0) ? (uint32_t)((uint64_t)SELFTEST_PATTERN_LENGTH * 1000000U / elapsed) : 0;
+        count++;
+
+        while ((USART2->ISR & USART_ISR_TC) == 0);
+        USART2->CR1 &= ~USART_CR1_UE;
+    }
+
+    // Restore the console configuration
+    USART2->BRR = brr;
+    USART2->CR3 = cr3;
+    USART2->CR1 = cr1 & ~USART_CR1_UE;
+    USART2->CR1 = cr1;
+    (void)USART2->RDR;
+    USART2->ICR = USART_ICR_PECF | USART_ICR_FECF | USART_ICR_NCF | USART_ICR_ORECF;
+    NVIC_EnableIRQ(USART2_IRQn);
+
+    return count;
+}
+
 /**
  * @brief Standard putchar implementation for UART output.
  *
  * @param ch Character to send.
  * @return int Returns the sent character.
  */
-int putchar(int ch) {
+int (putchar)(int ch) { // Parenthesized so newlib's putchar() macro does not expand
     return __io_putchar(ch);
 }
 
@@ -128,7 +521,7 @@ int putchar(int ch) {
  *
  * @return int Returns the received character.
  */
-int getchar(void) {
+int (getchar)(void) { // Parenthesized so newlib's getchar() macro does not expand
     return __io_getchar();
 }
 
@@ -138,14 +531,27 @@ int getchar(void) {
  * Handles RXNE (Receive Not Empty) and TXE (Transmit Empty) interrupts.
  * RXNE: Reads received data and stores it in the RX circular buffer.
  * TXE: Sends data from the TX circular buffer if available, otherwise disables TXE interrupt.
+ * WUF: Acknowledges the wakeup from Stop mode; the data itself arrives via RXNE.
+ * ORE: Clears an overrun and counts the lost byte.
  */
 void USART2_IRQHandler(void) {
     uint8_t byte;
 
+    if (USART2->ISR & USART_ISR_WUF) {
+        USART2->ICR = USART_ICR_WUCF;
+    }
+
     // Handle RXNE interrupt (data received)
     if (USART2->ISR & USART_ISR_RXNE) {
         byte = (uint8_t)(USART2->RDR & 0xFF); // Read received data
-        cbfifo_enqueue(rx_buffer, &rx_head, &rx_tail, byte);
+        if (!cbfifo_enqueue(rx_buffer, &rx_head, &rx_tail, byte)) {
+            rx_overflows++;
+        }
+    }
+    // An overrun lost a byte in hardware; ORE also keeps the interrupt pending
+    if (USART2->ISR & USART_ISR_ORE) {
+        USART2->ICR = USART_ICR_ORECF;
+        rx_overflows++;
     }
 
     // Handle TXE interrupt (transmit buffer empty)
@@ -158,4 +564,35 @@ void USART2_IRQHandler(void) {
     }
 }
 
+/**
+ * @brief Handler for the "USART TEST" command.
+ *
+ * Runs the USART2 loopback self-test, prints the result for every baud
+ * rate and reports the highest error-free throughput.
+ *
+ * @param argc Number of arguments (not used in this handler).
+ * @param argv Arguments (not used in this handler).
+ * @param args Converted arguments (not used in this handler).
+ */
+static void usart_test_command(int argc, char *argv[], const ArgValue *args) {
+    USART_SelfTestResult results[16];
+    uint32_t best = 0;
+    int count;
+
+    printf("Running USART loopback self-test...\r\n");
+    response_send(); // The test takes over PA2 for several seconds
+    count = USART2_SelfTest(results, 16);
+
+    printf("\r\n");
+    for (int i = 0; i < count; i++) {
+        printf("%7lu baud: %s (%lu errors, %lu bytes/s)\r\n", (unsigned long)results[i].baud,
+               results[i].errors ? "FAIL" : "PASS", (unsigned long)results[i].errors,
+               (unsigned long)results[i].bytes_per_second);
+        if (results[i].errors == 0 && results[i].bytes_per_second > best) {
+            best = results[i].bytes_per_second;
+        }
+    }
+    printf("Max error-free throughput: %lu bytes/s\r\n", (unsigned long)best);
+}
 
+REGISTER_COMMAND(usart_test, "USART TEST", usart_test_command);
@@ -15,12 +15,33 @@
 
 #include <stdint.h>
 
+/**
+ * @brief Outcome of the loopback self-test at one baud rate.
+ */
+typedef struct {
+    uint32_t baud;             /**< Baud rate under test */
+    uint32_t errors;           /**< Mismatched, lost or flagged frames */
+    uint32_t bytes_per_second; /**< Payload throughput measured with timebase_us() */
+} USART_SelfTestResult;
+
 // Function Declarations
 void USART2_Init(void);
 int __io_putchar(int ch);
 int __io_getchar(void);
-int putchar(int ch);
-int getchar(void);
+int USART2_ReadByte(uint8_t *ch);
+int USART2_TxSpace(void);
+int USART2_Write(const uint8_t *data, int length);
+int USART2_WriteOrDrop(const uint8_t *data, int length);
+void USART2_WriteAll(const uint8_t *data, int length);
+void USART2_SetOutputHook(int (*hook)(int ch));
+int USART2_RxPending(void);
+int USART2_PrepareStop(void);
+int USART2_FinishStop(void);
+uint32_t USART2_RxOverflowCount(void);
+uint32_t USART2_TxOverflowCount(void);
+int USART2_SelfTest(USART_SelfTestResult *results, int max_results);
+int (putchar)(int ch);
+int (getchar)(void);
 void USART2_IRQHandler(void);
 
 #endif // USART_H